@@ -2,30 +2,75 @@
 #include <Adafruit_PWMServoDriver.h>
 #include "HX711.h"
 #include <SPI.h>
+#include "src/servo_motion.h"
+#include "src/finger_frame.h"
+#include "src/force_filter.h"
+#include "src/servo_pwm.h"
+#include "src/hand_telemetry.h"
 
 // ---- PCA9685 (servo driver) ----
-Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(0x40);
+#define PCA9685_ADDR 0x40
+Adafruit_PWMServoDriver pwm = Adafruit_PWMServoDriver(PCA9685_ADDR);
 
 // ---- HX711 (force sensor) ----
 #define HX711_DT  3
 #define HX711_SCK 2
 HX711 scale;
-float upper_threshold = 500000.0;   // adjust threshold as needed
-float lower_threshold = 0.0;
+long upper_threshold = 500000;   // adjust threshold as needed
+// Raw HX711 counts are signed and sit around the load cell's offset, so an
+// unloaded or reverse-loaded cell reads negative: halt only on a large pull
+// the other way, not on any value below zero
+long lower_threshold = -500000;
+// Sampled whenever DT goes low (data ready, ~10 Hz / 80 Hz), never waited for;
+// the median of the last FORCE_FILTER_SIZE samples decides the halt.
+ForceFilter force;
+bool forceHalt = false;
 
-// ---- SPI ----
-volatile byte spiBuffer[12];
+// ---- SPI (framed, see src/finger_frame.h) ----
+// Ping-pong buffers: the ISR fills rxBuf[rxWrite] while loop() reads the
+// completed frame in rxBuf[rxReady]; replies are staged in the idle txBuf and
+// swapped in by the ISR at a frame boundary, so neither side sees torn frames.
+volatile byte rxBuf[2][FINGER_FRAME_SIZE];
+volatile byte txBuf[2][FINGER_FRAME_SIZE];
+volatile byte rxWrite = 0;
+volatile byte rxReady = 0;
+volatile byte rxIndex = 0;
+volatile byte txActive = 0;
 volatile bool commandReceived = false;
+volatile bool txPending = false;
+volatile unsigned int rxOverruns = 0;  // frames dropped while loop() was busy
+unsigned int crcErrors = 0;
+byte lastSeq = 0;
+bool feedbackDirty = false;
 
 // ---- Servo channel ----
 #define PINKY_CHANNEL  15
 #define RING_CHANNEL  14
 #define MIDDLE_CHANNEL  13
 #define INDEX_CHANNEL  12 
+#define THUMB1_CHANNEL  11
+#define THUMB2_CHANNEL  10
+#define FIRST_CHANNEL  THUMB2_CHANNEL   // channels 10..15 are written in one burst
 int servoMin = 150;       // Calibrate your servo min pulse
 int servoMax = 600;       // Calibrate your servo max pulse
+// Channel of each DOF: Pinky, Ring, Middle, Index, Thumb DOF1, Thumb DOF2
+const byte servoChannel[SERVO_DOF] = {
+  PINKY_CHANNEL, RING_CHANNEL, MIDDLE_CHANNEL, INDEX_CHANNEL, THUMB1_CHANNEL, THUMB2_CHANNEL
+};
+ServoPwm servoPwm(servoMin, servoMax);
 float angleFinger[6];
-byte feedback[14];
+byte feedback[FINGER_FRAME_SIZE];
+
+// ---- Motion engine (non-blocking, millis() driven) ----
+#define SERVO_SLEW_DEG_PER_S 180.0  // adjust to the servo speed
+#define FEEDBACK_PERIOD_MS   100    // idle keep-alive
+ServoMotion motion(SERVO_SLEW_DEG_PER_S);
+unsigned long lastFeedbackMs = 0;
+
+// ---- Debug telemetry (binary, see src/hand_telemetry.h; decode with telemetry_dump) ----
+// Records are queued in a ring and trickled out as UART buffer space frees up,
+// so loop() never waits on Serial.
+TelemetryRing telemetry;
 
 // ---- Status codes ----
 byte status = 0x00; // 0x00 idle, 0x01 moving, 0x02 done, 0x12 halt
@@ -35,6 +80,8 @@ void setup() {
   Wire.begin();
   pwm.begin();
   pwm.setPWMFreq(50);   // 50 Hz for analog servos
+  Wire.setClock(400000); // fast-mode I2C for the servo bursts
+  enableAutoIncrement();
 
   // HX711 init
   scale.begin(HX711_DT, HX711_SCK);
@@ -43,89 +90,182 @@ void setup() {
   pinMode(MISO, OUTPUT);
   SPCR |= _BV(SPE);     // enable SPI
   SPI.attachInterrupt();
+  // Pin-change interrupt on SS (D10 = PB2 = PCINT2): the end of every
+  // transfer restarts the frame, whatever the byte count got to
+  PCMSK0 |= _BV(PCINT2);
+  PCIFR = _BV(PCIF0);
+  PCICR |= _BV(PCIE0);
 
-  Serial.println("=== Demo Hand Low Level Control Ready ===");
+  motion.begin(millis(), angleFinger);
+  sendTelemetry();
 }
 
 ISR(SPI_STC_vect) {
-  static int index = 0;
-  static int replyIndex = 1;
   byte c = SPDR;        // read received byte
-  spiBuffer[index++] = c;
-  if (index >= 14) {    // got full packet (6 DOFs × 2 bytes)
-    commandReceived = true;
-    index = 0;
+
+  // Wait for the sync nibble before starting a frame (resynchronises after noise)
+  if (rxIndex == 0 && (c & FINGER_SYNC_MASK) != FINGER_SYNC_COMMAND) {
+    SPDR = txBuf[txActive][0];
+    return;
   }
 
-  SPDR = feedback[replyIndex];      
-  replyIndex++;                     
-  if (replyIndex >= 14) {            
-    replyIndex = 0;
+  rxBuf[rxWrite][rxIndex++] = c;
+  if (rxIndex >= FINGER_FRAME_SIZE) {   // got full frame
+    rxIndex = 0;
+    if (!commandReceived) {
+      rxReady = rxWrite;
+      rxWrite ^= 1;
+      commandReceived = true;
+    } else {
+      rxOverruns++;
+    }
+    if (txPending) {     // next reply starts with the newest feedback
+      txActive ^= 1;
+      txPending = false;
+    }
+  }
+  SPDR = txBuf[txActive][rxIndex];
+}
+
+ISR(PCINT0_vect) {
+  // SS rising edge: the master ended the transfer, so a partial frame (lost or
+  // extra clock) is dropped and the next transfer starts at byte 0
+  if (PINB & _BV(PINB2)) {
+    rxIndex = 0;
+    SPDR = txBuf[txActive][0];
   }
 }
 
 void loop() {
   if (commandReceived) {
-    commandReceived = false;
-
-    // --- Parse Pinky, Ring, Middle, Index, Thumb DOF1, Thumb DOF2 DOF (bytes 0,1) ---
-    for (int i = 0; i < 12; i=i+2) { 
-      uint16_t raw = (uint16_t(spiBuffer[i+1]) << 8) | spiBuffer[i]; // LSB first
-      angleFinger[i/2] = raw * 0.01; // degrees
-      Serial.print(angleFinger[i/2]);
-      Serial.print(" ");
-    }
+    byte frame[FINGER_FRAME_SIZE];
+    for (int i = 0; i < FINGER_FRAME_SIZE; i++) frame[i] = rxBuf[rxReady][i];
+    commandReceived = false;   // ISR may reuse the buffer now
 
-    // --- Safety check from HX711 ---
-    long val = scale.read_average(5);
-    Serial.println(val);
-    if (val > upper_threshold && val < lower_threshold) // Adjust as need
-    {
-      status = 0x12; // Halt
-      Serial.println("Sensor triggered! HALT.");
-      sendFeedback();
+    byte seq;
+    uint16_t raw[FINGER_FRAME_DOF];
+    if (!fingerDecodeCommand(frame, &seq, raw)) {
+      crcErrors++;
+      sendTelemetry();
       return;
     }
+    // --- Parse Pinky, Ring, Middle, Index, Thumb DOF1, Thumb DOF2 DOF ---
+    // (a held DOF keeps its current target, e.g. where a halt stopped it)
+    for (int i = 0; i < FINGER_FRAME_DOF; i++) {
+      angleFinger[i] = raw[i] == FINGER_ANGLE_HOLD ? motion.target(i) : raw[i] * 0.01; // degrees
+    }
 
-    // --- Move servo ---
-    status = 0x01; // Moving
-    sendFeedback();
+    // --- New target: servos slew toward it from wherever they are ---
+    // Acknowledged only once applied: during a halt the reply keeps the last
+    // accepted sequence, and the halt status tells the host why
+    if (!forceHalt) {
+      motion.setTarget(angleFinger);
+      lastSeq = seq;
+    }
+    sendTelemetry();
+  }
 
-    int pwmVal_pinky = map((int)angleFinger[0], 0, 180, servoMin, servoMax);
-    int pwmVal_ring = map((int)angleFinger[1], 0, 180, servoMin, servoMax);
-    int pwmVal_middle = map((int)angleFinger[2], 0, 180, servoMin, servoMax);
-    int pwmVal_index = map((int)angleFinger[3], 0, 180, servoMin, servoMax);
-    pwm.setPWM(PINKY_CHANNEL, 0, pwmVal_pinky);
-    pwm.setPWM(RING_CHANNEL, 0, pwmVal_ring);
-    pwm.setPWM(MIDDLE_CHANNEL, 0, pwmVal_middle);
-    pwm.setPWM(INDEX_CHANNEL, 0, pwmVal_index);
+  // --- Safety check from HX711, every iteration ---
+  sampleForce();
 
-    delay(1000);   // simulate move time
+  // --- Advance the motion, refresh the PWM outputs and the reported angles ---
+  if (motion.update(millis())) {
+    writeServos();
+    updateFeedback();
+  }
 
-    status = 0x02; // Done
-    sendFeedback();
-  } else {
-    // --- Keep-alive when idle ---
-    status = 0x00;
+  // --- Report status from actual progress: on change, else as keep-alive ---
+  byte newStatus = motion.status();
+  if (newStatus != status || millis() - lastFeedbackMs >= FEEDBACK_PERIOD_MS) {
+    status = newStatus;
     sendFeedback();
-    delay(100);
+    lastFeedbackMs = millis();
   }
+  publishFeedback();
+  flushTelemetry();
+}
+
+void sampleForce() {
+  // DT low means a conversion is waiting; reading it only shifts 24 bits out
+  if (!scale.is_ready()) return;
+  force.push(scale.read());
+
+  bool out = force.outOfRange(lower_threshold, upper_threshold); // Adjust as need
+  if (out && !forceHalt) {
+    motion.halt();
+  }
+  forceHalt = out;
+}
+
+void enableAutoIncrement() {
+  // The burst in writeServos() relies on MODE1.AI
+  Wire.beginTransmission(PCA9685_ADDR);
+  Wire.write(PCA9685_MODE1);
+  Wire.endTransmission();
+  Wire.requestFrom(PCA9685_ADDR, 1);
+  byte mode1 = Wire.available() ? Wire.read() : 0;
+  Wire.beginTransmission(PCA9685_ADDR);
+  Wire.write(PCA9685_MODE1);
+  Wire.write(mode1 | PCA9685_MODE1_AI);
+  Wire.endTransmission();
+}
+
+void writeServos() {
+  // All six DOFs in one I2C transaction (25 bytes, fits the 32-byte Wire buffer)
+  uint16_t ticks[SERVO_DOF];
+  for (int i = 0; i < SERVO_DOF; i++) {
+    ticks[servoChannel[i] - FIRST_CHANNEL] = servoPwm.ticks(motion.position(i));
+  }
+  byte burst[SERVO_PWM_BURST_SIZE(SERVO_DOF)];
+  byte len = servoPwmPack(FIRST_CHANNEL, ticks, SERVO_DOF, burst);
+  Wire.beginTransmission(PCA9685_ADDR);
+  Wire.write(burst, len);
+  Wire.endTransmission();
+}
+
+void updateFeedback() {
+  // Acknowledge the last accepted command and report where the servos are now
+  uint16_t raw[FINGER_FRAME_DOF];
+  for (int i = 0; i < FINGER_FRAME_DOF; i++) raw[i] = (uint16_t)(motion.position(i) * 100.0 + 0.5);
+  fingerEncodeReply(lastSeq, raw, status, feedback);
+  feedbackDirty = true;
+  publishFeedback();
 }
 
 void sendFeedback() {
-  // Echo 12 bytes
-  for (int i = 0; i < 12; i++) feedback[i] = spiBuffer[i];
-  feedback[12] = 0x00;   // backup
-  feedback[13] = status; // status
-
-  // Print feedback
-  Serial.print("Feedback: ");
-  for (int i = 0; i < 14; i++) {
-    Serial.print("0x");
-    if (feedback[i] < 16) Serial.print("0");
-    Serial.print(feedback[i], HEX);
-    Serial.print(" ");
+  updateFeedback();
+  sendTelemetry();
+}
+
+void sendTelemetry() {
+  HandTelemetry t;
+  t.timeMs = millis();
+  t.seq = lastSeq;
+  t.status = status;
+  for (int i = 0; i < SERVO_DOF; i++) {
+    t.pos[i] = (uint16_t)(motion.position(i) * 100.0 + 0.5);
+    t.target[i] = (uint16_t)(motion.target(i) * 100.0 + 0.5);
   }
-  Serial.println();
+  t.force = force.median();
+  t.crcErrors = crcErrors;
+  t.rxOverruns = rxOverruns;
+
+  byte wire[HAND_TELEMETRY_WIRE_SIZE];
+  telemetry.push(wire, telemetryEncode(&t, wire));  // dropped if the ring is full
+}
+
+void flushTelemetry() {
+  // Only as many bytes as the UART buffer takes without blocking
+  int room = Serial.availableForWrite();
+  while (room-- > 0 && telemetry.available()) Serial.write(telemetry.pop());
+}
+
+void publishFeedback() {
+  // Stage into the idle TX buffer; wait while the ISR has a swap pending
+  if (!feedbackDirty || txPending) return;
+  byte next = txActive ^ 1;
+  for (int i = 0; i < FINGER_FRAME_SIZE; i++) txBuf[next][i] = feedback[i];
+  txPending = true;
+  feedbackDirty = false;
 }
 
@@ -1,6 +1,8 @@
 #include <SPI.h>
+#include "src/finger_frame.h"
 
 const uint8_t SS_SLAVE = 10; // this drives the Nano's SS (D10)
+uint8_t seq = 0;             // 4-bit command sequence, acknowledged in the reply
 
 void setup() {
   Serial.begin(115200);
@@ -18,17 +20,28 @@ void setup() {
 }
 
 void receivePacket12(const uint8_t *pkt) {
+  uint8_t reply[FINGER_FRAME_SIZE];
   digitalWrite(SS_SLAVE, LOW);  // select slave
 
   Serial.print("Slave responded: ");
-  for (int i = 0; i < 14; i++) {
-    uint8_t response = SPI.transfer(pkt[i]); 
-    Serial.print(response, HEX);
+  for (int i = 0; i < FINGER_FRAME_SIZE; i++) {
+    reply[i] = SPI.transfer(pkt[i]);
+    Serial.print(reply[i], HEX);
     Serial.print(" ");
   }
   Serial.println();
 
   digitalWrite(SS_SLAVE, HIGH);
+
+  // Reply belongs to the previous packet: acknowledged sequence and status
+  uint8_t ackSeq, status;
+  uint16_t raw[FINGER_FRAME_DOF];
+  if (fingerDecodeReply(reply, &ackSeq, raw, &status)) {
+    Serial.print("Ack seq ");
+    Serial.print(ackSeq);
+    Serial.print(" status 0x");
+    Serial.println(status, HEX);
+  }
 }
 
 void loop() {
@@ -37,15 +50,12 @@ void loop() {
   uint16_t ring_raw = 4500;
   uint16_t middle_raw = 4500;
   uint16_t index_raw = 4500;
-  uint8_t pkt[14] = {
-    (uint8_t)(pinky_raw & 0xFF), (uint8_t)(pinky_raw >> 8),
-    (uint8_t)(ring_raw & 0xFF), (uint8_t)(ring_raw >> 8), 
-    (uint8_t)(middle_raw & 0xFF), (uint8_t)(middle_raw >> 8), 
-    (uint8_t)(index_raw & 0xFF), (uint8_t)(index_raw >> 8), 
-    0,0, 0,0, 0,0
-  };
+  uint16_t raw[FINGER_FRAME_DOF] = {pinky_raw, ring_raw, middle_raw, index_raw, 0, 0};
+  uint8_t pkt[FINGER_FRAME_SIZE];
+  seq = (seq + 1) & FINGER_SEQ_MASK;
+  fingerEncodeCommand(seq, raw, pkt);   // sync + seq, LSB-first angles, CRC-8
 
   receivePacket12(pkt);
-  Serial.println("Receive 14-byte packet.");
+  Serial.println("Receive 15-byte packet.");
   delay(300);
 }
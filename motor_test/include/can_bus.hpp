@@ -4,24 +4,122 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include "can_transport.hpp"
 
-class CANBus {
+class CanUring;
+
+/**
+ * @brief How CANBus talks to the socket.
+ *   Socket   one send()/recvmsg() per frame
+ *   IoUring  frames batched through an io_uring: received frames are read
+ *            from shared memory, TX frames of a batch go out in one syscall
+ *            (Linux 6.0+, falls back to Socket)
+ */
+enum class CANBackend { Socket, IoUring };
+
+/**
+ * @brief Backend named by the CAN_BACKEND environment variable
+ * ("io_uring" or "socket"); Socket when unset.
+ */
+CANBackend can_backend_from_env();
+
+const char *can_backend_name(CANBackend backend);
+
+/**
+ * @brief SocketCAN transport.
+ */
+class CANBus : public CanTransport {
 private:
     int socket_fd = -1;
+    // Counted from the TX and RX threads alike
+    std::atomic<uint64_t> syscalls{0};
+    bool receive_local = true;
+
+    // IoUring backend; tx_mutex guards it (receive included)
+    std::unique_ptr<CanUring> uring;
+    bool batching = false;
+
+    // TX scheduler; only touched once a write has failed
+    static constexpr size_t TX_QUEUE_CAPACITY = 64;
+    struct TxFrame {
+        uint32_t id;
+        uint8_t len;
+        uint8_t data[8];
+    };
+    struct TxQueue {
+        TxFrame frames[TX_QUEUE_CAPACITY];
+        size_t head = 0;
+        size_t size = 0;
+        TxFrame &at(size_t k) { return frames[(head + k) % TX_QUEUE_CAPACITY]; }
+    };
+    TxQueue tx_queues[TX_CLASSES];
+    // Changed under tx_mutex; read without it only to skip an empty flush
+    std::atomic<size_t> tx_pending{0};
+    std::mutex tx_mutex;
+    TxStats tx_stats;
+
+    enum class WriteResult { Sent, Busy, Failed };
+    WriteResult write_frame(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls, bool retry = false);
+    bool enqueue_locked(TxClass cls, uint32_t id, const uint8_t *data, uint8_t len, bool count = true);
+    size_t flush_locked();
+    // io_uring: accounts for finished writes and queues the failed ones again
+    void reap_locked();
+    void submit_locked();
+    bool uring_receive_locked(uint32_t &id, uint8_t *data, uint8_t &len, bool all);
+    void open_backend(CANBackend backend);
 
 public:
     /**
      * @brief Initializes the CAN socket for a given interface (e.g., "can0").
      */
-    CANBus(const std::string &interface);
+    CANBus(const std::string &interface, CANBackend backend = CANBackend::Socket);
 
     /**
-     * @brief Sends a CAN message.
-     * @param id The arbitration ID.
-     * @param data The 8-byte payload.
-     * @return True on success.
+     * @brief Takes over an open datagram socket that carries struct can_frame,
+     * e.g. one end of a socketpair in tests.
+     */
+    explicit CANBus(int fd, CANBackend backend = CANBackend::Socket);
+    ~CANBus();
+
+    CANBackend get_backend() const { return uring ? CANBackend::IoUring : CANBackend::Socket; }
+
+    using CanTransport::send_msg;
+
+    /**
+     * @brief Sends a CAN message from a raw buffer (no allocation). Written
+     * directly unless the kernel queue is full or frames of the same or higher
+     * priority are still waiting; then it is queued. Waiting frames of lower
+     * priority follow it.
+     * @param len Payload length, at most 8.
+     * @return True if written or queued, false if the class queue is full or
+     * the socket failed.
+     */
+    bool send_msg(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls = TxClass::Setpoint) override;
+
+    /**
+     * @brief Holds back Setpoint and Poll frames until the next flush(), so a
+     * control tick's frames reach the kernel in one syscall (io_uring backend;
+     * no effect on the socket backend, which writes every frame at once).
+     * Safety frames are never held.
+     */
+    void begin_batch() override;
+
+    /**
+     * @brief Writes queued frames in priority order, waiting up to `wait` for
+     * the socket to become writable, and ends a batch. Also done (without
+     * waiting) by every send_msg() and poll_msg().
+     * @return Number of frames still queued (io_uring: or not yet written).
      */
-    bool send_msg(uint32_t id, const std::vector<uint8_t> &data);
+    size_t flush(std::chrono::microseconds wait = std::chrono::microseconds(0)) override;
+
+    size_t get_tx_pending() const { return tx_pending.load(std::memory_order_relaxed); }
+    size_t get_tx_pending(TxClass cls) override;
+    TxStats get_tx_stats() override;
 
     /**
      * @brief Reads a CAN message (blocking).
@@ -29,16 +127,43 @@ public:
      * @param data Reference to store the received payload.
      * @return True on success.
      */
-    bool read_msg(uint32_t &id, std::vector<uint8_t> &data);
+    bool read_msg(uint32_t &id, std::vector<uint8_t> &data) override;
+
+    /**
+     * @brief Reads a pending CAN message without blocking or allocating.
+     * @param data Buffer of at least 8 bytes.
+     * @param len Reference to store the payload length.
+     * @return True if a message was read, false if none is pending.
+     */
+    bool poll_msg(uint32_t &id, uint8_t *data, uint8_t &len) override;
+
+    /**
+     * @brief Controls whether frames sent by other sockets on this host reach
+     * this one (CAN_RAW_LOOPBACK on the sending side; on by default).
+     */
+    bool set_loopback(bool enable);
+
+    /**
+     * @brief When false, poll_msg() drops frames sent from this host (by other
+     * sockets), keeping only frames from the wire. On vcan every frame is local.
+     */
+    void set_receive_local(bool enable) { receive_local = enable; }
+
+    /**
+     * @brief Socket descriptor, for poll()/epoll; -1 if the bus failed to open.
+     */
+    int get_fd() const { return socket_fd; }
 
     /**
      * @brief Closes the CAN socket.
      */
-    void shutdown();
+    void shutdown() override;
 
-    // Prevent copy/move
-    CANBus(const CANBus&) = delete;
-    CANBus& operator=(const CANBus&) = delete;
+    /**
+     * @brief Socket / io_uring syscalls made on the data path (send, receive,
+     * flush waits), to compare the backends' cost per control tick.
+     */
+    uint64_t get_syscall_count() const override;
 };
 
 #endif // CAN_BUS_HPP
\ No newline at end of file
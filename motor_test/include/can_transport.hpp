@@ -0,0 +1,124 @@
+#ifndef CAN_TRANSPORT_HPP
+#define CAN_TRANSPORT_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include "metrics.hpp"
+
+/**
+ * @brief Transmit priority of a frame. Frames the kernel cannot take right
+ * away (TX queue full: ENOBUFS) wait in a bounded queue per class, and the
+ * queues drain in class order, so stops overtake pending setpoints and polls.
+ */
+enum class TxClass : uint8_t {
+    Safety = 0,    // stop / enable
+    Setpoint = 1,  // commands; a newer one for the same ID replaces a queued one
+    Poll = 2,      // read requests
+};
+constexpr size_t TX_CLASSES = 3;
+
+struct TxStats {
+    uint64_t queued[TX_CLASSES] = {};   // frames that had to wait
+    uint64_t retried[TX_CLASSES] = {};  // waiting frames written later
+    uint64_t dropped[TX_CLASSES] = {};  // rejected (queue full) or failed for good
+    uint64_t superseded = 0;            // queued setpoints replaced by a newer one
+};
+
+/**
+ * @brief What the motor drivers, streams and control loops need from a CAN
+ * bus. Implementations:
+ *   CANBus       SocketCAN (can_bus.hpp)
+ *   LoopbackBus  in-process, frames go straight to simulated motors (loopback_bus.hpp)
+ *   ReplayBus    plays back a candump log (replay_bus.hpp)
+ * The in-process ones run on a virtual clock that only moves when told to,
+ * so a simulation is deterministic and as fast as the code under test.
+ */
+class CanTransport {
+public:
+    virtual ~CanTransport() = default;
+
+    /**
+     * @brief Sends a CAN message.
+     * @return True if written or queued for retry.
+     */
+    bool send_msg(uint32_t id, const std::vector<uint8_t> &data, TxClass cls = TxClass::Setpoint) {
+        return send_msg(id, data.data(), (uint8_t)data.size(), cls);
+    }
+
+    /**
+     * @brief Sends a CAN message from a raw buffer (no allocation).
+     * @param len Payload length, at most 8.
+     * @return True if written or queued, false if it was dropped.
+     */
+    virtual bool send_msg(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls = TxClass::Setpoint) = 0;
+
+    /**
+     * @brief Reads a CAN message, waiting for one.
+     * @return True on success.
+     */
+    virtual bool read_msg(uint32_t &id, std::vector<uint8_t> &data) = 0;
+
+    /**
+     * @brief Reads a pending CAN message without blocking or allocating.
+     * @param data Buffer of at least 8 bytes.
+     * @return True if a message was read, false if none is pending.
+     */
+    virtual bool poll_msg(uint32_t &id, uint8_t *data, uint8_t &len) = 0;
+
+    /**
+     * @brief Opens a batch: frames until flush() may go out together.
+     */
+    virtual void begin_batch() {}
+
+    /**
+     * @brief Writes queued frames and ends a batch.
+     * @return Number of frames still queued.
+     */
+    virtual size_t flush(std::chrono::microseconds wait = std::chrono::microseconds(0)) {
+        (void)wait;
+        return 0;
+    }
+
+    virtual size_t get_tx_pending(TxClass cls) { (void)cls; return 0; }
+    virtual TxStats get_tx_stats() { return TxStats(); }
+
+    /**
+     * @brief Syscalls made on the data path (0 for the in-process transports).
+     */
+    virtual uint64_t get_syscall_count() const { return 0; }
+
+    /**
+     * @brief Time base of the bus: the virtual clock of the in-process
+     * transports, steady_clock on a real bus.
+     */
+    virtual std::chrono::microseconds now() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+    }
+
+    virtual void shutdown() {}
+
+    /**
+     * @brief Frame counters since the bus was opened.
+     * Used to compare bus traffic per control tick between feedback modes.
+     */
+    uint64_t get_tx_count() const { return metrics.tx_frames.get(); }
+    uint64_t get_rx_count() const { return metrics.rx_frames.get(); }
+
+    /**
+     * @brief Live counters of this bus (MetricsExporter).
+     */
+    const BusMetrics &get_metrics() const { return metrics; }
+
+    // Prevent copy/move
+    CanTransport(const CanTransport&) = delete;
+    CanTransport& operator=(const CanTransport&) = delete;
+
+protected:
+    CanTransport() = default;
+    BusMetrics metrics;
+};
+
+#endif // CAN_TRANSPORT_HPP
@@ -0,0 +1,148 @@
+#ifndef CAN_URING_HPP
+#define CAN_URING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <linux/can.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+/**
+ * @brief io_uring engine behind CANBus's IoUring backend (used only through
+ * CANBus, under its lock).
+ *
+ * The socket is a registered file. Receive is one multishot RECVMSG into a
+ * ring of provided buffers, so received frames appear in the completion queue
+ * without any syscall; they are copied out by next_rx() and the buffer goes
+ * straight back to the ring. Transmit frames are staged in registered slots
+ * (WRITE_FIXED, RWF_NOWAIT) and all staged frames go to the kernel with one
+ * io_uring_enter() in submit(). A write the kernel could not take (ENOBUFS,
+ * EAGAIN) completes with an error and is handed back by pop_failed().
+ *
+ * Needs Linux 6.0 (multishot recvmsg, probed in the constructor); is_open()
+ * is false on older kernels.
+ */
+class CanUring {
+public:
+    static constexpr unsigned RX_BUFFERS = 256;  // power of two
+    static constexpr unsigned TX_SLOTS = 64;
+    static constexpr size_t TAGS = 4;            // caller's frame classes
+
+    explicit CanUring(int socket_fd);
+    ~CanUring();
+
+    bool is_open() const { return ring_fd >= 0; }
+
+    /**
+     * @brief Copies a frame into a free TX slot; it goes out with the next submit().
+     * @param tag Caller's class, returned with a failed frame (< TAGS).
+     * @param retry Caller's mark, returned with a failed frame.
+     * @return False if all slots are in flight.
+     */
+    bool stage_tx(const can_frame &frame, uint8_t tag, bool retry = false);
+
+    /**
+     * @brief Hands every staged entry to the kernel (one syscall, none if
+     * nothing is staged) and optionally waits for `wait_nr` completions.
+     */
+    int submit(unsigned wait_nr = 0);
+
+    /**
+     * @brief Blocks until a completion is posted (for blocking reads).
+     */
+    void wait();
+
+    /**
+     * @brief Reaps completions until a received frame is found. TX results
+     * met on the way are accounted for. No syscall unless the receive has to
+     * be (re)armed or the completion queue overflowed.
+     * @param msg_flags recvmsg() flags of the frame (MSG_DONTROUTE for local frames).
+     * @return True if a frame was copied out.
+     */
+    bool next_rx(can_frame &frame, int &msg_flags);
+
+    /**
+     * @brief Reaps TX completions up to the first received frame.
+     */
+    void reap_tx();
+
+    /**
+     * @brief Next frame whose write failed, with its tag, retry mark and errno.
+     */
+    bool pop_failed(can_frame &frame, uint8_t &tag, bool &retry, int &err);
+
+    size_t staged() const { return sq_local_tail - sq_submitted; }
+    size_t in_flight() const { return TX_SLOTS - free_count; }
+    size_t in_flight(uint8_t tag) const { return tag < TAGS ? tag_in_flight[tag] : 0; }
+
+    // Frames written since the last call
+    uint64_t take_tx_done() { uint64_t n = tx_done; tx_done = 0; return n; }
+    uint64_t get_enter_count() const { return enters.load(std::memory_order_relaxed); }
+
+    // Prevent copy/move
+    CanUring(const CanUring&) = delete;
+    CanUring& operator=(const CanUring&) = delete;
+
+private:
+    static constexpr unsigned SQ_ENTRIES = 128;
+    static constexpr unsigned CQ_ENTRIES = 1024;
+    static constexpr size_t RX_BUFFER_SIZE = 64; // recvmsg_out header + one frame
+
+    int ring_fd = -1;
+    void *sq_ring = nullptr;
+    void *cq_ring = nullptr;
+    size_t sq_ring_size = 0;
+    size_t cq_ring_size = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqes_size = 0;
+    unsigned *sq_head = nullptr, *sq_tail = nullptr, *sq_flags = nullptr, *sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned *cq_head = nullptr, *cq_tail = nullptr;
+    io_uring_cqe *cqes = nullptr;
+    unsigned cq_mask = 0;
+    unsigned sq_local_tail = 0;
+    unsigned sq_submitted = 0;
+    std::atomic<uint64_t> enters{0};
+
+    // Provided receive buffers
+    io_uring_buf_ring *buf_ring = nullptr;
+    size_t buf_ring_size = 0;
+    uint16_t buf_tail = 0;
+    alignas(64) uint8_t rx_buffers[RX_BUFFERS][RX_BUFFER_SIZE];
+    struct msghdr rx_msg {};
+    bool rx_armed = false;
+
+    // Registered TX slots
+    alignas(64) can_frame tx_slots[TX_SLOTS];
+    uint8_t tx_tag[TX_SLOTS] = {};
+    bool tx_retry[TX_SLOTS] = {};
+    uint16_t free_slots[TX_SLOTS];
+    size_t free_count = 0;
+    size_t tag_in_flight[TAGS] = {};
+    uint64_t tx_done = 0;
+
+    struct Failed {
+        can_frame frame;
+        uint8_t tag;
+        bool retry;
+        int err;
+    };
+    Failed failed[TX_SLOTS];
+    size_t failed_head = 0;
+    size_t failed_count = 0;
+
+    bool setup(int socket_fd);
+    bool probe_rx();
+    void teardown();
+    io_uring_sqe *get_sqe();
+    void arm_rx();
+    void recycle(uint16_t bid);
+    void complete_tx(const io_uring_cqe &cqe);
+    void check_overflow();
+};
+
+#endif // CAN_URING_HPP
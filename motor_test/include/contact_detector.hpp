@@ -0,0 +1,75 @@
+#ifndef CONTACT_DETECTOR_HPP
+#define CONTACT_DETECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Streaming contact detector on motor current, one channel per joint.
+ * Keeps a sliding-window mean/variance and the sample-to-sample derivative of
+ * |current| for every joint. All joints are sampled together; each sample
+ * costs O(1) per joint and a joint's window sums are recomputed once per wrap
+ * so float drift cannot accumulate. Joint data is stored structure-of-arrays
+ * so update() is a branch-free loop across joints.
+ *
+ * A joint latches "in contact" when |current| rises more than
+ * max(k_sigma * stddev, min_step) above the window mean, or its derivative
+ * exceeds max_slope. Accelerating a joint takes current like a push does, so
+ * after construction and reset() a joint ignores samples for settle_s (the
+ * drive's acceleration time) and then builds a fresh baseline from live
+ * samples; detection starts at the second one. Samples of joints the caller
+ * disarms (e.g. while braking into the target) are ignored the same way, and
+ * the baseline stops updating while in contact.
+ */
+class ContactDetector {
+public:
+    static constexpr size_t MAX_JOINTS = 16;
+    static constexpr size_t MAX_WINDOW = 64;
+
+    ContactDetector(size_t joints, size_t window = 16, float k_sigma = 4.0f,
+                    float min_step = 0.3f, float max_slope = 50.0f, float settle_s = 0.15f);
+
+    /**
+     * @brief Feeds one current sample (A) per joint.
+     * @param dt Time since the previous sample in seconds.
+     * @param armed Bit mask of joints whose sample counts; the others are ignored.
+     * @return Bit mask of joints that entered contact on this sample.
+     */
+    uint32_t update(const float *current, float dt, uint32_t armed = ~0u);
+
+    /**
+     * @brief Clears the latch and the baseline; the joint re-arms after the settle time.
+     */
+    void reset(size_t joint);
+
+    bool in_contact(size_t joint) const { return contact[joint] != 0; }
+    float get_mean(size_t joint) const;
+    float get_stddev(size_t joint) const;
+    float get_slope(size_t joint) const { return slope[joint]; }
+    size_t size() const { return joints; }
+    float get_settle() const { return settle_s; }
+
+private:
+    size_t joints;
+    size_t window;
+    float k_sigma;
+    float min_step;
+    float max_slope;
+    float settle_s;
+
+    // ring[k][j]: baseline sample k of joint j; each joint fills its own column
+    float ring[MAX_WINDOW][MAX_JOINTS] = {};
+    float sum[MAX_JOINTS] = {};
+    float sum_sq[MAX_JOINTS] = {};
+    float prev[MAX_JOINTS] = {};
+    float slope[MAX_JOINTS] = {};
+    float settle[MAX_JOINTS] = {};  // hold-off left after reset(), seconds
+    uint8_t contact[MAX_JOINTS] = {};
+    uint8_t entered[MAX_JOINTS] = {};
+    uint32_t head[MAX_JOINTS] = {};
+    uint32_t filled[MAX_JOINTS] = {};
+
+    void recompute(size_t joint);
+};
+
+#endif // CONTACT_DETECTOR_HPP
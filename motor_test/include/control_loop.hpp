@@ -0,0 +1,137 @@
+#ifndef CONTROL_LOOP_HPP
+#define CONTROL_LOOP_HPP
+
+#include "can_transport.hpp"
+#include "motor_control.hpp"
+#include "joint_controller.hpp"
+#include "joint_estimator.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * @brief Host-side closed-loop control of a group of joints, ticked from a
+ * PeriodicLoop. Position and velocity come from a JointEstimator fed with
+ * every decoded reply; the output is streamed through the motors' current or
+ * speed encoders without waiting for replies. Drives whose command replies
+ * carry no angle (LKtech) get a position read after every command.
+ *
+ *   PositionToCurrent   position law -> amps (PID or impedance), every tick
+ *   PositionToVelocity  position law -> dps, drive speed loop underneath
+ *   Cascade             position law -> dps every outer_divider ticks,
+ *                       velocity law -> amps every tick
+ *
+ * References and gains may be changed from any thread while the loop runs;
+ * tick() and compute() do not lock or allocate.
+ */
+class ControlLoop {
+public:
+    static constexpr size_t MAX_MOTORS = JointController::MAX_JOINTS;
+
+    enum class Mode { PositionToCurrent, PositionToVelocity, Cascade };
+
+    struct Reference {
+        float pos = NAN;   // deg; NaN holds the joint where it is
+        float vel = 0.0f;  // dps, feedforward
+        float acc = 0.0f;  // dps^2, feedforward
+    };
+
+    ControlLoop(CanTransport *bus, Mode mode, unsigned outer_divider = 1);
+
+    /**
+     * @brief Adds a motor to the group (setup phase, before the loop starts).
+     * @return Index of the motor in the group, or -1 if full / unsupported.
+     */
+    int add_motor(MotorControl *motor);
+
+    /**
+     * @brief Outer loop: position error (deg) to amps, or to dps in the other modes.
+     */
+    JointController &position_law() { return position; }
+
+    /**
+     * @brief Inner loop of the cascade: velocity error (dps) to amps.
+     */
+    JointController &velocity_law() { return velocity; }
+
+    JointEstimator &get_estimator() { return estimator; }
+
+    /**
+     * @brief Publishes a new reference (thread-safe, latest wins).
+     */
+    void set_reference(size_t index, float pos_deg, float vel_dps = 0.0f, float acc_dps2 = 0.0f);
+
+    /**
+     * @brief Feeds one position sample received at t (seconds, steady clock).
+     */
+    void feed(size_t index, float pos_deg, double t);
+
+    /**
+     * @brief Runs the control laws at time t; out gets amps or dps for each of
+     * the size() joints.
+     * Outer-loop outputs are held between outer ticks.
+     */
+    void compute(double t, float dt, float *out);
+
+    /**
+     * @brief Decodes replies received since the last tick, computes and sends
+     * one command frame per motor. The time from a command to its reply is
+     * fed to the estimator as the bus round trip.
+     * @return Number of frames sent.
+     */
+    size_t tick();
+
+    /**
+     * @brief tick() at time t (s) after a tick period dt, for a loop on a
+     * virtual clock (LoopbackBus).
+     */
+    size_t tick(double t, float dt);
+
+    /**
+     * @brief Sends zero current / zero speed to all motors and resets the laws.
+     */
+    void stop();
+
+    float get_command(size_t index) const { return command[index]; }
+    float get_outer_command(size_t index) const { return outer_out[index]; }
+    size_t size() const { return count; }
+    Mode get_mode() const { return mode; }
+
+    // Prevent copy/move
+    ControlLoop(const ControlLoop&) = delete;
+    ControlLoop& operator=(const ControlLoop&) = delete;
+
+private:
+    CanTransport *bus;
+    Mode mode;
+    unsigned outer_divider;
+    unsigned outer_phase = 0;
+
+    std::array<MotorControl *, MAX_MOTORS> motors{};
+    size_t count = 0;
+
+    JointController position{MAX_MOTORS};
+    JointController velocity{MAX_MOTORS};
+    JointEstimator estimator{MAX_MOTORS};
+
+    std::mutex reference_write_mutex; // serializes writers only
+    std::array<SeqlockValue<Reference>, MAX_MOTORS> references;
+    std::array<uint32_t, MAX_MOTORS> reference_version{};
+    std::array<Reference, MAX_MOTORS> active{};
+
+    // Per-tick scratch, fixed size (the laws run over all MAX_MOTORS slots)
+    std::array<float, MAX_MOTORS> ref_pos{}, ref_vel{}, ref_acc{};
+    std::array<float, MAX_MOTORS> est_pos{}, est_vel{};
+    std::array<float, MAX_MOTORS> outer_out{}, inner_ref{}, inner_out{}, command{};
+
+    // Round trip: tick time of the last command, commands not yet answered
+    std::array<double, MAX_MOTORS> sent_at{};
+    std::array<uint8_t, MAX_MOTORS> unanswered{};
+
+    bool started = false;
+    std::chrono::steady_clock::time_point epoch;
+    std::chrono::steady_clock::time_point last_tick;
+};
+
+#endif // CONTROL_LOOP_HPP
@@ -0,0 +1,58 @@
+#ifndef CURRENT_STREAM_HPP
+#define CURRENT_STREAM_HPP
+
+#include "can_transport.hpp"
+#include "motor_control.hpp"
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Streams per-tick current (torque) targets to a group of motors.
+ * Storage is fixed-size and tick() neither allocates nor waits for replies,
+ * so it can be called from a 500 Hz - 1 kHz real-time loop.
+ */
+class CurrentStream {
+public:
+    static constexpr size_t MAX_MOTORS = 16;
+
+    explicit CurrentStream(CanTransport *bus);
+
+    /**
+     * @brief Adds a motor to the group (setup phase, before streaming).
+     * @return Index of the motor in the group, or -1 if full / unsupported.
+     */
+    int add_motor(MotorControl *motor);
+
+    /**
+     * @brief Sets the current target in amps for the next tick.
+     */
+    void set_target(size_t index, float amps);
+    void set_targets(const float *amps, size_t n);
+
+    /**
+     * @brief Decodes replies received since the last tick, then sends one
+     * current frame per motor.
+     * @return Number of frames sent.
+     */
+    size_t tick();
+
+    /**
+     * @brief Zeroes all targets and sends them immediately.
+     */
+    void stop();
+
+    size_t size() const { return count; }
+    const RMDFeedback &get_state(size_t index) const { return motors[index]->get_state(); }
+
+    // Prevent copy/move
+    CurrentStream(const CurrentStream&) = delete;
+    CurrentStream& operator=(const CurrentStream&) = delete;
+
+private:
+    CanTransport *bus;
+    std::array<MotorControl *, MAX_MOTORS> motors{};
+    std::array<float, MAX_MOTORS> targets{};
+    size_t count = 0;
+};
+
+#endif // CURRENT_STREAM_HPP
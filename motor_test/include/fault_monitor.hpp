@@ -0,0 +1,141 @@
+#ifndef FAULT_MONITOR_HPP
+#define FAULT_MONITOR_HPP
+
+#include "can_bus.hpp"
+#include "motor_control.hpp"
+#include "motor_discovery.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+struct FaultConfig {
+    // A motor that has not answered for this long is lost
+    std::chrono::milliseconds feedback_timeout{100};
+    // Status read sent to a motor silent for this long (0 = never); keeps idle
+    // motors answering so their age stays meaningful
+    std::chrono::milliseconds heartbeat{25};
+    // Status read sent to every RMD/LKtech motor this often even while it
+    // answers (0 = never): only its reply carries their error flags
+    std::chrono::milliseconds error_poll{100};
+    float max_temp_c = 75.0f;
+    // Longest wait between checks when no frame arrives
+    std::chrono::microseconds period{1000};
+    // Budget from the fault (or signal) to the last stop frame on the bus
+    std::chrono::microseconds stop_deadline{5000};
+    // Count frames sent by other programs on this host as replies. Needed on
+    // vcan, where the simulator is local too; on a real bus the application's
+    // own command frames would otherwise look like replies.
+    bool accept_local_frames = false;
+    // Catch SIGINT/SIGTERM, stop the motors, then terminate with the signal
+    bool handle_signals = true;
+};
+
+enum class Fault : uint8_t { None, FeedbackLost, DriveError, OverTemperature, Signal, Requested };
+
+struct FaultReport {
+    Fault fault = Fault::None;
+    int motor = -1;          // index of the motor, -1 for signals / requests
+    int code = 0;            // drive error code or signal number
+    float value = NAN;       // temperature, or feedback age in ms
+    // Fault onset -> detection -> last stop frame written
+    std::chrono::microseconds detect_latency{0};
+    std::chrono::microseconds stop_latency{0};
+    size_t stops_sent = 0;
+    bool deadline_met = false;
+};
+
+/**
+ * @brief Supervisory thread: watches every motor's feedback age, drive error
+ * code and temperature on its own CAN socket (independent of whoever drives
+ * the motors) and on a fault or SIGINT/SIGTERM sends a stop frame (the
+ * set_state(0x80) payload, precomputed) to every motor.
+ *
+ * The thread sleeps in ppoll() on the socket and a signal pipe, so replies and
+ * signals are handled as they arrive; timeouts are checked at least every
+ * `period`. Stops are retried on a full TX queue until all are written, and
+ * the reaction latency is measured against stop_deadline.
+ * Only one monitor can handle signals at a time.
+ */
+class FaultMonitor {
+public:
+    static constexpr size_t MAX_MOTORS = 32;
+
+    explicit FaultMonitor(const std::string &interface, const FaultConfig &cfg = FaultConfig());
+    // Takes over an open socket, see CANBus(int)
+    explicit FaultMonitor(int fd, const FaultConfig &cfg = FaultConfig());
+    ~FaultMonitor();
+
+    /**
+     * @brief Adds a motor to watch (setup phase, before start()).
+     * @return Index of the motor, or -1 if full.
+     */
+    int add_motor(const MotorInfo &info);
+
+    /**
+     * @brief Installs the signal handlers and starts the thread.
+     * @return False if the socket did not open or the monitor already runs.
+     */
+    bool start();
+
+    /**
+     * @brief Stops watching without stopping the motors; restores the handlers.
+     */
+    void stop();
+
+    /**
+     * @brief Stops all motors now, as if a fault had been detected.
+     */
+    void trip();
+
+    /**
+     * @brief Called on the monitor thread once all stop frames are out.
+     */
+    void set_on_trip(std::function<void(const FaultReport &)> fn) { on_trip = std::move(fn); }
+
+    bool is_tripped() const { return tripped.load(); }
+    // For MotorControl::set_abort_flag(): set once the stops are out
+    const std::atomic<bool> *get_tripped_flag() const { return &tripped; }
+    const FaultReport &get_report() const { return report; } // valid once tripped
+    uint64_t get_heartbeat_count() const { return heartbeats.load(); }
+
+    // Prevent copy/move
+    FaultMonitor(const FaultMonitor&) = delete;
+    FaultMonitor& operator=(const FaultMonitor&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    FaultConfig cfg;
+    CANBus bus;
+    std::unique_ptr<MotorControl> motors[MAX_MOTORS];
+    MotorProtocol protocols[MAX_MOTORS];
+    Clock::time_point last_rx[MAX_MOTORS];
+    Clock::time_point last_heartbeat[MAX_MOTORS];
+    size_t count = 0;
+
+    int wake_pipe[2] = {-1, -1};
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> tripped{false};
+    std::atomic<bool> trip_requested{false};
+    std::atomic<uint64_t> heartbeats{0};
+    FaultReport report;
+    std::function<void(const FaultReport &)> on_trip;
+
+    void init();
+    void run();
+    // Decodes pending replies; true (and fills report) on a drive fault
+    bool drain(Clock::time_point now);
+    bool check_ages(Clock::time_point now, Clock::time_point &onset);
+    void send_heartbeats(Clock::time_point now);
+    void stop_all(Clock::time_point onset, Clock::time_point detected);
+};
+
+const char *fault_name(Fault fault);
+
+#endif // FAULT_MONITOR_HPP
@@ -0,0 +1,146 @@
+#ifndef HAND_GATEWAY_HPP
+#define HAND_GATEWAY_HPP
+
+#include "can_transport.hpp"
+#include "motor_control.hpp"
+#include "spi_hand.hpp"
+#include "periodic_loop.hpp"
+#include "joint_controller.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Snapshot of the whole hand: CAN joints first, then the six servo DOFs.
+ */
+struct HandState {
+    static constexpr size_t MAX_JOINTS = 16 + FINGER_DOF;
+
+    size_t joints = 0;
+    uint64_t pose_id = 0;       // latest pose passed to set_pose()
+    uint64_t can_pose_id = 0;   // pose last sent on the CAN bus
+    uint64_t spi_pose_id = 0;   // pose last sent to the servo board
+    bool synchronized = false;  // both transports are running pose_id
+    float target[MAX_JOINTS] = {}; // NAN until a pose sets it (servos: the board holds them)
+    float pos[MAX_JOINTS] = {}; // measured (servos: the board's slew position), NAN until the first reply
+    uint8_t spi_status = 0;
+    bool spi_acked = false;     // the board accepted the previous tick's packet
+};
+
+/**
+ * @brief Owns the CAN motors and the SPI servo board and drives them as one hand.
+ * Each transport has its own I/O thread (a PeriodicLoop at the control period)
+ * which picks up the latest whole-hand pose every tick, so a pose reaches both
+ * transports within one period. Replies from both are merged into one HandState.
+ * The ticks never take a lock: the pose reaches them and their feedback comes
+ * back through seqlocks, so a caller of set_pose() or get_state() cannot hold
+ * up an I/O thread.
+ */
+class HandGateway {
+public:
+    static constexpr size_t MAX_CAN_JOINTS = 16;
+    static constexpr size_t MAX_JOINTS = HandState::MAX_JOINTS;
+
+    /**
+     * @param bus CAN bus of the motors, may be nullptr.
+     * @param spi Servo board link, may be nullptr.
+     */
+    HandGateway(CanTransport *bus, SpiHandLink *spi);
+    ~HandGateway();
+
+    /**
+     * @brief Adds a CAN motor as the next joint (setup phase, before start).
+     * @param vel_rpm Speed limit sent with every setpoint.
+     * @return Joint index, or -1 if full / the motor cannot stream positions.
+     */
+    int add_can_joint(MotorControl *motor, float vel_rpm);
+
+    /**
+     * @brief Number of joints: CAN joints, plus FINGER_DOF with a servo board.
+     */
+    size_t size() const { return can_count + (spi ? FINGER_DOF : 0); }
+
+    /**
+     * @brief Starts both I/O threads.
+     * @return False if already running.
+     */
+    bool start(std::chrono::microseconds period);
+
+    /**
+     * @brief Stops the I/O threads (the last setpoints stay with the drives).
+     */
+    void stop();
+
+    /**
+     * @brief Publishes a whole-hand pose in degrees (thread-safe, latest wins).
+     * @param n Number of targets, at most size(); missing joints keep their target.
+     */
+    void set_pose(const float *targets_deg, size_t n);
+
+    /**
+     * @brief Copies the merged hand state (thread-safe).
+     */
+    void get_state(HandState &out) const;
+
+    /**
+     * @brief Worst time from set_pose() to the transport sending it, in µs.
+     */
+    int64_t get_max_can_dispatch_us() const;
+    int64_t get_max_spi_dispatch_us() const;
+
+    uint64_t get_can_overruns() const { return can_loop.get_overrun_count(); }
+    uint64_t get_spi_overruns() const { return spi_loop.get_overrun_count(); }
+
+    // Prevent copy/move
+    HandGateway(const HandGateway&) = delete;
+    HandGateway& operator=(const HandGateway&) = delete;
+
+private:
+    CanTransport *bus;
+    SpiHandLink *spi;
+    std::array<MotorControl *, MAX_CAN_JOINTS> motors{};
+    std::array<float, MAX_CAN_JOINTS> vel_limit{};
+    size_t can_count = 0;
+
+    struct Pose {
+        uint64_t id = 0;
+        std::chrono::steady_clock::time_point stamp;
+        float target[MAX_JOINTS];
+    };
+    // What a tick last sent and measured
+    struct CanFeedback {
+        uint64_t pose_id = 0;
+        int64_t max_dispatch_us = 0;
+        float pos[MAX_CAN_JOINTS];
+    };
+    struct SpiFeedback {
+        uint64_t pose_id = 0;
+        int64_t max_dispatch_us = 0;
+        float pos[FINGER_DOF];
+        uint8_t status = 0;
+        bool acked = false;
+    };
+
+    // Serializes the pose writers (and get_state()); never taken by the ticks
+    mutable std::mutex pose_mtx;
+    Pose pose;
+    SeqlockValue<Pose> shared_pose;
+    SeqlockValue<CanFeedback> shared_can;
+    SeqlockValue<SpiFeedback> shared_spi;
+
+    // Owned by the tick threads: a torn read keeps the previous pose
+    Pose can_pose;
+    Pose spi_pose;
+    CanFeedback can_fb;
+    SpiFeedback spi_fb;
+
+    PeriodicLoop can_loop;
+    PeriodicLoop spi_loop;
+
+    void can_tick();
+    void spi_tick();
+};
+
+#endif // HAND_GATEWAY_HPP
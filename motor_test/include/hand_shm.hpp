@@ -0,0 +1,198 @@
+#ifndef HAND_SHM_HPP
+#define HAND_SHM_HPP
+
+// Client side of the hand's shared-memory interface (server: hand_shm_server.hpp).
+// Self-contained so planner / perception processes can include just this file:
+//
+//   HandShmClient hand;                       // maps /hand_shm created by hand_gateway --shm
+//   float pose[7] = {...};
+//   uint64_t id = hand.send(pose, 7);         // lock-free, never blocks
+//   hand.wait_ack(id, std::chrono::milliseconds(1));
+//   HandShmState st; hand.read_state(st);     // consistent snapshot (seqlock)
+//
+// The server sleeps on the doorbell futex between control periods; send()
+// rings it only when the server is asleep, so a command is applied (and
+// acknowledged) within the wake-up latency, tens of µs, not a whole period.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+constexpr const char *HAND_SHM_DEFAULT_NAME = "/hand_shm";
+constexpr uint32_t HAND_SHM_MAGIC = 0x48534D31;  // "HSM1"
+constexpr uint32_t HAND_SHM_VERSION = 2;
+constexpr size_t HAND_SHM_MAX_JOINTS = 22;       // 16 CAN joints + 6 servo DOFs
+constexpr size_t HAND_SHM_MAILBOX_SLOTS = 64;    // power of two
+
+/**
+ * @brief One command: new targets (degrees) for the joints set in mask.
+ */
+struct HandShmCommand {
+    uint64_t id = 0;
+    uint32_t mask = 0;
+    float target[HAND_SHM_MAX_JOINTS] = {};
+};
+
+/**
+ * @brief Joint state published by the server.
+ */
+struct HandShmState {
+    uint64_t stamp_ns = 0;      // steady_clock (CLOCK_MONOTONIC) of the snapshot
+    uint64_t ack_id = 0;        // last command merged into target
+    uint32_t joints = 0;
+    uint32_t synchronized = 0;  // all transports run the current targets
+    float target[HAND_SHM_MAX_JOINTS] = {};
+    float pos[HAND_SHM_MAX_JOINTS] = {};
+};
+
+/**
+ * @brief Layout of the segment. Counters live on their own cache lines so
+ * clients enqueuing and the server publishing do not false-share.
+ */
+struct HandShmSegment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t joints;
+
+    // Mailbox: bounded MPSC queue (Vyukov); slot.seq says whose turn it is
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq;
+        HandShmCommand cmd;
+    };
+    alignas(64) std::atomic<uint64_t> next_id;
+    alignas(64) std::atomic<uint64_t> enqueue_pos;
+    alignas(64) std::atomic<uint64_t> dequeue_pos;
+    Slot slots[HAND_SHM_MAILBOX_SLOTS];
+
+    // Doorbell: bumped after every command; a futex while server_waiting is set
+    alignas(64) std::atomic<uint32_t> doorbell;
+    std::atomic<uint32_t> server_waiting;
+
+    // State: seqlock, odd while the server writes
+    alignas(64) std::atomic<uint32_t> state_seq;
+    HandShmState state;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "the doorbell is used as a futex word");
+static_assert((HAND_SHM_MAILBOX_SLOTS & (HAND_SHM_MAILBOX_SLOTS - 1)) == 0, "slots must be a power of two");
+
+/**
+ * @brief Maps an existing segment and talks to it without locks; the only
+ * syscall is the doorbell wake-up when the server sleeps.
+ */
+class HandShmClient {
+private:
+    HandShmSegment *seg = nullptr;
+
+public:
+    explicit HandShmClient(const char *name = HAND_SHM_DEFAULT_NAME) {
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0) return;
+        void *p = mmap(nullptr, sizeof(HandShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return;
+        seg = static_cast<HandShmSegment *>(p);
+        if (seg->magic != HAND_SHM_MAGIC || seg->version != HAND_SHM_VERSION) {
+            munmap(seg, sizeof(HandShmSegment));
+            seg = nullptr;
+        }
+    }
+
+    ~HandShmClient() {
+        if (seg) munmap(seg, sizeof(HandShmSegment));
+    }
+
+    HandShmClient(const HandShmClient &) = delete;
+    HandShmClient &operator=(const HandShmClient &) = delete;
+
+    bool is_open() const { return seg != nullptr; }
+    size_t joints() const { return seg ? seg->joints : 0; }
+
+    /**
+     * @brief Queues new targets for the joints in mask.
+     * @return Command id (> 0), or 0 if the mailbox is full or not mapped.
+     */
+    uint64_t send_masked(const float *targets, uint32_t mask) {
+        if (!seg) return 0;
+        uint64_t pos = seg->enqueue_pos.load(std::memory_order_relaxed);
+        HandShmSegment::Slot *slot;
+        while (true) {
+            slot = &seg->slots[pos & (HAND_SHM_MAILBOX_SLOTS - 1)];
+            uint64_t seq = slot->seq.load(std::memory_order_acquire);
+            int64_t diff = (int64_t)seq - (int64_t)pos;
+            if (diff == 0) {
+                if (seg->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return 0; // full: the server has not drained for a whole mailbox
+            } else {
+                pos = seg->enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        uint64_t id = seg->next_id.fetch_add(1, std::memory_order_relaxed) + 1;
+        slot->cmd.id = id;
+        slot->cmd.mask = mask;
+        for (size_t i = 0; i < HAND_SHM_MAX_JOINTS; ++i) {
+            if (mask & (1u << i)) slot->cmd.target[i] = targets[i];
+        }
+        slot->seq.store(pos + 1, std::memory_order_release);
+
+        // Either the server sees the new doorbell before it sleeps, or this
+        // sees it waiting (both seq_cst)
+        seg->doorbell.fetch_add(1, std::memory_order_seq_cst);
+        if (seg->server_waiting.load(std::memory_order_seq_cst))
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&seg->doorbell), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+        return id;
+    }
+
+    /**
+     * @brief Queues targets for joints 0..n-1.
+     */
+    uint64_t send(const float *targets, size_t n) {
+        if (n > HAND_SHM_MAX_JOINTS) n = HAND_SHM_MAX_JOINTS;
+        uint32_t mask = (n >= 32) ? 0xFFFFFFFFu : ((1u << n) - 1);
+        return send_masked(targets, mask);
+    }
+
+    /**
+     * @brief Copies a consistent state snapshot (retries while the server writes).
+     * @return False if the segment is not mapped.
+     */
+    bool read_state(HandShmState &out) const {
+        if (!seg) return false;
+        while (true) {
+            uint32_t s0 = seg->state_seq.load(std::memory_order_acquire);
+            if (s0 & 1) continue;
+            std::memcpy(&out, &seg->state, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seg->state_seq.load(std::memory_order_relaxed) == s0) return true;
+        }
+    }
+
+    /**
+     * @brief Polls (yielding) until the server has applied command id (or newer).
+     * @return False on timeout or if the segment is not mapped.
+     */
+    bool wait_ack(uint64_t id, std::chrono::microseconds timeout) const {
+        if (!seg) return false;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        HandShmState st;
+        do {
+            read_state(st);
+            if (st.ack_id >= id) return true;
+            std::this_thread::yield(); // let the server run if it shares this core
+        } while (std::chrono::steady_clock::now() < deadline);
+        return false;
+    }
+};
+
+#endif // HAND_SHM_HPP
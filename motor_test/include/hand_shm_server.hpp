@@ -0,0 +1,57 @@
+#ifndef HAND_SHM_SERVER_HPP
+#define HAND_SHM_SERVER_HPP
+
+#include "hand_shm.hpp"
+#include "hand_gateway.hpp"
+#include <string>
+
+/**
+ * @brief Owner of the hand's shared-memory segment (clients: hand_shm.hpp).
+ * A single thread drains the command mailbox and publishes the state; between
+ * control periods it sleeps in wait_commands(), which clients wake.
+ */
+class HandShmServer {
+private:
+    std::string name;
+    HandShmSegment *seg = nullptr;
+    uint64_t last_id = 0;
+
+public:
+    /**
+     * @brief Creates (or re-creates) the segment for `joints` joints.
+     */
+    HandShmServer(const std::string &name = HAND_SHM_DEFAULT_NAME, size_t joints = HAND_SHM_MAX_JOINTS);
+
+    /**
+     * @brief Unmaps and unlinks the segment.
+     */
+    ~HandShmServer();
+
+    bool is_open() const { return seg != nullptr; }
+
+    /**
+     * @brief Merges every queued command into targets (latest wins per joint).
+     * @param n Number of entries in targets.
+     * @return Number of commands drained.
+     */
+    size_t poll_commands(float *targets, size_t n);
+
+    /**
+     * @brief Sleeps until a client queues a command or the timeout passes
+     * (returns at once if one is already queued).
+     * @return True if a command is queued.
+     */
+    bool wait_commands(std::chrono::microseconds timeout);
+
+    /**
+     * @brief Publishes a snapshot; ack_id is the last command drained so far.
+     */
+    void publish(const float *target, const float *pos, size_t n, bool synchronized);
+    void publish(const HandState &st);
+
+    // Prevent copy/move
+    HandShmServer(const HandShmServer&) = delete;
+    HandShmServer& operator=(const HandShmServer&) = delete;
+};
+
+#endif // HAND_SHM_SERVER_HPP
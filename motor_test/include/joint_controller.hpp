@@ -0,0 +1,134 @@
+#ifndef JOINT_CONTROLLER_HPP
+#define JOINT_CONTROLLER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Single value shared between a control thread (reader) and setup
+ * threads (writers) without locking the reader: a seqlock, odd while written.
+ * Writers must be serialized by the caller.
+ */
+template <typename T>
+class SeqlockValue {
+public:
+    void store(const T &v) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value = v;
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies the value unless a write is in progress.
+     * @return False (out unchanged) if the copy would be torn.
+     */
+    bool try_load(T &out) const {
+        uint32_t s0 = seq.load(std::memory_order_acquire);
+        if (s0 & 1) return false;
+        T copy = value;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) != s0) return false;
+        out = copy;
+        return true;
+    }
+
+    uint32_t version() const { return seq.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> seq{0};
+    T value{};
+};
+
+/**
+ * @brief Per-joint feedback law for one loop level of the host controller.
+ *
+ * PID: u = kp*e + ki*integral(e) + kd*de + feedforward, where de is the
+ * reference rate minus the measured rate when a rate is given, otherwise the
+ * low-passed difference of the error.
+ * Impedance: a spring-damper about the reference, u = kp*e + kd*de +
+ * feedforward, with kp the stiffness and kd the damping and no integrator;
+ * with current output and kff_acc as the inertia this is a torque-level law.
+ *
+ * Anti-windup clamps the integrator to the output limit and stops integrating
+ * while the output saturates in the direction of the error. The integrator
+ * holds ki*integral(e), so changing ki at runtime does not bump the output.
+ *
+ * Gains are set from any thread; update() picks them up at its next call
+ * without locking. update() does not allocate.
+ */
+class JointController {
+public:
+    static constexpr size_t MAX_JOINTS = 16;
+
+    enum class Law : uint8_t { Pid, Impedance };
+
+    struct Gains {
+        Law law = Law::Pid;
+        float kp = 0.0f;           // output per unit error
+        float ki = 0.0f;           // output per unit error * s (PID only)
+        float kd = 0.0f;           // output per unit error rate
+        float kff_vel = 0.0f;      // output per unit reference rate
+        float kff_acc = 0.0f;      // output per unit reference acceleration
+        float bias = 0.0f;         // constant output, e.g. gravity / spring preload
+        float out_limit = 1.0f;    // |output| limit
+        float d_cutoff_hz = 0.0f;  // low-pass on the differenced error, 0 = off
+        bool anti_windup = true;
+    };
+
+    explicit JointController(size_t joints);
+
+    /**
+     * @brief Publishes new gains for a joint (thread-safe, used from the next update).
+     */
+    void set_gains(size_t joint, const Gains &gains);
+    void set_gains(const Gains &gains);
+    Gains get_gains(size_t joint) const;
+
+    /**
+     * @brief Computes one output per joint.
+     * @param dt Seconds since the previous update.
+     * @param ref Reference (e.g. position deg or velocity dps).
+     * @param ref_rate Reference rate, or nullptr for zero.
+     * @param ref_acc Reference acceleration (rate of ref_rate), or nullptr for zero.
+     * @param meas Measured value; NaN leaves that joint's output at zero.
+     * @param meas_rate Measured rate, or nullptr to difference the error.
+     * @param out Output, clamped to out_limit.
+     */
+    void update(float dt, const float *ref, const float *ref_rate, const float *ref_acc,
+                const float *meas, const float *meas_rate, float *out);
+
+    /**
+     * @brief Clears the integrator and derivative state of a joint (e.g. after
+     * re-enabling a motor).
+     */
+    void reset(size_t joint);
+    void reset();
+
+    bool is_saturated(size_t joint) const { return saturated[joint]; }
+    float get_integral(size_t joint) const { return integral[joint]; }
+    size_t size() const { return joints; }
+
+    // Prevent copy/move
+    JointController(const JointController&) = delete;
+    JointController& operator=(const JointController&) = delete;
+
+private:
+    size_t joints;
+
+    std::mutex gains_write_mutex; // serializes writers only
+    SeqlockValue<Gains> pending[MAX_JOINTS];
+    uint32_t active_version[MAX_JOINTS];
+    Gains active[MAX_JOINTS];
+
+    float integral[MAX_JOINTS];
+    float prev_error[MAX_JOINTS];
+    float d_filtered[MAX_JOINTS];
+    bool has_prev[MAX_JOINTS];
+    bool saturated[MAX_JOINTS];
+};
+
+#endif // JOINT_CONTROLLER_HPP
@@ -0,0 +1,85 @@
+#ifndef JOINT_ESTIMATOR_HPP
+#define JOINT_ESTIMATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Per-joint constant-acceleration Kalman filter (state: position,
+ * velocity, acceleration; measurement: position).
+ * Feedback is sparse and quantized (1 deg in RMD command replies, 0.1 deg from
+ * Bionic, 0.01 deg from LKtech reads), so the measurement noise of each joint
+ * is set from its resolution. Measurements carry the time they were taken:
+ * the receive time minus half the bus round trip. The filter state stays at
+ * the last measurement time and predict() extrapolates to the control tick,
+ * so late or irregular feedback never has to be undone.
+ * Joint data is stored structure-of-arrays; predict() and update() are
+ * straight loops across joints.
+ */
+class JointEstimator {
+public:
+    static constexpr size_t MAX_JOINTS = 16;
+
+    struct Params {
+        float jerk_density = 1.0e8f;   // process noise: white jerk, (deg/s^3)^2 / Hz
+        float resolution = 1.0f;       // deg, feedback quantization (noise = res^2 / 12)
+        float sensor_noise = 0.05f;    // deg, added in quadrature
+        float init_vel_std = 100.0f;   // deg/s, at the first measurement
+        float init_acc_std = 2000.0f;  // deg/s^2
+    };
+
+    explicit JointEstimator(size_t joints);
+    JointEstimator(size_t joints, const Params &params);
+
+    /**
+     * @brief Sets the feedback quantization of one joint (e.g. 0.01 for LKtech).
+     */
+    void set_resolution(size_t joint, float deg);
+
+    /**
+     * @brief Records a measured bus round trip (request to reply) for a joint;
+     * half of its running average is subtracted from receive times.
+     */
+    void observe_round_trip(size_t joint, double rtt_s);
+    double get_latency(size_t joint) const { return latency[joint]; }
+
+    /**
+     * @brief Ingests one position sample received at rx_time (seconds, steady clock).
+     */
+    void update(size_t joint, float pos_deg, double rx_time);
+
+    /**
+     * @brief Ingests one sample per joint received at rx_time; NaN entries are skipped.
+     */
+    void update(const float *pos_deg, double rx_time);
+
+    /**
+     * @brief Extrapolates every joint to time t (does not change the filter).
+     * Joints without a measurement yet report NaN.
+     */
+    void predict(double t, float *pos_deg, float *vel_dps, float *acc_dps2 = nullptr) const;
+
+    /**
+     * @brief 1-sigma position uncertainty of the filter state (at its last measurement).
+     */
+    float get_pos_std(size_t joint) const;
+
+    void reset(size_t joint);
+    size_t size() const { return joints; }
+
+private:
+    size_t joints;
+    Params params;
+
+    // State at the last measurement time t_meas
+    float p[MAX_JOINTS], v[MAX_JOINTS], a[MAX_JOINTS];
+    // Symmetric covariance, upper triangle
+    float P00[MAX_JOINTS], P01[MAX_JOINTS], P02[MAX_JOINTS];
+    float P11[MAX_JOINTS], P12[MAX_JOINTS], P22[MAX_JOINTS];
+    float R[MAX_JOINTS];
+    double t_meas[MAX_JOINTS];
+    double latency[MAX_JOINTS];
+    bool started[MAX_JOINTS];
+};
+
+#endif // JOINT_ESTIMATOR_HPP
@@ -0,0 +1,86 @@
+#ifndef LOOPBACK_BUS_HPP
+#define LOOPBACK_BUS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "can_transport.hpp"
+
+class SimMotor;
+
+/**
+ * @brief In-process CAN bus between the motor drivers and simulated motors.
+ *
+ * A sent frame is handed straight to every attached SimMotor; a reply is
+ * queued and becomes readable `reply_delay` later on the bus's virtual clock.
+ * The clock (and the motor models) only move in advance(), and a blocking
+ * read_msg() moves it to the next reply, so a run is deterministic, makes
+ * no syscalls and goes as fast as the code under test. With the default
+ * delay of zero a reply is readable at once, so code that polls on the wall
+ * clock (discovery, blocking reads) works without anyone advancing time.
+ * All calls are thread-safe.
+ */
+class LoopbackBus : public CanTransport {
+public:
+    static constexpr size_t MAX_MOTORS = 32;
+    static constexpr size_t RX_CAPACITY = 256;
+    static constexpr std::chrono::microseconds MODEL_STEP{1000}; // longest single model step
+
+    explicit LoopbackBus(std::chrono::microseconds reply_delay = std::chrono::microseconds(0));
+
+    /**
+     * @brief Connects a simulated motor (setup phase; the bus does not own it).
+     * @return False if MAX_MOTORS are attached.
+     */
+    bool attach(SimMotor *motor);
+
+    /**
+     * @brief Moves the virtual clock by dt, stepping the motor models (in
+     * steps of at most MODEL_STEP) and releasing replies that fall due.
+     */
+    void advance(std::chrono::microseconds dt);
+
+    /**
+     * @brief Virtual time since the bus was created.
+     */
+    std::chrono::microseconds now() const override;
+
+    using CanTransport::send_msg;
+    bool send_msg(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls = TxClass::Setpoint) override;
+
+    /**
+     * @brief Next reply, advancing the clock to it if it is not due yet.
+     * @return False if no reply is queued (none would ever arrive).
+     */
+    bool read_msg(uint32_t &id, std::vector<uint8_t> &data) override;
+    bool poll_msg(uint32_t &id, uint8_t *data, uint8_t &len) override;
+
+    /**
+     * @brief Replies lost because the receive queue was full.
+     */
+    uint64_t get_rx_overflows() const { return rx_overflows.get(); }
+
+private:
+    struct RxFrame {
+        std::chrono::microseconds due;
+        uint32_t id;
+        uint8_t len;
+        uint8_t data[8];
+    };
+
+    mutable std::mutex mtx;
+    std::chrono::microseconds reply_delay;
+    std::chrono::microseconds clock{0};
+    SimMotor *motors[MAX_MOTORS] = {};
+    size_t motor_count = 0;
+    RxFrame rx[RX_CAPACITY];
+    size_t rx_head = 0;
+    size_t rx_size = 0;
+    SharedMetricCounter rx_overflows;
+
+    void advance_locked(std::chrono::microseconds dt);
+    void pop_locked(uint32_t &id, uint8_t *data, uint8_t &len);
+};
+
+#endif // LOOPBACK_BUS_HPP
@@ -0,0 +1,117 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Monotonic event counter with one writer at a time (the thread that
+ * owns the motor / loop). add() is a relaxed load and store, no locked
+ * instruction; any thread may read it. Concurrent writers would lose counts:
+ * use SharedMetricCounter there.
+ */
+class MetricCounter {
+public:
+    void add(uint64_t n = 1) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+/**
+ * @brief Counter any number of threads may add to (one relaxed atomic add,
+ * wait-free on x86 and ARMv8.1+, a few ns more than MetricCounter).
+ */
+class SharedMetricCounter {
+public:
+    void add(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value{0};
+};
+
+/**
+ * @brief HDR-style latency histogram in nanoseconds: every power of two is
+ * split into 2^SUB_BITS linear sub-buckets, so any recorded value is known to
+ * within 12.5 % from 8 ns up to ~18 minutes (larger values land in the last
+ * bucket). Single writer like MetricCounter: record() finds the bucket with
+ * one count-leading-zeros and bumps it and the sum with relaxed loads and
+ * stores. Readers may run concurrently and see a sample in the bucket before
+ * it is in the sum.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 3;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BITS;
+    static constexpr unsigned MAX_BITS = 40;  // 2^40 ns ~ 18 min
+    static constexpr size_t BUCKETS = (size_t)(MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t ns) {
+        std::atomic<uint64_t> &b = buckets[bucket_of(ns)];
+        b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total_ns.store(total_ns.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    }
+    void record(std::chrono::nanoseconds d) { record(d.count() > 0 ? (uint64_t)d.count() : 0); }
+
+    static size_t bucket_of(uint64_t ns) {
+        if (ns < SUB_BUCKETS) return (size_t)ns;
+        unsigned msb = 63u - (unsigned)__builtin_clzll(ns);
+        if (msb >= MAX_BITS) return BUCKETS - 1;
+        unsigned shift = msb - SUB_BITS;
+        return ((size_t)(shift + 1) << SUB_BITS) + ((ns >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    // Smallest / largest value counted in bucket b
+    static uint64_t bucket_lower(size_t b) {
+        if (b < SUB_BUCKETS) return b;
+        unsigned shift = (unsigned)(b >> SUB_BITS) - 1;
+        return (uint64_t)(SUB_BUCKETS + (b & (SUB_BUCKETS - 1))) << shift;
+    }
+    static uint64_t bucket_upper(size_t b) {
+        return b + 1 < BUCKETS ? bucket_lower(b + 1) - 1 : UINT64_MAX;
+    }
+
+    uint64_t bucket_count(size_t b) const { return buckets[b].load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return total_ns.load(std::memory_order_relaxed); }
+    uint64_t count() const;
+
+    /**
+     * @brief Upper bound of the bucket holding the p-quantile (0..1); 0 if empty.
+     */
+    uint64_t percentile(double p) const;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    std::atomic<uint64_t> total_ns{0};
+};
+
+/**
+ * @brief Counters kept by every CanTransport. A bus is shared between threads (a
+ * control loop and the main thread sending stops), so its counters are
+ * shared; blocking reads come from one thread at a time.
+ */
+struct BusMetrics {
+    SharedMetricCounter tx_frames;        // written to the socket
+    SharedMetricCounter rx_frames;        // returned by read_msg() / poll_msg()
+    SharedMetricCounter rx_local_dropped; // local frames filtered out (set_receive_local(false))
+    LatencyHistogram read_wait;           // time blocked in read_msg()
+};
+
+/**
+ * @brief Counters kept by every MotorControl, updated by the thread driving
+ * the motor.
+ */
+struct MotorMetrics {
+    MetricCounter tx_frames;      // frames sent to the motor
+    MetricCounter rx_frames;      // replies decoded
+    MetricCounter read_timeouts;  // blocking reads that gave up without a reply
+    MetricCounter read_retries;   // frames / failed reads skipped while waiting for a reply
+    LatencyHistogram reply_latency; // request sent -> reply decoded (blocking reads)
+};
+
+#endif // METRICS_HPP
@@ -0,0 +1,80 @@
+#ifndef METRICS_EXPORTER_HPP
+#define METRICS_EXPORTER_HPP
+
+#include "can_transport.hpp"
+#include "motor_control.hpp"
+#include "metrics.hpp"
+#include "periodic_loop.hpp"
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Writes the bus and motor metrics to a file in the Prometheus text
+ * exposition format every period, for a local agent (node_exporter's textfile
+ * collector, or anything that scrapes a file) to pick up.
+ *
+ * Snapshots are written to `<path>.tmp` and renamed over `path`, so a reader
+ * never sees a partial file. Everything here runs on the exporter's own thread
+ * and only reads the counters; the control loops never wait on it.
+ */
+class MetricsExporter {
+public:
+    static constexpr size_t MAX_BUSES = 4;
+    static constexpr size_t MAX_MOTORS = 32;
+
+    explicit MetricsExporter(const std::string &path,
+                             std::chrono::milliseconds period = std::chrono::milliseconds(1000));
+    ~MetricsExporter();
+
+    /**
+     * @brief Exports a bus under the label bus="<name>" (setup phase, before start()).
+     * @return False if full.
+     */
+    bool add_bus(const std::string &name, CanTransport *bus);
+
+    /**
+     * @brief Exports a motor under motor="<name>", id="0x..." (setup phase).
+     * @return False if full.
+     */
+    bool add_motor(const MotorControl *motor);
+
+    /**
+     * @brief Starts the periodic writes.
+     * @return False if already running.
+     */
+    bool start();
+
+    /**
+     * @brief Stops the thread and writes a final snapshot.
+     */
+    void stop();
+
+    /**
+     * @brief One snapshot in exposition format.
+     */
+    std::string render();
+
+    /**
+     * @brief Renders and atomically replaces the file.
+     * @return False if the file could not be written.
+     */
+    bool write_snapshot();
+
+    // Prevent copy/move
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+private:
+    std::string path;
+    std::chrono::milliseconds period;
+    PeriodicLoop loop;
+
+    std::string bus_names[MAX_BUSES];
+    CanTransport *buses[MAX_BUSES] = {};
+    size_t bus_count = 0;
+    const MotorControl *motors[MAX_MOTORS] = {};
+    size_t motor_count = 0;
+};
+
+#endif // METRICS_EXPORTER_HPP
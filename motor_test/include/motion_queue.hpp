@@ -0,0 +1,95 @@
+#ifndef MOTION_QUEUE_HPP
+#define MOTION_QUEUE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Per-joint waypoint queue that turns moves into a continuous setpoint
+ * stream for the streaming position path (MotorControl::setpoint_write).
+ *
+ * Look-ahead: after every push the queue is re-planned backwards, so each
+ * segment knows the speed it may still have at its end (corner velocity) and
+ * the joint only slows down as much as the following moves require. A
+ * waypoint continuing in the same direction is passed at
+ * min(speed in, speed out); a reversal has to stop, but with a blend radius
+ * the turn may happen up to that many degrees before an intermediate
+ * waypoint. The last waypoint is always reached exactly, at rest.
+ *
+ * Fixed-size storage; step() does not allocate.
+ *
+ * TrajectoryRunner::set_motion_queue() streams it at the control rate
+ * (motor_test --batch --blend); gesture_bench compares it with stop-and-go.
+ */
+class MotionQueue {
+public:
+    static constexpr size_t MAX_JOINTS = 16;
+    static constexpr size_t DEPTH = 32;
+
+    /**
+     * @param accel_dps2 Acceleration limit of every joint.
+     * @param blend_deg Blend radius for reversals at intermediate waypoints.
+     */
+    MotionQueue(size_t joints, float accel_dps2 = 2000.0f, float blend_deg = 0.0f);
+
+    /**
+     * @brief Clears the joint's queue and sets its position (e.g. from feedback).
+     */
+    void reset(size_t joint, float pos_deg);
+
+    /**
+     * @brief Appends a waypoint.
+     * @param vel_dps Speed limit of the segment leading to it.
+     * @return False if the joint's queue is full or vel_dps is zero.
+     */
+    bool push(size_t joint, float target_deg, float vel_dps);
+
+    /**
+     * @brief Disables look-ahead: every waypoint is reached at rest, as with
+     * one move_and_monitor() call per waypoint (for comparisons).
+     */
+    void set_lookahead(bool enable);
+    void set_blend_radius(float deg);
+
+    /**
+     * @brief Advances every joint by dt seconds.
+     * @param setpoint_deg Per joint position setpoint.
+     * @param velocity_dps Optional, per joint signed velocity.
+     */
+    void step(float dt, float *setpoint_deg, float *velocity_dps = nullptr);
+
+    size_t pending(size_t joint) const { return joints[joint].count; }
+    bool idle() const;
+    float get_position(size_t joint) const { return joints[joint].pos; }
+    float get_speed(size_t joint) const { return joints[joint].speed; }
+
+private:
+    struct Segment {
+        float end = 0.0f;      // waypoint
+        float goal = 0.0f;     // where this segment actually ends (blend applied)
+        float vmax = 0.0f;
+        float exit = 0.0f;     // planned speed at goal
+        int8_t dir = 0;        // +1 / -1, 0 for a zero-length segment
+    };
+
+    struct Joint {
+        std::array<Segment, DEPTH> seg;
+        size_t head = 0;
+        size_t count = 0;
+        float pos = 0.0f;
+        float speed = 0.0f;    // >= 0, along the head segment's direction
+    };
+
+    size_t n;
+    float accel;
+    float blend;
+    bool lookahead = true;
+    std::array<Joint, MAX_JOINTS> joints;
+
+    Segment &at(Joint &j, size_t k) { return j.seg[(j.head + k) % DEPTH]; }
+    void plan(Joint &j);
+    void pop(Joint &j);
+};
+
+#endif // MOTION_QUEUE_HPP
@@ -1,19 +1,26 @@
 #ifndef MOTOR_CONTROLS_HPP
 #define MOTOR_CONTROLS_HPP
 
-#include "can_bus.hpp"
+#include "can_transport.hpp"
+#include "contact_detector.hpp"
+#include "thermal_model.hpp"
+#include "metrics.hpp"
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <cmath> // For NAN
+#include <chrono>
+#include <memory>
+#include <atomic>
 
 // Struct to hold decoded RMD feedback data
 struct RMDFeedback {
     int msg_class = 0;
-    int err_msg = 0;
+    int err_msg = 0;  // Bionic error code, or the RMD/LKtech 0x9A error flags
     float pos = NAN;
     float current = NAN;
     float temp = NAN;
+    float vel = NAN; // rpm, only reported by RMD/LKtech command replies
 };
 
 /**
@@ -23,58 +30,247 @@ struct RMDFeedback {
 class MotorControl {
 protected:
     uint32_t id;
-    CANBus *bus;
+    CanTransport *bus;
     std::string name;
 
+    // Latest state decoded from any reply frame of this motor
+    RMDFeedback state;
+    MotorMetrics metrics;
+    // When true the monitor loops use the reply to each position_write
+    // as feedback instead of sending a separate read request.
+    bool passive_feedback = true;
+
+    /**
+     * @brief Decodes every frame already waiting on the bus, oldest first, so
+     * state ends at the newest reply (status polls from a FaultMonitor pile
+     * up on the socket while nobody reads).
+     * @return Number of frames that were replies of this motor.
+     */
+    size_t drain_pending();
+
+    /**
+     * @brief Takes the newest waiting reply of this motor, or reads frames
+     * until one decodes if none is waiting.
+     * @return True if state was updated.
+     */
+    bool read_reply();
+
+    /**
+     * @brief Sends an 8-byte frame to this motor, counted in its metrics.
+     */
+    bool send_frame(const uint8_t *payload, TxClass cls = TxClass::Setpoint) {
+        metrics.tx_frames.add();
+        return bus->send_msg(id, payload, 8, cls);
+    }
+
+    /**
+     * @brief Sends an encoded setpoint, with a position read for drives that need one.
+     */
+    bool send_setpoint(const uint8_t *payload);
+
+    // Total frames sent + received on the bus, for frames-per-tick reports
+    uint64_t bus_frames() const { return bus->get_tx_count() + bus->get_rx_count(); }
+    void report_bus_usage(uint64_t frames_before, int ticks) const;
+
+    // Optional single-joint detector fed from state.current in the move loops
+    ContactDetector *contact_detector = nullptr;
+
+    /**
+     * @brief Feeds the latest decoded current to the contact detector during
+     * a move to target_deg at vel_rpm. Braking into the target takes current
+     * like a push, so the sample only counts while the joint is farther out
+     * than the drive needs to stop (it reaches speed and stops within the
+     * detector's settle time).
+     * @return True if contact was detected on this sample.
+     */
+    bool check_contact(float dt, float target_deg, float vel_rpm);
+
+    /**
+     * @brief Logs the hold command and the spike-to-stop latency.
+     */
+    void report_contact(std::chrono::steady_clock::time_point detected_at) const;
+
+    // Optional thermal model; current limits and current commands are derated through it
+    ThermalModel *thermal = nullptr;
+    size_t thermal_joint = 0;
+
+    /**
+     * @brief Feeds the latest decoded current and temperature to the thermal model.
+     */
+    void update_thermal(float dt);
+
+    // Optional flag (e.g. set by the fault monitor) that ends the move loops
+    const std::atomic<bool> *abort_flag = nullptr;
+    bool aborted() const { return abort_flag && abort_flag->load(std::memory_order_relaxed); }
+
 public:
-    MotorControl(uint32_t id, CANBus *bus, const std::string &name = "Motor");
+    MotorControl(uint32_t id, CanTransport *bus, const std::string &name = "Motor");
     virtual ~MotorControl() = default;
 
     // Pure virtual functions (must be implemented by derived classes)
     virtual void set_state(int cmd) = 0;
-    virtual std::vector<uint8_t> position_write(float pos_deg, float vel_rpm) = 0;
+    virtual bool position_write(float pos_deg, float vel_rpm) = 0;
     virtual float position_read() = 0;
     virtual float read_feedback() = 0;
     virtual void move_and_monitor(float target_deg, float vel_rpm) = 0;
 
+    /**
+     * @brief Decodes a received frame into the cached state.
+     * @return True if the frame is a reply of this motor.
+     */
+    virtual bool decode_reply(uint32_t rid, const uint8_t *data, size_t len) = 0;
+
+    /**
+     * @brief True if the replies to current/speed/position commands carry the
+     * output angle, so decoded state.pos is fresh after every command.
+     */
+    virtual bool command_reply_has_position() const { return true; }
+
+    /**
+     * @brief True if a reply accepted by decode_reply() carried the output angle.
+     */
+    virtual bool reply_has_position(const uint8_t *data, size_t len) const {
+        (void)data; (void)len; return command_reply_has_position();
+    }
+
+    /**
+     * @brief Encodes a current (torque) command into an 8-byte payload.
+     * @return False if the motor type has no current mode.
+     */
+    virtual bool encode_current(float amps, uint8_t *out) const { (void)amps; (void)out; return false; }
+
+    /**
+     * @brief Sends a current command (no allocation, does not wait for the reply).
+     * @return True if the frame was sent.
+     */
+    bool current_write(float amps);
+
+    /**
+     * @brief Encodes a speed command (output rpm) into an 8-byte payload.
+     * @return False if the motor type has no speed mode.
+     */
+    virtual bool encode_velocity(float rpm, uint8_t *out) const { (void)rpm; (void)out; return false; }
+
+    /**
+     * @brief Sends a speed command (no allocation, does not wait for the reply).
+     * @return True if the frame was sent.
+     */
+    bool velocity_write(float rpm);
+
+    /**
+     * @brief Encodes a position setpoint (output degrees, speed limit in rpm)
+     * into an 8-byte payload without touching the bus.
+     * @return False if the motor type cannot stream positions.
+     */
+    virtual bool encode_position(float pos_deg, float vel_rpm, uint8_t *out) const {
+        (void)pos_deg; (void)vel_rpm; (void)out; return false;
+    }
+
+    /**
+     * @brief Same with a current limit in amps, for drives that take one per
+     * frame (Bionic); the others ignore it.
+     */
+    virtual bool encode_position(float pos_deg, float vel_rpm, float cur, uint8_t *out) const {
+        (void)cur; return encode_position(pos_deg, vel_rpm, out);
+    }
+
+    /**
+     * @brief Encodes a position read request into an 8-byte payload.
+     * @return False if the motor type has none (its command replies carry the angle).
+     */
+    virtual bool encode_position_request(uint8_t *out) const { (void)out; return false; }
+
+    /**
+     * @brief Sends a position read (no allocation, does not wait for the reply);
+     * drain_replies() decodes the answer into state.pos.
+     * @return True if the frame was sent.
+     */
+    bool position_request();
+
+    /**
+     * @brief Sends a position setpoint (no allocation, does not wait for the reply).
+     * Used by the streaming paths; position_write() may block on a read.
+     * Drives whose command replies carry no angle also get a position_request(),
+     * which keeps state.pos fresh; their frame encodes the spin direction from
+     * it, so until the first read is answered only the read goes out.
+     * @return True if the setpoint frame was sent.
+     */
+    bool setpoint_write(float pos_deg, float vel_rpm);
+    bool setpoint_write(float pos_deg, float vel_rpm, float cur);
+
+    void set_passive_feedback(bool enable) { passive_feedback = enable; }
+
+    /**
+     * @brief Stops move loops at the current position when the detector sees contact.
+     * The detector must have a single joint; pass nullptr to disable.
+     */
+    void set_contact_detector(ContactDetector *det) { contact_detector = det; }
+
+    /**
+     * @brief Derates current limits/commands of this motor through joint `joint`
+     * of a (possibly shared) thermal model; pass nullptr to disable.
+     */
+    void set_thermal_model(ThermalModel *model, size_t joint) { thermal = model; thermal_joint = joint; }
+
+    /**
+     * @brief Move loops stop commanding as soon as *flag is true; nullptr to disable.
+     */
+    void set_abort_flag(const std::atomic<bool> *flag) { abort_flag = flag; }
+
     // Getters
     uint32_t get_id() const { return id; }
-    std::string get_name() const { return name; }
+    const std::string &get_name() const { return name; }
+    const RMDFeedback &get_state() const { return state; }
+    const MotorMetrics &get_metrics() const { return metrics; }
 };
 
 // --- Derived Motor Classes ---
 
 class LKtech_Motor : public MotorControl {
 public:
-    LKtech_Motor(uint32_t id, CANBus *bus, const std::string &name = "LKtech_Motor");
+    LKtech_Motor(uint32_t id, CanTransport *bus, const std::string &name = "LKtech_Motor");
 
     void set_state(int cmd) override;
-    std::vector<uint8_t> position_write(float pos_deg, float vel_rpm) override;
+    bool position_write(float pos_deg, float vel_rpm) override;
     float position_read() override;
     float read_feedback() override;
     void move_and_monitor(float target_deg, float vel_rpm) override;
+    bool decode_reply(uint32_t rid, const uint8_t *data, size_t len) override;
+    bool encode_current(float amps, uint8_t *out) const override;
+    bool encode_velocity(float rpm, uint8_t *out) const override;
+    bool encode_position(float pos_deg, float vel_rpm, uint8_t *out) const override;
+    bool encode_position_request(uint8_t *out) const override;
+    // Command replies carry the raw encoder only; the angle needs a 0x94 read
+    bool command_reply_has_position() const override { return false; }
+    bool reply_has_position(const uint8_t *data, size_t len) const override { return len >= 8 && data[0] == 0x94; }
 };
 
 class RMD_Motor : public MotorControl {
 public:
-    RMD_Motor(uint32_t id, CANBus *bus, const std::string &name = "RMD_Motor");
+    RMD_Motor(uint32_t id, CanTransport *bus, const std::string &name = "RMD_Motor");
 
     void set_state(int cmd) override;
-    std::vector<uint8_t> position_write(float pos_deg, float vel_rpm) override;
+    bool position_write(float pos_deg, float vel_rpm) override;
     float position_read() override;
     float read_feedback() override;
     void move_and_monitor(float target_deg, float vel_rpm) override;
+    bool decode_reply(uint32_t rid, const uint8_t *data, size_t len) override;
+    bool encode_current(float amps, uint8_t *out) const override;
+    bool encode_velocity(float rpm, uint8_t *out) const override;
+    bool encode_position(float pos_deg, float vel_rpm, uint8_t *out) const override;
+    // Every reply but the 0x9A status (temp, voltage, error flags) has the angle
+    bool reply_has_position(const uint8_t *data, size_t len) const override { return len >= 8 && data[0] != 0x9A; }
 };
 
 class RMD_BionicMotor : public MotorControl {
 public:
-    RMD_BionicMotor(uint32_t id, CANBus* bus, const std::string &name);
+    RMD_BionicMotor(uint32_t id, CanTransport *bus, const std::string &name);
 
     // Correct override (matches base class)
-    std::vector<uint8_t> position_write(float pos, float vel) override;
+    bool position_write(float pos, float vel) override;
 
     // EXTRA extension (NOT override)
-    std::vector<uint8_t> position_write(float pos, float vel, float cur);
+    bool position_write(float pos, float vel, float cur);
 
     float position_read() override;
     float read_feedback() override;
@@ -89,7 +285,17 @@ public:
     void position_write_absolute(float target_deg, float vel_rpm, float current_limit);
     
     void move_and_monitor(float target_deg, float vel_rpm) override;
+    bool decode_reply(uint32_t rid, const uint8_t *data, size_t len) override;
+    bool encode_current(float amps, uint8_t *out) const override;
+    bool encode_position(float pos_deg, float vel_rpm, uint8_t *out) const override;
+    // Position frame with an explicit current limit (derated through the thermal model)
+    bool encode_position(float pos, float vel, float cur, uint8_t *out) const override;
 };
 
+/**
+ * @brief Decodes every pending frame on the bus into the motor it belongs to
+ * (non-blocking, no allocation). Used by the streaming control modes.
+ */
+void drain_replies(CanTransport *bus, MotorControl *const *motors, size_t count);
 
 #endif // MOTOR_CONTROLS_HPP
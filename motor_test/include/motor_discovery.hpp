@@ -0,0 +1,83 @@
+#ifndef MOTOR_DISCOVERY_HPP
+#define MOTOR_DISCOVERY_HPP
+
+#include "can_transport.hpp"
+#include "motor_control.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class MotorProtocol : uint8_t {
+    RMD,     // commands on 0x140 + n, replies on 0x240 + n
+    LKtech,  // commands and replies on 0x140 + n
+    Bionic,  // 64-bit packed frames on ID n
+};
+
+/**
+ * @brief A motor that answered the discovery probe.
+ */
+struct MotorInfo {
+    MotorProtocol protocol = MotorProtocol::RMD;
+    uint32_t id = 0;        // command ID
+    bool enabled = false;   // enable confirmed by a reply
+};
+
+struct DiscoveryConfig {
+    uint32_t first = 1;     // motor numbers n to probe, for every protocol
+    uint32_t last = 32;
+    bool rmd = true;
+    bool lktech = true;
+    bool bionic = true;
+    // Probing ends after `quiet` without a new reply once everything is sent,
+    // or at `timeout` in any case
+    std::chrono::milliseconds quiet{5};
+    std::chrono::milliseconds timeout{100};
+};
+
+/**
+ * @brief Probes the ID range of all three protocols in one pipelined burst.
+ * Every probe frame goes out back-to-back (retrying while the TX queue is full)
+ * while replies are collected, so discovery takes about one bus round trip
+ * plus the time on the wire, not one timeout per ID.
+ * @return Motors sorted by protocol and ID.
+ */
+std::vector<MotorInfo> discover_motors(CanTransport *bus, const DiscoveryConfig &cfg = DiscoveryConfig());
+
+/**
+ * @brief Enables every motor and waits for its confirming reply (Bionic: an
+ * error-free status frame), resending to silent motors each `retry` interval.
+ * Sets MotorInfo::enabled.
+ * @return Number of motors confirmed before the timeout.
+ */
+size_t enable_motors(CanTransport *bus, std::vector<MotorInfo> &motors,
+                     std::chrono::milliseconds timeout = std::chrono::milliseconds(100),
+                     std::chrono::milliseconds retry = std::chrono::milliseconds(10));
+
+/**
+ * @brief Sends set_state(0x80) to every motor (whether or not its enable was
+ * confirmed) and waits for the stops to leave the TX queue.
+ * @return Number of stop frames the bus accepted.
+ */
+size_t disable_motors(CanTransport *bus, const std::vector<MotorInfo> &motors);
+
+/**
+ * @brief Driver for a discovered motor, named after its protocol and ID (e.g. "RMD_0x141").
+ */
+std::unique_ptr<MotorControl> make_motor(const MotorInfo &info, CanTransport *bus);
+
+/**
+ * @brief Parses "rmd:<id>", "lk:<id>" or "bionic:<id>".
+ * @return False if the spec is malformed.
+ */
+bool parse_motor_spec(const std::string &spec, MotorInfo &out);
+
+/**
+ * @brief Driver for a motor given as a spec; nullptr if the spec is malformed.
+ */
+std::unique_ptr<MotorControl> make_motor(const std::string &spec, CanTransport *bus);
+
+const char *protocol_name(MotorProtocol protocol);
+
+#endif // MOTOR_DISCOVERY_HPP
@@ -0,0 +1,51 @@
+#ifndef PERIODIC_LOOP_HPP
+#define PERIODIC_LOOP_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+/**
+ * @brief Runs a callback at a fixed period on its own thread.
+ * Deadlines are absolute (sleep_until), so the rate does not drift; a tick
+ * that takes longer than the period is counted as an overrun and the
+ * schedule restarts from the current time instead of bursting to catch up.
+ */
+class PeriodicLoop {
+public:
+    PeriodicLoop() = default;
+    ~PeriodicLoop();
+
+    /**
+     * @brief Starts calling fn every period.
+     * @return False if the loop is already running.
+     */
+    bool start(std::chrono::microseconds period, std::function<void()> fn);
+
+    /**
+     * @brief Stops the loop and joins the thread (the current tick completes).
+     */
+    void stop();
+
+    bool is_running() const { return running.load(); }
+    uint64_t get_tick_count() const { return ticks.load(); }
+    uint64_t get_overrun_count() const { return overruns.load(); }
+
+    // Prevent copy/move
+    PeriodicLoop(const PeriodicLoop&) = delete;
+    PeriodicLoop& operator=(const PeriodicLoop&) = delete;
+
+private:
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> overruns{0};
+    std::chrono::microseconds period{1000};
+    std::function<void()> fn;
+
+    void run();
+};
+
+#endif // PERIODIC_LOOP_HPP
@@ -0,0 +1,82 @@
+#ifndef REPLAY_BUS_HPP
+#define REPLAY_BUS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "can_transport.hpp"
+
+/**
+ * @brief Plays back recorded CAN traffic as received frames, e.g. a log of a
+ * run on the hand taken with `candump -L can0 > run.log`, to feed decoders,
+ * estimators and controllers the exact same input again.
+ *
+ * A frame becomes readable when the virtual clock reaches its recorded time
+ * (relative to the first frame). The clock moves in advance(), and a
+ * blocking read_msg() moves it to the next frame. Sent frames are counted
+ * and dropped. A candump log also holds the host's own commands: on drives
+ * that answer on the command ID (LKtech) keep only the replies with
+ * set_filter(). Thread-safe.
+ */
+class ReplayBus : public CanTransport {
+public:
+    /**
+     * @brief Loads a candump -L log ("(sec.usec) iface id#hexdata" lines).
+     */
+    explicit ReplayBus(const std::string &path);
+
+    bool is_open() const { return open; }
+    size_t size() const { return frames.size(); }
+    bool finished() const;
+
+    /**
+     * @brief Passes only frames with (frame id & mask) == (id & mask), like
+     * a CAN_RAW_FILTER.
+     */
+    void set_filter(uint32_t id, uint32_t mask);
+
+    /**
+     * @brief Moves the virtual clock by dt.
+     */
+    void advance(std::chrono::microseconds dt);
+    std::chrono::microseconds now() const override;
+
+    /**
+     * @brief Starts the playback over.
+     */
+    void rewind();
+
+    using CanTransport::send_msg;
+    bool send_msg(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls = TxClass::Setpoint) override;
+
+    /**
+     * @brief Next frame, advancing the clock to it if it is not due yet.
+     * @return False at the end of the log.
+     */
+    bool read_msg(uint32_t &id, std::vector<uint8_t> &data) override;
+    bool poll_msg(uint32_t &id, uint8_t *data, uint8_t &len) override;
+
+private:
+    struct Frame {
+        std::chrono::microseconds at;
+        uint32_t id;
+        uint8_t len;
+        uint8_t data[8];
+    };
+
+    mutable std::mutex mtx;
+    std::vector<Frame> frames;  // in log order
+    size_t next = 0;
+    std::chrono::microseconds clock{0};
+    uint32_t filter_id = 0;
+    uint32_t filter_mask = 0;
+    bool open = false;
+
+    // Skips filtered frames; true if frames[next] passes
+    bool seek_locked();
+};
+
+#endif // REPLAY_BUS_HPP
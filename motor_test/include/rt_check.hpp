@@ -0,0 +1,73 @@
+#ifndef RT_CHECK_HPP
+#define RT_CHECK_HPP
+
+#include <cstddef>
+
+/**
+ * @brief Debug check that real-time code neither allocates nor blocks.
+ *
+ * Built with -DMOTOR_RT_CHECK=ON, the executables replace malloc/free (and
+ * calloc, realloc, the aligned variants, so also operator new/delete) and a
+ * set of blocking calls:
+ *   - sleeps: nanosleep, clock_nanosleep, usleep, sleep
+ *   - waits: poll, ppoll, select, epoll_wait with a timeout other than zero
+ *   - I/O on a blocking descriptor without MSG_DONTWAIT: read, write, recv*, send*
+ *   - files and stdio: open, openat, fopen, fwrite, fputs, puts, fputc, putc, fflush
+ *     (std::cout / std::cerr end up in the stdio ones)
+ * A call is a violation when it is made inside an RT_SECTION() scope while
+ * the checker is armed (the steady-state phase: after start-up, before
+ * shutdown). Violations are counted per call site with their stack trace and
+ * printed by rt_check_report(); with RT_CHECK=abort in the environment the
+ * first one is printed and the process aborts, for use in test runs.
+ * Mutexes are not checked: the uncontended CANBus lock is part of the tick.
+ *
+ * Without MOTOR_RT_CHECK, RT_SECTION() expands to nothing and nothing is
+ * replaced; rt_check_arm() and rt_check_report() do nothing.
+ */
+
+/**
+ * @brief Starts (true) or ends (false) the steady-state phase.
+ */
+void rt_check_arm(bool armed);
+
+/**
+ * @brief Aborts on the first violation instead of recording it (also RT_CHECK=abort).
+ */
+void rt_check_set_abort(bool abort_on_violation);
+
+/**
+ * @brief Violations recorded so far (0 when the check is compiled out).
+ */
+size_t rt_check_violation_count();
+
+/**
+ * @brief Prints every call site with its count and stack trace to stderr.
+ * @return Number of violations.
+ */
+size_t rt_check_report();
+
+// Scope bookkeeping behind RT_SECTION()
+void rt_check_enter();
+void rt_check_leave();
+
+/**
+ * @brief Marks the enclosing scope as real-time code (see RT_SECTION).
+ */
+class RtSection {
+public:
+    RtSection() { rt_check_enter(); }
+    ~RtSection() { rt_check_leave(); }
+
+    RtSection(const RtSection&) = delete;
+    RtSection& operator=(const RtSection&) = delete;
+};
+
+#if MOTOR_RT_CHECK
+#define RT_CONCAT_(a, b) a##b
+#define RT_CONCAT(a, b) RT_CONCAT_(a, b)
+#define RT_SECTION() RtSection RT_CONCAT(rt_section_, __LINE__)
+#else
+#define RT_SECTION() ((void)0)
+#endif
+
+#endif // RT_CHECK_HPP
@@ -0,0 +1,109 @@
+#ifndef SIM_MOTOR_HPP
+#define SIM_MOTOR_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+/**
+ * @brief Simulated motor answering the same CAN protocol as the real drives.
+ * Used by the motor_sim tool so the host stack can run against vcan.
+ */
+class SimMotor {
+protected:
+    uint32_t id;
+    std::string name;
+
+    bool enabled = true;
+    float pos_deg = 0.0f;       // output shaft position
+    float vel_dps = 0.0f;       // output shaft speed
+    float target_deg = 0.0f;
+    float max_speed_dps = 0.0f;
+    float current_a = 0.0f;
+    float temp_c = 30.0f;
+    float voltage_v = 24.0f;
+    uint16_t error_flags = 0;   // reported by the 0x9A status read
+
+    // Control mode selected by the last command frame. In current mode the
+    // commanded current drives an inertia + damping load.
+    enum class Mode { Position, Velocity, Current };
+    Mode mode = Mode::Position;
+    float target_vel_dps = 0.0f;
+    float target_current = 0.0f;
+
+    // Constant load torque (e.g. gravity on the link), in amps of motor current
+    float load_a = 0.0f;
+
+    // Rigid object in the closing (increasing angle) direction
+    float obstacle_deg = NAN;
+    bool blocked = false;
+
+    void set_position_target(float deg, float max_dps);
+    void set_velocity_target(float dps);
+    void set_current_target(float amps);
+
+public:
+    SimMotor(uint32_t id, const std::string &name);
+    virtual ~SimMotor() = default;
+
+    /**
+     * @brief Handles one received frame.
+     * @param reply_id Arbitration ID of the reply.
+     * @param reply 8-byte reply payload.
+     * @return True if the motor answers the frame.
+     */
+    virtual bool handle_frame(uint32_t rid, const uint8_t *data, size_t len,
+                              uint32_t &reply_id, uint8_t reply[8]) = 0;
+
+    /**
+     * @brief Advances the motor model by dt seconds.
+     */
+    void step(float dt);
+
+    uint32_t get_id() const { return id; }
+    const std::string &get_name() const { return name; }
+    float get_pos() const { return pos_deg; }
+    float get_vel() const { return vel_dps; }
+    float get_target() const { return target_deg; }
+
+    /**
+     * @brief Places an object at deg; the motor stalls there and its current rises.
+     */
+    void set_obstacle(float deg) { obstacle_deg = deg; }
+
+    /**
+     * @brief Loads the shaft with a constant torque against increasing angle;
+     * in current mode it takes `amps` just to hold position.
+     */
+    void set_load(float amps) { load_a = amps; }
+
+    /**
+     * @brief Raises drive error flags (protocol encoding, 0 clears them).
+     */
+    void set_error(uint16_t flags) { error_flags = flags; }
+    bool is_blocked() const { return blocked; }
+};
+
+class SimRMDMotor : public SimMotor {
+public:
+    SimRMDMotor(uint32_t id, const std::string &name = "Sim_RMD");
+    bool handle_frame(uint32_t rid, const uint8_t *data, size_t len,
+                      uint32_t &reply_id, uint8_t reply[8]) override;
+};
+
+class SimLKtechMotor : public SimMotor {
+public:
+    SimLKtechMotor(uint32_t id, const std::string &name = "Sim_LKtech");
+    bool handle_frame(uint32_t rid, const uint8_t *data, size_t len,
+                      uint32_t &reply_id, uint8_t reply[8]) override;
+};
+
+class SimBionicMotor : public SimMotor {
+public:
+    SimBionicMotor(uint32_t id, const std::string &name = "Sim_Bionic");
+    bool handle_frame(uint32_t rid, const uint8_t *data, size_t len,
+                      uint32_t &reply_id, uint8_t reply[8]) override;
+};
+
+#endif // SIM_MOTOR_HPP
@@ -0,0 +1,176 @@
+#ifndef SPI_HAND_HPP
+#define SPI_HAND_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "servo_motion.h"
+#include "finger_frame.h"
+
+// 15-byte full-duplex packet of the servo hand board (Hand_Moving.ino), see
+// finger_frame.h: sync + 4-bit sequence, 6 DOFs in 0.01 deg, status byte on
+// replies, CRC-8 on both directions.
+constexpr size_t FINGER_PACKET_SIZE = FINGER_FRAME_SIZE;
+constexpr size_t FINGER_DOF = FINGER_FRAME_DOF;
+
+enum class FingerStatus : uint8_t {
+    Idle = 0x00,
+    Moving = 0x01,
+    Done = 0x02,
+    Halt = 0x12,
+};
+
+// Struct to hold a decoded finger packet
+struct FingerPacket {
+    bool valid = false; // sync and CRC checked
+    uint8_t seq = 0;
+    float angle_deg[FINGER_DOF] = {}; // commands: target (NAN: hold), replies: where the servos are
+    uint8_t status = 0;
+};
+
+/**
+ * @brief Encodes a command: 6 joint angles (degrees, clamped to 0..655.34);
+ * NAN holds that DOF on its current target (FINGER_ANGLE_HOLD).
+ */
+void encode_finger_packet(uint8_t seq, const float *angle_deg, uint8_t *out);
+
+/**
+ * @brief Decodes a command packet (slave side); valid only if sync and CRC match.
+ */
+FingerPacket decode_finger_command(const uint8_t *in);
+
+/**
+ * @brief Decodes a reply packet (master side); valid only if sync and CRC match.
+ */
+FingerPacket decode_finger_reply(const uint8_t *in);
+
+/**
+ * @brief Human-readable name of a status byte ("idle", "moving", "done", "halt").
+ */
+const char *finger_status_name(uint8_t status);
+
+/**
+ * @brief Full-duplex SPI byte transport (spidev or an in-process stand-in).
+ */
+class SpiTransport {
+public:
+    virtual ~SpiTransport() = default;
+
+    /**
+     * @brief Clocks `count` packets of `len` bytes back-to-back, chip select
+     * toggling between packets.
+     * @param tx count * len bytes to send.
+     * @param rx count * len bytes received.
+     * @return True on success.
+     */
+    virtual bool transfer(const uint8_t *tx, uint8_t *rx, size_t len, size_t count) = 0;
+};
+
+/**
+ * @brief Linux spidev master (e.g. /dev/spidev0.0 on the Jetson header).
+ * A batch of packets goes out in a single SPI_IOC_MESSAGE ioctl.
+ */
+class SpidevTransport : public SpiTransport {
+private:
+    int fd = -1;
+    uint32_t speed_hz;
+    uint16_t gap_us;
+
+public:
+    static constexpr size_t MAX_BATCH = 16;
+
+    /**
+     * @brief Opens the device in SPI mode 0, 8 bits, MSB first.
+     * @param speed_hz SCK frequency.
+     * @param gap_us Delay after each packet so the slave can process it.
+     */
+    SpidevTransport(const std::string &device, uint32_t speed_hz = 250000, uint16_t gap_us = 20);
+    ~SpidevTransport() override;
+
+    bool is_open() const { return fd >= 0; }
+    bool transfer(const uint8_t *tx, uint8_t *rx, size_t len, size_t count) override;
+
+    // Prevent copy/move
+    SpidevTransport(const SpidevTransport&) = delete;
+    SpidevTransport& operator=(const SpidevTransport&) = delete;
+};
+
+/**
+ * @brief In-process stand-in for the hand board slave.
+ * Like the firmware, each reply is the feedback as of the packet's start: the
+ * sequence of the last accepted command (so it trails by one packet), the
+ * servo angles at that moment and the status. Frames failing the CRC are
+ * dropped. Status comes from the firmware's own
+ * ServoMotion engine (idle, moving, done), run on the host clock or on the
+ * millis() stand-in given, so tests can move the servos in virtual time.
+ */
+class LoopbackSpiSlave : public SpiTransport {
+private:
+    uint8_t acked_seq = 0;
+    ServoMotion motion;
+    uint32_t crc_errors = 0;
+    std::function<uint32_t()> millis;
+
+public:
+    explicit LoopbackSpiSlave(float slew_deg_per_s = 180.0f, std::function<uint32_t()> millis = nullptr);
+
+    uint32_t get_crc_errors() const { return crc_errors; }
+
+    bool transfer(const uint8_t *tx, uint8_t *rx, size_t len, size_t count) override;
+};
+
+/**
+ * @brief Master side of the finger protocol over an SpiTransport.
+ */
+class SpiHandLink {
+private:
+    SpiTransport *spi;
+    FingerPacket last_reply;
+    float last_cmd[FINGER_DOF] = {};
+    uint8_t seq = 0;           // sequence of the last packet sent
+    uint8_t prev_seq = 0;      // of the packet before it, which the newest reply acknowledges
+    bool reply_ok = false;     // the newest reply passed sync and CRC
+    uint32_t packets_sent = 0;
+    uint32_t reply_errors = 0;
+
+public:
+    explicit SpiHandLink(SpiTransport *spi);
+
+    /**
+     * @brief Sends one command packet and decodes the reply clocked back with it.
+     * @return True on success.
+     */
+    bool send_angles(const float *angle_deg);
+
+    /**
+     * @brief Sends `count` command packets back-to-back in one batch, each with
+     * the next sequence number.
+     * @param angle_deg count x 6 angles.
+     * @param replies Optional, count decoded replies.
+     * @return True on success.
+     */
+    bool send_batch(const float *angle_deg, size_t count, FingerPacket *replies = nullptr);
+
+    /**
+     * @brief Clocks out a packet repeating the last command, to poll the status.
+     */
+    bool poll();
+
+    const FingerPacket &get_reply() const { return last_reply; }
+
+    /**
+     * @brief Replies dropped for a bad sync or CRC (last_reply keeps the last good one).
+     */
+    uint32_t get_reply_errors() const { return reply_errors; }
+    FingerStatus get_status() const { return static_cast<FingerStatus>(last_reply.status); }
+
+    /**
+     * @brief True if the newest reply acknowledges the packet sent before it.
+     * Replies trail by one packet, so after a send the command is confirmed
+     * by the next send or poll().
+     */
+    bool is_acked() const { return packets_sent > 1 && reply_ok && last_reply.seq == prev_seq; }
+};
+
+#endif // SPI_HAND_HPP
@@ -0,0 +1,51 @@
+#ifndef TELEMETRY_READER_HPP
+#define TELEMETRY_READER_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "hand_telemetry.h"
+
+/**
+ * @brief Reads the COBS-framed binary telemetry of the hand board (Hand_Moving.ino)
+ * from its USB serial port, see hand_telemetry.h.
+ */
+class TelemetryReader {
+private:
+    int fd = -1;
+    uint8_t frame[HAND_TELEMETRY_WIRE_SIZE];
+    size_t fill = 0;
+    bool overflow = false;      // discard until the next delimiter
+    uint64_t frames = 0;
+    uint64_t errors = 0;
+
+public:
+    /**
+     * @brief Opens the tty raw at the given baud rate; an empty device leaves the
+     * reader closed so bytes can still be fed by hand.
+     */
+    explicit TelemetryReader(const std::string &device = "", int baud = 115200);
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader &) = delete;
+    TelemetryReader &operator=(const TelemetryReader &) = delete;
+
+    bool is_open() const { return fd >= 0; }
+
+    /**
+     * @brief Splits a byte stream at 0x00 delimiters and decodes the records.
+     * @return Number of records written to out (at most max).
+     */
+    size_t feed(const uint8_t *data, size_t len, HandTelemetry *out, size_t max);
+
+    /**
+     * @brief Waits up to timeout_ms for serial data and decodes what arrived.
+     * @return Number of records written to out, 0 on timeout.
+     */
+    size_t poll(HandTelemetry *out, size_t max, int timeout_ms);
+
+    uint64_t get_frame_count() const { return frames; }
+    uint64_t get_error_count() const { return errors; }
+};
+
+#endif // TELEMETRY_READER_HPP
@@ -0,0 +1,41 @@
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+#include <cmath>
+#include <iostream>
+
+/**
+ * @brief Minimal checks for the ctest executables (*_test.cpp): a failed
+ * check prints its location and expression and the test keeps going;
+ * main() returns test_result().
+ */
+inline int &test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline int test_result(const char *test) {
+    if (test_failures() == 0) std::cout << "[" << test << "] all checks passed" << std::endl;
+    else std::cerr << "[" << test << "] " << test_failures() << " checks failed" << std::endl;
+    return test_failures() == 0 ? 0 : 1;
+}
+
+#define CHECK(cond)                                                                        \
+    do {                                                                                   \
+        if (!(cond)) {                                                                     \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n";     \
+            test_failures()++;                                                             \
+        }                                                                                  \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                              \
+    do {                                                                                   \
+        double check_a_ = (a), check_b_ = (b);                                             \
+        if (!(std::abs(check_a_ - check_b_) <= (tol))) {                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_NEAR(" #a ", " #b ") failed: " \
+                      << check_a_ << " vs " << check_b_ << "\n";                           \
+            test_failures()++;                                                             \
+        }                                                                                  \
+    } while (0)
+
+#endif // TEST_CHECK_HPP
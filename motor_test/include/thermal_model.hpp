@@ -0,0 +1,70 @@
+#ifndef THERMAL_MODEL_HPP
+#define THERMAL_MODEL_HPP
+
+#include <cstddef>
+
+/**
+ * @brief First-order winding temperature estimator with predictive current derating.
+ * Per joint: dT/dt = heat_gain * I^2 - cooling_rate * (T - ambient), corrected
+ * towards the temperature reported in motor feedback. From the estimate it
+ * predicts time-to-limit and the largest current that keeps the winding under
+ * the limit for the look-ahead horizon: the full requested current while cold,
+ * falling to the continuous rating as the motor heats up.
+ * Joint data is stored structure-of-arrays; update() is a straight loop across joints.
+ */
+class ThermalModel {
+public:
+    static constexpr size_t MAX_JOINTS = 16;
+
+    struct Params {
+        float heat_gain = 0.0185f;     // C/s per A^2 (3 A continuous -> +50 C)
+        float cooling_rate = 1.0f / 300.0f; // 1/s, 300 s thermal time constant
+        float ambient = 30.0f;         // C
+        float limit = 80.0f;           // C, fault threshold minus margin
+        float correction = 1.0f;       // 1/s, pull towards measured temperature
+        float horizon = 10.0f;         // s, look-ahead for derating
+    };
+
+    explicit ThermalModel(size_t joints);
+    ThermalModel(size_t joints, const Params &params);
+
+    /**
+     * @brief Advances all joints by dt with one current/temperature sample each.
+     * @param temp Measured temperatures; NaN entries skip the correction.
+     */
+    void update(const float *current, const float *temp, float dt);
+
+    /**
+     * @brief Advances a single joint (blocking move loops).
+     */
+    void update_joint(size_t joint, float current, float temp, float dt);
+
+    /**
+     * @brief Seconds until the estimate reaches the limit if current is held; -1 if never.
+     */
+    float time_to_limit(size_t joint, float current) const;
+
+    /**
+     * @brief Largest current (A) that keeps the joint under the limit over the horizon.
+     */
+    float allowed_current(size_t joint) const;
+
+    /**
+     * @brief Clamps a requested current limit to allowed_current(), keeping its sign.
+     */
+    float derate(size_t joint, float requested) const;
+
+    float get_temp(size_t joint) const { return temp_est[joint]; }
+    size_t size() const { return joints; }
+
+private:
+    size_t joints;
+    Params params;
+    float temp_est[MAX_JOINTS];
+    float allowed_sq[MAX_JOINTS]; // cached allowed current^2, refreshed by update
+    float decay;                  // exp(-cooling_rate * horizon)
+
+    void refresh_allowed(size_t joint);
+};
+
+#endif // THERMAL_MODEL_HPP
@@ -0,0 +1,126 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Scoped trace spans for finding where a tick's time goes.
+ *
+ * Built with -DMOTOR_TRACE=ON, TRACE_SPAN("can", "send_msg") records the
+ * enclosing scope as one complete event in a buffer owned by the calling
+ * thread: two clock reads and a store, no lock, no allocation once the thread
+ * has its buffer. trace_dump() writes every thread's events as Chrome
+ * trace-event JSON, which chrome://tracing and ui.perfetto.dev open.
+ *
+ * Without MOTOR_TRACE the macros expand to nothing, so the instrumented code
+ * is exactly the code without them. Names and categories must be string
+ * literals (only the pointer is stored).
+ */
+
+constexpr size_t TRACE_MAX_THREADS = 64;
+
+/**
+ * @brief Per-thread ring of events. Only the owning thread writes; the
+ * newest CAPACITY events are kept. A reader (trace_dump()) sees the events
+ * published before its acquire load, but may read a slot that is being
+ * overwritten if the thread is still tracing: dump after the loops stopped.
+ */
+class TraceBuffer {
+public:
+    static constexpr size_t CAPACITY = 1u << 15; // power of two, 1 MiB per thread
+
+    struct Event {
+        const char *cat;
+        const char *name;
+        int64_t start_ns;
+        int64_t dur_ns;
+    };
+
+    explicit TraceBuffer(uint32_t tid) : tid(tid) {}
+
+    void add(const char *cat, const char *name, int64_t start_ns, int64_t dur_ns) {
+        uint64_t n = written.load(std::memory_order_relaxed);
+        events[n & (CAPACITY - 1)] = {cat, name, start_ns, dur_ns};
+        written.store(n + 1, std::memory_order_release);
+    }
+
+    uint32_t get_tid() const { return tid; }
+    uint64_t get_written() const { return written.load(std::memory_order_acquire); }
+    const Event &get_event(uint64_t n) const { return events[n & (CAPACITY - 1)]; }
+
+    void set_name(const char *name_) { name.store(name_, std::memory_order_release); }
+    const char *get_name() const { return name.load(std::memory_order_acquire); }
+
+    // Prevent copy/move
+    TraceBuffer(const TraceBuffer&) = delete;
+    TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+private:
+    const uint32_t tid;
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> written{0};
+    Event events[CAPACITY];
+};
+
+/**
+ * @brief Steady clock in nanoseconds (trace_dump() starts the trace at the
+ * earliest event).
+ */
+inline int64_t trace_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief The calling thread's buffer, created and registered on first use
+ * (the only allocation). Null once TRACE_MAX_THREADS threads have traced.
+ */
+TraceBuffer *trace_thread_buffer();
+
+/**
+ * @brief Names the calling thread in the trace (a literal) and creates its
+ * buffer, so a loop thread does not allocate on its first traced tick.
+ */
+void trace_thread_name(const char *name);
+
+/**
+ * @brief Writes all threads' events to `path` as Chrome trace-event JSON.
+ * @return False if the file cannot be written or tracing is compiled out.
+ */
+bool trace_dump(const std::string &path);
+
+/**
+ * @brief Records the enclosing scope on destruction (see TRACE_SPAN).
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char *cat, const char *name) : cat(cat), name(name), start(trace_now_ns()) {}
+    ~TraceSpan() {
+        int64_t end = trace_now_ns();
+        if (TraceBuffer *b = trace_thread_buffer()) b->add(cat, name, start, end - start);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char *cat;
+    const char *name;
+    int64_t start;
+};
+
+#if MOTOR_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SPAN(cat, name) TraceSpan TRACE_CONCAT(trace_span_, __LINE__)(cat, name)
+#define TRACE_THREAD_NAME(name) trace_thread_name(name)
+#else
+#define TRACE_SPAN(cat, name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif // TRACE_HPP
@@ -0,0 +1,130 @@
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include "can_transport.hpp"
+#include "motor_control.hpp"
+#include "motion_queue.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One line of a waypoint file: "time joint target vel current"
+ * (seconds from start, joint index, degrees, rpm, amps). '#' starts a comment.
+ */
+struct Waypoint {
+    float time_s = 0.0f;
+    uint16_t joint = 0;
+    float target_deg = 0.0f;
+    float vel_rpm = 0.0f;
+    float current_a = 0.0f;
+};
+
+/**
+ * @brief Precompiled waypoint: times converted to control ticks, sorted, 20 bytes.
+ */
+struct TrajectoryStep {
+    uint32_t tick;
+    uint16_t joint;
+    uint16_t reserved;
+    float target_deg;
+    float vel_rpm;
+    float current_a;
+};
+static_assert(sizeof(TrajectoryStep) == 20, "TrajectoryStep must stay packed");
+
+/**
+ * @brief Parses a waypoint file; reports the first bad line on std::cerr.
+ * @return False on I/O or parse errors.
+ */
+bool load_waypoints(const std::string &path, std::vector<Waypoint> &out);
+
+/**
+ * @brief Sorts waypoints by time (stable) and converts them to control ticks.
+ */
+std::vector<TrajectoryStep> compile_trajectory(const std::vector<Waypoint> &waypoints,
+                                               std::chrono::microseconds period);
+
+/**
+ * @brief Per-move and whole-run results of a trajectory.
+ */
+struct TrajectoryStats {
+    size_t moves = 0;
+    size_t settled = 0;
+    std::vector<float> settle_ms;   // one entry per settled move
+    // Tracking error: feedback vs. a ramp from the move's start position at its
+    // speed limit, over all joint ticks with feedback
+    double sq_error_sum = 0.0;
+    size_t error_samples = 0;
+    float max_error = 0.0f;
+    uint64_t ticks = 0;
+    uint64_t overruns = 0;
+};
+
+/**
+ * @brief Streams a compiled trajectory to a group of motors at the control rate.
+ * Every tick the active setpoint of each joint is sent (the replies are the
+ * feedback), so the bus carries one frame per joint per tick. Without a
+ * MotionQueue the setpoint is the step's target and the drive ramps to it;
+ * with one, the steps become the queue's waypoints and the setpoint is its
+ * blended profile.
+ */
+class TrajectoryRunner {
+public:
+    static constexpr size_t MAX_JOINTS = 16;
+
+    /**
+     * @param tolerance_deg Band around the target that counts as settled.
+     */
+    TrajectoryRunner(CanTransport *bus, MotorControl *const *motors, size_t count, float tolerance_deg = 1.0f);
+
+    /**
+     * @brief Runs the trajectory on a PeriodicLoop (blocks until done).
+     * @param settle_timeout Extra time after the last step for the final moves to settle.
+     * @return False if a step names a joint that does not exist.
+     */
+    bool run(const std::vector<TrajectoryStep> &steps, std::chrono::microseconds period,
+             std::chrono::milliseconds settle_timeout = std::chrono::milliseconds(2000));
+
+    /**
+     * @brief Routes the steps through a queue (look-ahead, blends) instead of
+     * sending their targets directly; nullptr to disable. run() starts each
+     * joint from its measured position (read if unknown) and goes on until
+     * the queue is empty. The queue needs at least as many joints as motors.
+     */
+    void set_motion_queue(MotionQueue *q) { queue = q; }
+
+    const TrajectoryStats &get_stats() const { return stats; }
+
+    /**
+     * @brief Prints settle time and tracking error statistics.
+     */
+    void report() const;
+
+private:
+    CanTransport *bus;
+    MotorControl *const *motors;
+    size_t count;
+    float tolerance;
+    MotionQueue *queue = nullptr;
+    TrajectoryStats stats;
+
+    // Per joint: active setpoint and the move being timed
+    struct JointTrack {
+        bool active = false;
+        float target = 0.0f;
+        float vel = 0.0f;
+        float current = 0.0f;
+        float setpoint = NAN;       // last one sent (with a queue)
+        float start_pos = NAN;
+        uint32_t move_tick = 0;
+        int64_t settled_tick = -1;  // tick the joint last entered the band, -1 outside
+    };
+    JointTrack track[MAX_JOINTS];
+
+    void finish_move(JointTrack &t, std::chrono::microseconds period);
+};
+
+#endif // TRAJECTORY_HPP
@@ -0,0 +1,71 @@
+#ifndef VELOCITY_STREAM_HPP
+#define VELOCITY_STREAM_HPP
+
+#include "can_transport.hpp"
+#include "motor_control.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief Streams velocity setpoints to a group of motors (teleoperation).
+ * set_velocity() may be called from any thread at any rate; the latest value
+ * wins. tick() is meant for the periodic loop: it sends one speed frame per
+ * motor without waiting for replies, and commands zero speed for any motor
+ * whose setpoint is older than the deadman timeout. Setpoint age is measured
+ * on the bus clock (CanTransport::now()), so it runs in virtual time on the
+ * in-process transports.
+ */
+class VelocityStream {
+public:
+    static constexpr size_t MAX_MOTORS = 16;
+
+    VelocityStream(CanTransport *bus, std::chrono::milliseconds deadman = std::chrono::milliseconds(100));
+
+    /**
+     * @brief Adds a motor to the group (setup phase, before streaming).
+     * @return Index of the motor in the group, or -1 if full / unsupported.
+     */
+    int add_motor(MotorControl *motor);
+
+    /**
+     * @brief Publishes a new setpoint in output rpm (thread-safe, latest wins).
+     */
+    void set_velocity(size_t index, float rpm);
+
+    /**
+     * @brief Decodes replies received since the last tick, then sends one
+     * speed frame per motor.
+     * @return Number of frames sent.
+     */
+    size_t tick();
+
+    /**
+     * @brief Sends zero speed to all motors and expires their setpoints.
+     */
+    void stop();
+
+    /**
+     * @brief True if the motor's setpoint timed out at the last tick.
+     */
+    bool is_expired(size_t index) const { return expired[index].load(std::memory_order_relaxed); }
+
+    size_t size() const { return count; }
+    const RMDFeedback &get_state(size_t index) const { return motors[index]->get_state(); }
+
+    // Prevent copy/move
+    VelocityStream(const VelocityStream&) = delete;
+    VelocityStream& operator=(const VelocityStream&) = delete;
+
+private:
+    CanTransport *bus;
+    std::chrono::microseconds deadman;
+    std::array<MotorControl *, MAX_MOTORS> motors{};
+    std::array<std::atomic<float>, MAX_MOTORS> setpoints{};
+    std::array<std::atomic<int64_t>, MAX_MOTORS> stamps{}; // bus time (us) of last setpoint
+    std::array<std::atomic<bool>, MAX_MOTORS> expired{};
+    size_t count = 0;
+};
+
+#endif // VELOCITY_STREAM_HPP
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include "can_bus.hpp"
+#include "periodic_loop.hpp"
+
+// Socket vs io_uring CANBus backends on vcan. A responder thread (socket
+// backend) answers every frame sent to 0x141.. with the same payload on
+// ID + 0x100, like RMD drives. For each backend:
+//   tick phase   1 kHz loop like CurrentStream: drain replies, one frame per
+//                motor in a batch; syscalls and CPU time per tick
+//   ping phase   one frame, blocking read of its reply; round-trip latency
+//   sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+//   ./can_bench vcan0 [motors] [ticks] [round trips]
+constexpr uint32_t BASE_ID = 0x141;
+constexpr auto TICK_PERIOD = std::chrono::microseconds(1000);
+
+struct BackendResult {
+    double syscalls_per_tick = 0.0;
+    double tick_us = 0.0;         // mean CPU time of a tick
+    double replies_per_tick = 0.0;
+    double syscalls_per_rtt = 0.0;
+    int64_t rtt_ns[3] = {};        // p50, p99, max
+    int timeouts = 0;
+};
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void run_responder(const std::string &interface, uint32_t motors, std::atomic<bool> &running) {
+    CANBus bus(interface);
+    struct pollfd pfd {bus.get_fd(), POLLIN, 0};
+    uint32_t id;
+    uint8_t data[8];
+    uint8_t len;
+    while (running.load()) {
+        if (poll(&pfd, 1, 10) <= 0) continue;
+        while (bus.poll_msg(id, data, len)) {
+            if (id >= BASE_ID && id < BASE_ID + motors) bus.send_msg(id + 0x100, data, len);
+        }
+    }
+    bus.shutdown();
+}
+
+BackendResult run_backend(const std::string &interface, CANBackend backend, uint32_t motors, int ticks, int rounds) {
+    BackendResult r;
+    CANBus bus(interface, backend);
+    if (bus.get_backend() != backend) return r;
+
+    uint32_t id;
+    uint8_t data[8];
+    uint8_t len;
+
+    // --- Tick phase ---
+    uint64_t replies = 0;
+    int64_t busy_ns = 0;
+    int count = 0;
+    std::atomic<bool> done{false};
+    uint64_t sys0 = bus.get_syscall_count();
+    PeriodicLoop loop;
+    loop.start(TICK_PERIOD, [&] {
+        if (done.load(std::memory_order_relaxed)) return;
+        int64_t t0 = now_ns();
+        while (bus.poll_msg(id, data, len)) replies++;
+        bus.begin_batch();
+        for (uint32_t m = 0; m < motors; ++m) {
+            std::memcpy(data, &t0, 8);
+            bus.send_msg(BASE_ID + m, data, 8);
+        }
+        bus.flush();
+        busy_ns += now_ns() - t0;
+        if (++count == ticks) done.store(true);
+    });
+    while (!done.load()) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    loop.stop();
+    r.syscalls_per_tick = (double)(bus.get_syscall_count() - sys0) / ticks;
+    r.tick_us = busy_ns / 1000.0 / ticks;
+    r.replies_per_tick = (double)replies / ticks;
+
+    // Let the last replies arrive, then drop them
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    while (bus.poll_msg(id, data, len)) {}
+
+    // --- Ping phase ---
+    std::vector<int64_t> rtt;
+    rtt.reserve(rounds);
+    std::vector<uint8_t> reply;
+    sys0 = bus.get_syscall_count();
+    for (int i = 0; i < rounds; ++i) {
+        int64_t t0 = now_ns();
+        std::memcpy(data, &t0, 8);
+        if (!bus.send_msg(BASE_ID, data, 8)) {
+            r.timeouts++;
+            continue;
+        }
+        // The responder echoes the timestamp: stale replies are skipped
+        bool ok = false;
+        while (!ok && bus.read_msg(id, reply)) {
+            int64_t echoed = 0;
+            if (id == BASE_ID + 0x100 && reply.size() == 8) std::memcpy(&echoed, reply.data(), 8);
+            ok = echoed == t0;
+        }
+        if (ok) rtt.push_back(now_ns() - t0);
+        else r.timeouts++;
+    }
+    r.syscalls_per_rtt = rounds > 0 ? (double)(bus.get_syscall_count() - sys0) / rounds : 0.0;
+    std::sort(rtt.begin(), rtt.end());
+    auto pct = [&](double p) { return rtt.empty() ? 0 : rtt[(size_t)(p * (rtt.size() - 1))]; };
+    r.rtt_ns[0] = pct(0.5);
+    r.rtt_ns[1] = pct(0.99);
+    r.rtt_ns[2] = pct(1.0);
+    bus.shutdown();
+    return r;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "Usage: can_bench <vcan interface> [motors] [ticks] [round trips]\n";
+        return 1;
+    }
+    std::string interface = argv[1];
+    uint32_t motors = argc > 2 ? (uint32_t)std::atoi(argv[2]) : 8;
+    int ticks = argc > 3 ? std::atoi(argv[3]) : 5000;
+    int rounds = argc > 4 ? std::atoi(argv[4]) : 10000;
+    if (motors == 0 || motors > 64 || ticks <= 0) return 1;
+
+    std::atomic<bool> running{true};
+    std::thread responder(run_responder, interface, motors, std::ref(running));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::cout << "[can_bench] " << interface << ", " << motors << " motors, " << ticks << " ticks at 1 kHz, "
+              << rounds << " round trips" << std::endl;
+    for (CANBackend backend : {CANBackend::Socket, CANBackend::IoUring}) {
+        BackendResult r = run_backend(interface, backend, motors, ticks, rounds);
+        std::cout << "[can_bench] " << std::left << std::setw(9) << can_backend_name(backend) << std::right;
+        if (r.replies_per_tick == 0.0) {
+            std::cout << "not available" << std::endl;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(1) << " syscalls/tick " << std::setw(5) << r.syscalls_per_tick
+                  << "  tick " << std::setw(5) << r.tick_us << " us"
+                  << "  replies/tick " << std::setw(5) << r.replies_per_tick
+                  << " | syscalls/rtt " << std::setw(4) << r.syscalls_per_rtt
+                  << "  rtt p50 " << std::setw(6) << r.rtt_ns[0] / 1000.0 << " us, p99 " << std::setw(6)
+                  << r.rtt_ns[1] / 1000.0 << " us, max " << std::setw(7) << r.rtt_ns[2] / 1000.0 << " us"
+                  << "  (" << r.timeouts << " lost)" << std::endl;
+    }
+
+    running = false;
+    responder.join();
+    return 0;
+}
@@ -1,6 +1,12 @@
 #include "can_bus.hpp"
+#include "can_uring.hpp"
+#include "trace.hpp"
 #include <iostream>
+#include <algorithm>
 #include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <poll.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <linux/can.h>
@@ -8,7 +14,17 @@
 #include <net/if.h>
 #include <sys/ioctl.h>
 
-CANBus::CANBus(const std::string &interface) {
+CANBackend can_backend_from_env() {
+    const char *name = std::getenv("CAN_BACKEND");
+    if (name && (std::strcmp(name, "io_uring") == 0 || std::strcmp(name, "uring") == 0)) return CANBackend::IoUring;
+    return CANBackend::Socket;
+}
+
+const char *can_backend_name(CANBackend backend) {
+    return backend == CANBackend::IoUring ? "io_uring" : "socket";
+}
+
+CANBus::CANBus(const std::string &interface, CANBackend backend) {
     socket_fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
     if (socket_fd < 0) {
         perror("Socket creation failed");
@@ -27,28 +43,250 @@ CANBus::CANBus(const std::string &interface) {
         perror("CAN socket bind failed");
         close(socket_fd);
         socket_fd = -1;
+        return;
     }
+
+    open_backend(backend);
 }
 
-bool CANBus::send_msg(uint32_t id, const std::vector<uint8_t> &data) {
-    if (socket_fd < 0) return false;
+CANBus::CANBus(int fd, CANBackend backend) : socket_fd(fd) {
+    if (socket_fd >= 0) open_backend(backend);
+}
 
+void CANBus::open_backend(CANBackend backend) {
+    if (backend != CANBackend::IoUring) return;
+    uring = std::make_unique<CanUring>(socket_fd);
+    if (!uring->is_open()) {
+        std::cerr << "[CANBus] io_uring unavailable, using the socket backend\n";
+        uring.reset();
+    }
+}
+
+CANBus::~CANBus() = default;
+
+bool CANBus::send_msg(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls) {
+    if (socket_fd < 0 || len > CAN_MAX_DLEN) return false;
+    TRACE_SPAN("can", "send_msg");
+
+    // Always under the lock: a frame queued by another thread between an
+    // unlocked check and the write would be overtaken
+    std::lock_guard<std::mutex> lock(tx_mutex);
+    if (uring) reap_locked();
+    // Never overtake a waiting frame of the same or higher priority, but go
+    // ahead of lower ones; what waits follows strictly in class order
+    bool ahead = false;
+    for (size_t c = 0; c <= (size_t)cls; ++c) ahead |= tx_queues[c].size > 0;
+    bool ok = false;
+    WriteResult r = ahead ? WriteResult::Busy : write_frame(id, data, len, cls);
+    if (r == WriteResult::Busy) ok = enqueue_locked(cls, id, data, len);
+    else ok = r == WriteResult::Sent;
+    // A socket that just refused this frame takes no other either
+    bool refused = !ahead && r == WriteResult::Busy;
+    if (!refused && tx_pending.load(std::memory_order_relaxed) > 0) flush_locked();
+    // io_uring: staged; out now unless a batch is open (stops never wait)
+    if (uring && (!batching || cls == TxClass::Safety)) submit_locked();
+    return ok;
+}
+
+CANBus::WriteResult CANBus::write_frame(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls, bool retry) {
     struct can_frame frame {};
     frame.can_id = id;
-    frame.can_dlc = data.size();
+    frame.can_dlc = len;
     for (int i = 0; i < frame.can_dlc; i++)
         frame.data[i] = data[i];
 
-    int nbytes = write(socket_fd, &frame, sizeof(frame));
-    return (nbytes == sizeof(frame));
+    // io_uring: into a TX slot, written at the next submit; the result comes
+    // back as a completion (reap_locked)
+    if (uring) return uring->stage_tx(frame, (uint8_t)cls, retry) ? WriteResult::Sent : WriteResult::Busy;
+
+    // Never block the caller: a full queue is the scheduler's business
+    syscalls.fetch_add(1, std::memory_order_relaxed);
+    int nbytes = send(socket_fd, &frame, sizeof(frame), MSG_DONTWAIT);
+    if (nbytes == sizeof(frame)) {
+        metrics.tx_frames.add();
+        return WriteResult::Sent;
+    }
+    // ENOBUFS: the interface queue (qdisc) is full; EAGAIN: socket buffer full
+    if (nbytes < 0 && (errno == ENOBUFS || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return WriteResult::Busy;
+    return WriteResult::Failed;
+}
+
+bool CANBus::enqueue_locked(TxClass cls, uint32_t id, const uint8_t *data, uint8_t len, bool count) {
+    size_t c = (size_t)cls;
+    TxQueue &q = tx_queues[c];
+
+    // A newer setpoint makes the waiting one for the same motor obsolete; it
+    // takes over the old frame's place in line
+    if (cls == TxClass::Setpoint) {
+        for (size_t k = 0; k < q.size; ++k) {
+            TxFrame &f = q.at(k);
+            if (f.id != id) continue;
+            f.len = len;
+            std::memcpy(f.data, data, len);
+            tx_stats.superseded++;
+            return true;
+        }
+    }
+
+    if (q.size == TX_QUEUE_CAPACITY) {
+        tx_stats.dropped[c]++;
+        return false;
+    }
+    TxFrame &f = q.at(q.size);
+    f.id = id;
+    f.len = len;
+    std::memcpy(f.data, data, len);
+    q.size++;
+    tx_pending.fetch_add(1, std::memory_order_release);
+    if (count) tx_stats.queued[c]++;
+    return true;
+}
+
+size_t CANBus::flush_locked() {
+    size_t written = 0;
+    for (size_t c = 0; c < TX_CLASSES; ++c) {
+        TxQueue &q = tx_queues[c];
+        while (q.size > 0) {
+            TxFrame &f = q.at(0);
+            WriteResult r = write_frame(f.id, f.data, f.len, (TxClass)c, true);
+            if (r == WriteResult::Busy) return written;
+            if (r == WriteResult::Sent) {
+                tx_stats.retried[c]++;
+                written++;
+            } else {
+                tx_stats.dropped[c]++;
+            }
+            q.head = (q.head + 1) % TX_QUEUE_CAPACITY;
+            q.size--;
+            tx_pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    return written;
+}
+
+void CANBus::begin_batch() {
+    if (!uring) return;
+    std::lock_guard<std::mutex> lock(tx_mutex);
+    batching = true;
+}
+
+void CANBus::reap_locked() {
+    uring->reap_tx();
+    metrics.tx_frames.add(uring->take_tx_done());
+    struct can_frame frame;
+    uint8_t tag;
+    bool retry;
+    int err;
+    while (uring->pop_failed(frame, tag, retry, err)) {
+        TxClass cls = (TxClass)tag;
+        // A frame from the queue was counted as retried when it was staged
+        if (retry) tx_stats.retried[tag]--;
+        if (err != ENOBUFS && err != EAGAIN && err != EINTR) {
+            tx_stats.dropped[tag]++;
+            continue;
+        }
+        // Back in line like a frame the socket refused, unless a newer
+        // setpoint for the motor is already waiting
+        bool newer = false;
+        if (cls == TxClass::Setpoint) {
+            TxQueue &q = tx_queues[tag];
+            for (size_t k = 0; k < q.size && !newer; ++k) newer = q.at(k).id == frame.can_id;
+        }
+        if (newer) tx_stats.superseded++;
+        else enqueue_locked(cls, frame.can_id, frame.data, frame.can_dlc, !retry);
+    }
+}
+
+void CANBus::submit_locked() {
+    if (uring->staged() > 0) uring->submit();
+    // Writes complete inline: collect them (and requeue refused ones) now
+    reap_locked();
+}
+
+size_t CANBus::flush(std::chrono::microseconds wait) {
+    if (socket_fd < 0) return 0;
+    if (!uring && tx_pending.load(std::memory_order_acquire) == 0) return 0;
+    TRACE_SPAN("can", "flush");
+    auto deadline = std::chrono::steady_clock::now() + wait;
+
+    while (true) {
+        size_t left;
+        {
+            std::lock_guard<std::mutex> lock(tx_mutex);
+            if (uring) {
+                batching = false;
+                reap_locked();
+                flush_locked();
+                submit_locked();
+            } else {
+                flush_locked();
+            }
+            left = tx_pending.load(std::memory_order_acquire) + (uring ? uring->in_flight() : 0);
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (left == 0 || now >= deadline) return left;
+
+        // Wait for socket buffer space; ENOBUFS (full qdisc) is not reported
+        // by poll(), so back off briefly when the socket already looks writable
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+        auto backoff = std::min(remaining, std::chrono::nanoseconds(100000));
+        struct pollfd pfd {socket_fd, POLLOUT, 0};
+        bool writable = uring || (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLOUT));
+        auto sleep = writable ? backoff : remaining;
+        struct timespec ts {(time_t)(sleep.count() / 1000000000), (long)(sleep.count() % 1000000000)};
+        syscalls.fetch_add(uring ? 1 : 2, std::memory_order_relaxed);
+        ppoll(writable ? nullptr : &pfd, writable ? 0 : 1, &ts, nullptr);
+    }
+}
+
+size_t CANBus::get_tx_pending(TxClass cls) {
+    std::lock_guard<std::mutex> lock(tx_mutex);
+    // io_uring: a frame counts until its write has completed
+    return tx_queues[(size_t)cls].size + (uring ? uring->in_flight((uint8_t)cls) : 0);
+}
+
+TxStats CANBus::get_tx_stats() {
+    std::lock_guard<std::mutex> lock(tx_mutex);
+    return tx_stats;
 }
 
 bool CANBus::read_msg(uint32_t &id, std::vector<uint8_t> &data) {
     if (socket_fd < 0) return false;
+    TRACE_SPAN("can", "read_msg");
+    auto start = std::chrono::steady_clock::now();
+
+    if (uring) {
+        uint8_t buf[CAN_MAX_DLEN];
+        uint8_t len = 0;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(tx_mutex);
+                // Whatever was asked for has to be out before waiting for the answer
+                batching = false;
+                flush_locked();
+                submit_locked();
+                if (uring_receive_locked(id, buf, len, true)) break;
+            }
+            uring->wait();
+        }
+        metrics.read_wait.record(std::chrono::steady_clock::now() - start);
+        data.assign(buf, buf + len);
+        return true;
+    }
+
+    // Frames queued after ENOBUFS (often the request itself) go out before waiting
+    if (tx_pending.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(tx_mutex);
+        flush_locked();
+    }
 
     struct can_frame frame {};
+    syscalls.fetch_add(1, std::memory_order_relaxed);
     int nbytes = read(socket_fd, &frame, sizeof(frame));
     if (nbytes < 0) return false;
+    metrics.rx_frames.add();
+    metrics.read_wait.record(std::chrono::steady_clock::now() - start);
 
     id = frame.can_id;
     data.resize(frame.can_dlc);
@@ -58,6 +296,80 @@ bool CANBus::read_msg(uint32_t &id, std::vector<uint8_t> &data) {
     return true;
 }
 
+bool CANBus::poll_msg(uint32_t &id, uint8_t *data, uint8_t &len) {
+    if (socket_fd < 0) return false;
+    TRACE_SPAN("can", "poll_msg");
+
+    if (uring) {
+        std::lock_guard<std::mutex> lock(tx_mutex);
+        if (tx_pending.load(std::memory_order_acquire) > 0) {
+            flush_locked();
+            if (!batching) submit_locked();
+        }
+        return uring_receive_locked(id, data, len, receive_local);
+    }
+
+    // Receive loops run every tick: give waiting frames their retry here
+    if (tx_pending.load(std::memory_order_acquire) > 0) {
+        std::unique_lock<std::mutex> lock(tx_mutex, std::try_to_lock);
+        if (lock.owns_lock()) flush_locked();
+    }
+
+    struct can_frame frame {};
+    struct iovec iov {&frame, sizeof(frame)};
+    struct msghdr msg {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    int nbytes;
+    // Frames looped back from other local sockets carry MSG_DONTROUTE
+    while (true) {
+        syscalls.fetch_add(1, std::memory_order_relaxed);
+        nbytes = recvmsg(socket_fd, &msg, MSG_DONTWAIT);
+        if (nbytes < (int)sizeof(frame)) return false;
+        if (receive_local || !(msg.msg_flags & MSG_DONTROUTE)) break;
+        metrics.rx_local_dropped.add();
+    }
+    metrics.rx_frames.add();
+
+    id = frame.can_id;
+    len = frame.can_dlc;
+    for (int i = 0; i < frame.can_dlc; i++)
+        data[i] = frame.data[i];
+
+    return true;
+}
+
+bool CANBus::uring_receive_locked(uint32_t &id, uint8_t *data, uint8_t &len, bool all) {
+    struct can_frame frame;
+    int flags = 0;
+    bool got = false;
+    while (!got && uring->next_rx(frame, flags)) {
+        got = all || !(flags & MSG_DONTROUTE);
+        if (!got) metrics.rx_local_dropped.add();
+    }
+    // TX completions reaped on the way
+    reap_locked();
+    if (!got) return false;
+    metrics.rx_frames.add();
+
+    id = frame.can_id;
+    len = frame.can_dlc;
+    std::memcpy(data, frame.data, frame.can_dlc);
+    return true;
+}
+
+uint64_t CANBus::get_syscall_count() const {
+    return syscalls.load(std::memory_order_relaxed) + (uring ? uring->get_enter_count() : 0);
+}
+
+bool CANBus::set_loopback(bool enable) {
+    if (socket_fd < 0) return false;
+    int on = enable ? 1 : 0;
+    return setsockopt(socket_fd, SOL_CAN_RAW, CAN_RAW_LOOPBACK, &on, sizeof(on)) == 0;
+}
+
 void CANBus::shutdown() {
+    // The ring holds a reference to the socket
+    uring.reset();
     if (socket_fd >= 0) close(socket_fd);
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include "can_bus.hpp"
+#include "test_check.hpp"
+
+// The CANBus TX scheduler and counters on one end of a datagram socketpair:
+// the other end plays the interface, and a receive queue nobody reads is a
+// full qdisc.
+
+constexpr uint32_t POLL_ID = 0x100;
+constexpr uint32_t STOP_ID = 0x141;
+
+// Takes the next frame off the wire; 0 if there is none
+static uint32_t wire_next(int fd) {
+    struct can_frame frame {};
+    if (recv(fd, &frame, sizeof(frame), MSG_DONTWAIT) != (ssize_t)sizeof(frame)) return 0;
+    return frame.can_id;
+}
+
+static void test_safety_first() {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds) == 0);
+    CANBus bus(fds[0]);
+    const uint8_t data[8] = {};
+
+    // Polls until the socket is full and one has to wait
+    size_t written = 0;
+    while (bus.get_tx_pending() == 0 && written < 10000) {
+        CHECK(bus.send_msg(POLL_ID + (uint32_t)written, data, 8, TxClass::Poll));
+        written++;
+    }
+    CHECK(bus.get_tx_pending(TxClass::Poll) == 1);
+    uint32_t waiting = POLL_ID + (uint32_t)(written - 1);
+
+    // Room for one frame: the stop takes it, the waiting poll stays queued
+    CHECK(wire_next(fds[1]) == POLL_ID);
+    CHECK(bus.send_msg(STOP_ID, data, 8, TxClass::Safety));
+    CHECK(bus.get_tx_pending(TxClass::Safety) == 0);
+    CHECK(bus.get_tx_pending(TxClass::Poll) == 1);
+
+    std::vector<uint32_t> order;
+    for (uint32_t id; (id = wire_next(fds[1])) != 0;) order.push_back(id);
+    CHECK(bus.flush() == 0);
+    for (uint32_t id; (id = wire_next(fds[1])) != 0;) order.push_back(id);
+
+    CHECK(order.size() == written);
+    CHECK(!order.empty() && order[order.size() - 2] == STOP_ID);
+    CHECK(!order.empty() && order.back() == waiting);
+    TxStats stats = bus.get_tx_stats();
+    CHECK(stats.queued[(size_t)TxClass::Safety] == 0);
+    CHECK(stats.queued[(size_t)TxClass::Poll] == 1);
+
+    bus.shutdown();
+    close(fds[1]);
+}
+
+static void test_syscall_count() {
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds) == 0);
+    CANBus bus(fds[0]);
+
+    // Two receive threads on an empty socket: one recvmsg() per poll, none lost
+    constexpr int POLLS = 50000;
+    auto receive = [&bus] {
+        uint32_t id;
+        uint8_t data[8];
+        uint8_t len;
+        for (int k = 0; k < POLLS; ++k) bus.poll_msg(id, data, len);
+    };
+    std::thread other(receive);
+    receive();
+    other.join();
+    CHECK(bus.get_syscall_count() == 2 * POLLS);
+
+    bus.shutdown();
+    close(fds[1]);
+}
+
+int main() {
+    test_safety_first();
+    test_syscall_count();
+    return test_result("can_bus_test");
+}
@@ -0,0 +1,334 @@
+#include "can_uring.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Kernel headers older than 6.0 (Jetson Nano L4T) lack the multishot flags:
+// the backend is compiled out and CANBus stays on the socket
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define CAN_HAVE_IO_URING 1
+#else
+#define CAN_HAVE_IO_URING 0
+#endif
+
+#if CAN_HAVE_IO_URING
+
+static constexpr uint64_t RX_USER_DATA = ~0ULL;
+static constexpr uint64_t CANCEL_USER_DATA = ~1ULL;
+static constexpr uint16_t RX_GROUP = 0;
+
+template <typename T> static T load_acquire(const T *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+template <typename T> static void store_release(T *p, T v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+static int sys_setup(unsigned entries, io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_enter(int fd, unsigned submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, submit, min_complete, flags, nullptr, 0);
+}
+
+static int sys_register(int fd, unsigned op, const void *arg, unsigned n) {
+    return (int)syscall(__NR_io_uring_register, fd, op, arg, n);
+}
+
+CanUring::CanUring(int socket_fd) {
+    if (socket_fd < 0 || !setup(socket_fd)) {
+        std::cerr << "[CanUring] io_uring setup failed: " << std::strerror(errno) << "\n";
+        teardown();
+    }
+}
+
+CanUring::~CanUring() { teardown(); }
+
+bool CanUring::setup(int socket_fd) {
+    io_uring_params p {};
+    p.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL;
+    p.cq_entries = CQ_ENTRIES;
+    ring_fd = sys_setup(SQ_ENTRIES, &p);
+    if (ring_fd < 0) return false;
+
+    sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) { sq_ring = nullptr; return false; }
+    cq_ring = single ? sq_ring
+                     : mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) { cq_ring = nullptr; return false; }
+    sqes_size = p.sq_entries * sizeof(io_uring_sqe);
+    void *s = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (s == MAP_FAILED) return false;
+    sqes = (io_uring_sqe *)s;
+
+    uint8_t *sq = (uint8_t *)sq_ring;
+    sq_head = (unsigned *)(sq + p.sq_off.head);
+    sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    sq_flags = (unsigned *)(sq + p.sq_off.flags);
+    sq_array = (unsigned *)(sq + p.sq_off.array);
+    sq_mask = *(unsigned *)(sq + p.sq_off.ring_mask);
+    uint8_t *cq = (uint8_t *)cq_ring;
+    cq_head = (unsigned *)(cq + p.cq_off.head);
+    cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    cq_mask = *(unsigned *)(cq + p.cq_off.ring_mask);
+    cqes = (io_uring_cqe *)(cq + p.cq_off.cqes);
+    sq_local_tail = sq_submitted = *sq_tail;
+
+    // Registered socket and TX slots: no fd lookup or page pinning per frame
+    if (sys_register(ring_fd, IORING_REGISTER_FILES, &socket_fd, 1) < 0) return false;
+    struct iovec iov {tx_slots, sizeof(tx_slots)};
+    if (sys_register(ring_fd, IORING_REGISTER_BUFFERS, &iov, 1) < 0) return false;
+    for (unsigned i = 0; i < TX_SLOTS; ++i) free_slots[i] = (uint16_t)(TX_SLOTS - 1 - i);
+    free_count = TX_SLOTS;
+
+    // Receive buffer ring, page aligned
+    buf_ring_size = RX_BUFFERS * sizeof(io_uring_buf);
+    void *br = mmap(nullptr, buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (br == MAP_FAILED) return false;
+    buf_ring = (io_uring_buf_ring *)br;
+    io_uring_buf_reg reg {};
+    reg.ring_addr = (uint64_t)(uintptr_t)buf_ring;
+    reg.ring_entries = RX_BUFFERS;
+    reg.bgid = RX_GROUP;
+    if (sys_register(ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) return false;
+    for (unsigned i = 0; i < RX_BUFFERS; ++i) recycle((uint16_t)i);
+    return probe_rx();
+}
+
+bool CanUring::probe_rx() {
+    // Everything above works on 5.19, but multishot recvmsg (6.0) fails there
+    // with -EINVAL on every arm. Arm once and cancel it again: the receiving
+    // thread arms its own, and it must not be this one's.
+    arm_rx();
+    io_uring_sqe *sqe = get_sqe();
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = RX_USER_DATA;
+    sqe->user_data = CANCEL_USER_DATA;
+    submit();
+
+    int rx_res = 0;
+    bool rx_done = false, cancel_done = false;
+    while (!rx_done || !cancel_done) {
+        unsigned head = *cq_head;
+        unsigned tail = load_acquire(cq_tail);
+        if (head == tail) {
+            if (submit(1) < 0) return false;
+            continue;
+        }
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes[head & cq_mask];
+            if (cqe.user_data == CANCEL_USER_DATA) {
+                cancel_done = true;
+                continue;
+            }
+            // A frame that arrived meanwhile is dropped
+            if (cqe.flags & IORING_CQE_F_BUFFER) recycle((uint16_t)(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+            if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                rx_done = true;
+                rx_res = cqe.res;
+            }
+        }
+        store_release(cq_head, head);
+    }
+    rx_armed = false;
+    if (rx_res < 0 && rx_res != -ECANCELED) {
+        errno = -rx_res;
+        return false;
+    }
+    return true;
+}
+
+void CanUring::teardown() {
+    if (sqes) munmap(sqes, sqes_size);
+    if (cq_ring && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+    if (sq_ring) munmap(sq_ring, sq_ring_size);
+    // Closing the ring cancels the receive before its buffers go away
+    if (ring_fd >= 0) close(ring_fd);
+    if (buf_ring) munmap(buf_ring, buf_ring_size);
+    sqes = nullptr;
+    sq_ring = cq_ring = nullptr;
+    buf_ring = nullptr;
+    ring_fd = -1;
+}
+
+io_uring_sqe *CanUring::get_sqe() {
+    // The SQ has room for every TX slot plus the receive; only a failed
+    // submit can leave it full
+    if (sq_local_tail - load_acquire(sq_head) >= SQ_ENTRIES) return nullptr;
+    unsigned idx = sq_local_tail & sq_mask;
+    io_uring_sqe *sqe = &sqes[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array[idx] = idx;
+    sq_local_tail++;
+    return sqe;
+}
+
+void CanUring::recycle(uint16_t bid) {
+    // Entries start at the ring itself (the tail overlays the first one's
+    // reserved field); the header's flexible array member is offset in C++
+    io_uring_buf &b = reinterpret_cast<io_uring_buf *>(buf_ring)[buf_tail & (RX_BUFFERS - 1)];
+    b.addr = (uint64_t)(uintptr_t)rx_buffers[bid];
+    b.len = RX_BUFFER_SIZE;
+    b.bid = bid;
+    buf_tail++;
+    store_release(&buf_ring->tail, buf_tail);
+}
+
+void CanUring::arm_rx() {
+    io_uring_sqe *sqe = get_sqe();
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = 0; // registered index
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->addr = (uint64_t)(uintptr_t)&rx_msg;
+    sqe->len = 1;
+    sqe->buf_group = RX_GROUP;
+    sqe->user_data = RX_USER_DATA;
+    rx_armed = true;
+    // Armed from the receiving thread, which then runs its completions
+    submit();
+}
+
+bool CanUring::stage_tx(const can_frame &frame, uint8_t tag, bool retry) {
+    if (ring_fd < 0 || free_count == 0 || tag >= TAGS) return false;
+    io_uring_sqe *sqe = get_sqe();
+    if (!sqe) return false;
+    uint16_t slot = free_slots[--free_count];
+    tx_slots[slot] = frame;
+    tx_tag[slot] = tag;
+    tx_retry[slot] = retry;
+    tag_in_flight[tag]++;
+
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = 0;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->addr = (uint64_t)(uintptr_t)&tx_slots[slot];
+    sqe->len = sizeof(can_frame);
+    sqe->off = 0;           // sockets reject any other position
+    sqe->rw_flags = RWF_NOWAIT; // a full queue completes with EAGAIN/ENOBUFS instead of parking
+    sqe->buf_index = 0;
+    sqe->user_data = slot;
+    return true;
+}
+
+int CanUring::submit(unsigned wait_nr) {
+    if (ring_fd < 0) return -1;
+    store_release(sq_tail, sq_local_tail);
+    sq_submitted = sq_local_tail;
+    unsigned pending = sq_local_tail - load_acquire(sq_head);
+    if (pending == 0 && wait_nr == 0) return 0;
+    enters.fetch_add(1, std::memory_order_relaxed);
+    return sys_enter(ring_fd, pending, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0);
+}
+
+void CanUring::wait() {
+    if (ring_fd < 0) return;
+    enters.fetch_add(1, std::memory_order_relaxed);
+    sys_enter(ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+}
+
+void CanUring::check_overflow() {
+    // Completions the CQ had no room for wait in the kernel until flushed
+    if (load_acquire(sq_flags) & IORING_SQ_CQ_OVERFLOW) {
+        enters.fetch_add(1, std::memory_order_relaxed);
+        sys_enter(ring_fd, 0, 0, IORING_ENTER_GETEVENTS);
+    }
+}
+
+void CanUring::complete_tx(const io_uring_cqe &cqe) {
+    uint16_t slot = (uint16_t)cqe.user_data;
+    uint8_t tag = tx_tag[slot];
+    tag_in_flight[tag]--;
+    if (cqe.res == (int)sizeof(can_frame)) {
+        tx_done++;
+    } else if (failed_count < TX_SLOTS) {
+        Failed &f = failed[(failed_head + failed_count++) % TX_SLOTS];
+        f.frame = tx_slots[slot];
+        f.tag = tag;
+        f.retry = tx_retry[slot];
+        f.err = cqe.res < 0 ? -cqe.res : EIO;
+    }
+    free_slots[free_count++] = slot;
+}
+
+bool CanUring::next_rx(can_frame &frame, int &msg_flags) {
+    if (ring_fd < 0) return false;
+    if (!rx_armed) arm_rx();
+    check_overflow();
+
+    unsigned head = *cq_head;
+    unsigned tail = load_acquire(cq_tail);
+    bool got = false;
+    while (head != tail && !got) {
+        const io_uring_cqe &cqe = cqes[head & cq_mask];
+        head++;
+        if (cqe.user_data != RX_USER_DATA) {
+            complete_tx(cqe);
+            continue;
+        }
+        // The multishot receive ends on errors (e.g. no buffer left); re-armed
+        // once this completion is consumed
+        if (!(cqe.flags & IORING_CQE_F_MORE)) rx_armed = false;
+        if (cqe.res < 0 || !(cqe.flags & IORING_CQE_F_BUFFER)) continue;
+        uint16_t bid = (uint16_t)(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        const uint8_t *buf = rx_buffers[bid];
+        io_uring_recvmsg_out out;
+        std::memcpy(&out, buf, sizeof(out));
+        if (out.payloadlen >= sizeof(can_frame)) {
+            std::memcpy(&frame, buf + sizeof(out) + out.namelen + out.controllen, sizeof(can_frame));
+            msg_flags = (int)out.flags;
+            got = true;
+        }
+        recycle(bid);
+    }
+    store_release(cq_head, head);
+    if (!rx_armed && !got) arm_rx();
+    return got;
+}
+
+void CanUring::reap_tx() {
+    if (ring_fd < 0) return;
+    check_overflow();
+    unsigned head = *cq_head;
+    unsigned tail = load_acquire(cq_tail);
+    for (; head != tail && cqes[head & cq_mask].user_data != RX_USER_DATA; ++head) complete_tx(cqes[head & cq_mask]);
+    store_release(cq_head, head);
+}
+
+bool CanUring::pop_failed(can_frame &frame, uint8_t &tag, bool &retry, int &err) {
+    if (failed_count == 0) return false;
+    const Failed &f = failed[failed_head];
+    frame = f.frame;
+    tag = f.tag;
+    retry = f.retry;
+    err = f.err;
+    failed_head = (failed_head + 1) % TX_SLOTS;
+    failed_count--;
+    return true;
+}
+
+#else // !CAN_HAVE_IO_URING
+
+CanUring::CanUring(int) {
+    std::cerr << "[CanUring] Built without io_uring support (kernel headers < 6.0)\n";
+}
+CanUring::~CanUring() {}
+bool CanUring::stage_tx(const can_frame &, uint8_t, bool) { return false; }
+int CanUring::submit(unsigned) { return -1; }
+void CanUring::wait() {}
+bool CanUring::next_rx(can_frame &, int &) { return false; }
+void CanUring::reap_tx() {}
+bool CanUring::pop_failed(can_frame &, uint8_t &, bool &, int &) { return false; }
+
+#endif // CAN_HAVE_IO_URING
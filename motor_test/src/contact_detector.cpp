@@ -0,0 +1,83 @@
+#include "contact_detector.hpp"
+#include <algorithm>
+#include <cmath>
+
+ContactDetector::ContactDetector(size_t joints, size_t window, float k_sigma,
+                                 float min_step, float max_slope, float settle_s)
+    : joints(std::min(joints, MAX_JOINTS)),
+      window(std::max<size_t>(2, std::min(window, MAX_WINDOW))),
+      k_sigma(k_sigma), min_step(min_step), max_slope(max_slope), settle_s(settle_s) {
+    for (size_t j = 0; j < this->joints; ++j) settle[j] = settle_s;
+}
+
+uint32_t ContactDetector::update(const float *current, float dt, uint32_t armed) {
+    const float inv_dt = dt > 0.0f ? 1.0f / dt : 0.0f;
+
+    for (size_t j = 0; j < joints; ++j) {
+        float x = std::fabs(current[j]);
+        // Until the window is full the stats cover the samples seen so far
+        float inv_n = filled[j] > 0 ? 1.0f / (float)filled[j] : 0.0f;
+        float mean = sum[j] * inv_n;
+        float var = std::max(0.0f, sum_sq[j] * inv_n - mean * mean);
+        float threshold = std::max(k_sigma * std::sqrt(var), min_step);
+        float d = (x - prev[j]) * inv_dt;
+
+        // Settling, disarmed or latched: neither detect nor move the baseline
+        uint8_t live = ((armed >> j) & 1u) & (settle[j] <= 0.0f) & (contact[j] ^ 1);
+        settle[j] = std::max(0.0f, settle[j] - dt);
+        uint8_t hit = live & (filled[j] >= 2) & ((x - mean > threshold) | (d > max_slope));
+        entered[j] = hit;
+        contact[j] |= hit;
+        slope[j] = d;
+        prev[j] = x;
+
+        uint8_t feed = live & (hit ^ 1);
+        float &slot = ring[head[j]][j];
+        float in = feed ? x : slot;
+        sum[j] += in - slot;
+        sum_sq[j] += in * in - slot * slot;
+        slot = in;
+        head[j] += feed;
+        filled[j] += feed & (filled[j] < window);
+        if (head[j] >= window) {
+            head[j] = 0;
+            recompute(j);
+        }
+    }
+
+    uint32_t mask = 0;
+    for (size_t j = 0; j < joints; ++j) mask |= (uint32_t)entered[j] << j;
+    return mask;
+}
+
+void ContactDetector::recompute(size_t joint) {
+    sum[joint] = 0.0f;
+    sum_sq[joint] = 0.0f;
+    for (size_t k = 0; k < window; ++k) {
+        sum[joint] += ring[k][joint];
+        sum_sq[joint] += ring[k][joint] * ring[k][joint];
+    }
+}
+
+void ContactDetector::reset(size_t joint) {
+    if (joint >= joints) return;
+    // The baseline of the last move says nothing about this one: start empty
+    for (size_t k = 0; k < window; ++k) ring[k][joint] = 0.0f;
+    sum[joint] = 0.0f;
+    sum_sq[joint] = 0.0f;
+    head[joint] = 0;
+    filled[joint] = 0;
+    slope[joint] = 0.0f;
+    settle[joint] = settle_s;
+    contact[joint] = 0;
+}
+
+float ContactDetector::get_mean(size_t joint) const {
+    return filled[joint] > 0 ? sum[joint] / (float)filled[joint] : 0.0f;
+}
+
+float ContactDetector::get_stddev(size_t joint) const {
+    if (filled[joint] == 0) return 0.0f;
+    float mean = get_mean(joint);
+    return std::sqrt(std::max(0.0f, sum_sq[joint] / (float)filled[joint] - mean * mean));
+}
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "motor_control.hpp"
+#include "sim_motor.hpp"
+#include "control_loop.hpp"
+#include "loopback_bus.hpp"
+#include "trace.hpp"
+#include "rt_check.hpp"
+
+// Step responses of the host-side control laws on the simulated RMD drive, in
+// virtual time at 1 kHz. Each tick is a real ControlLoop::tick() on a
+// LoopbackBus: decode the reply of the previous tick (1 deg angle), compute,
+// encode with the real driver; SimRMDMotor answers in-process and moves when
+// the bus clock advances. The shaft carries a constant load, so only laws with
+// an integrator reach the target in current mode. "tick" is the CPU time of
+// one tick, no syscalls involved.
+// With a trace file (and -DMOTOR_TRACE=ON) the stages of every tick are
+// written as a Chrome trace. Built with -DMOTOR_RT_CHECK=ON, every tick
+// after the first is checked for allocations and blocking calls.
+//   ./control_bench [step_deg] [trace.json]
+constexpr double DT = 0.001;
+constexpr auto TICK = std::chrono::microseconds(1000);
+constexpr double STEP_AT = 0.1;      // estimator settles on the initial angle first
+constexpr double DURATION = 1.6;
+constexpr float SETTLE_BAND = 1.0f;  // deg, the reply resolution
+constexpr float LOAD_A = 0.5f;       // holding current of the load
+
+struct StepResult {
+    float rise_ms = NAN;     // 10% -> 90%
+    float overshoot = 0.0f;  // percent of the step
+    float settle_ms = NAN;   // last entry into +-SETTLE_BAND
+    float final_err = 0.0f;  // mean |error| over the last 200 ms
+    float peak_cmd = 0.0f;
+    double tick_ns = 0.0;
+};
+
+StepResult run_step(ControlLoop::Mode mode, unsigned divider, float step_deg,
+                    const JointController::Gains &outer, const JointController::Gains *inner) {
+    SimRMDMotor sim(0x141);
+    sim.set_load(LOAD_A);
+    LoopbackBus bus;
+    bus.attach(&sim);
+    RMD_Motor driver(0x141, &bus, "RMD_Sim");
+    ControlLoop loop(&bus, mode, divider);
+    loop.add_motor(&driver);
+    loop.position_law().set_gains(outer);
+    if (inner) loop.velocity_law().set_gains(*inner);
+
+    StepResult r;
+    double t10 = NAN, t90 = NAN, last_out = STEP_AT, err_sum = 0.0;
+    float peak = 0.0f;
+    int err_n = 0;
+    std::chrono::nanoseconds tick_time{0};
+    int ticks = (int)(DURATION / DT);
+
+    for (int k = 0; k < ticks; ++k) {
+        RT_SECTION();
+        if (k == 1) rt_check_arm(true);
+        double t = k * DT;
+        if (k == (int)(STEP_AT / DT)) loop.set_reference(0, step_deg);
+
+        auto c0 = std::chrono::steady_clock::now();
+        loop.tick(t, (float)DT);
+        tick_time += std::chrono::steady_clock::now() - c0;
+        float cmd = loop.get_command(0);
+        bus.advance(TICK);
+
+        if (t < STEP_AT) continue;
+        r.peak_cmd = std::max(r.peak_cmd, std::abs(cmd));
+        float pos = sim.get_pos();
+        if (std::isnan(t10) && pos >= 0.1f * step_deg) t10 = t;
+        if (std::isnan(t90) && pos >= 0.9f * step_deg) t90 = t;
+        peak = std::max(peak, pos);
+        if (std::abs(pos - step_deg) > SETTLE_BAND) last_out = t + DT;
+        if (t >= DURATION - 0.2) {
+            err_sum += std::abs(pos - step_deg);
+            err_n++;
+        }
+    }
+
+    rt_check_arm(false);
+
+    if (!std::isnan(t90)) r.rise_ms = (float)((t90 - t10) * 1000.0);
+    r.overshoot = std::max(0.0f, (peak - step_deg) / step_deg * 100.0f);
+    if (last_out < DURATION - 0.2) r.settle_ms = (float)((last_out - STEP_AT) * 1000.0);
+    r.final_err = (float)(err_sum / err_n);
+    r.tick_ns = (double)tick_time.count() / ticks;
+    return r;
+}
+
+void report(const char *name, const StepResult &r, const char *unit) {
+    std::cout << "[control_bench] " << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(1) << " rise " << std::setw(6) << r.rise_ms << " ms"
+              << "  overshoot " << std::setw(5) << r.overshoot << " %"
+              << "  settle " << std::setw(6) << r.settle_ms << " ms"
+              << "  final err " << std::setprecision(2) << std::setw(5) << r.final_err << " deg"
+              << "  peak " << std::setprecision(1) << std::setw(6) << r.peak_cmd << " " << unit
+              << "  tick " << std::setprecision(0) << std::setw(4) << r.tick_ns << " ns" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    float step = argc > 1 ? std::strtof(argv[1], nullptr) : 30.0f;
+    if (step <= 0.0f) return 1;
+    TRACE_THREAD_NAME("control_bench");
+    std::cout << "[control_bench] " << step << " deg step, 1 kHz, 1 deg feedback, "
+              << LOAD_A << " A load" << std::endl;
+
+    // Current mode plant: 2000 dps^2 per amp with a 0.1 s damping time constant.
+    // Gains kept low enough that the 1 deg feedback does not limit-cycle; 5 A limit.
+    JointController::Gains pid;
+    pid.kp = 0.6f;
+    pid.ki = 1.0f;
+    pid.kd = 0.025f;
+    pid.out_limit = 5.0f;
+    report("PID -> current", run_step(ControlLoop::Mode::PositionToCurrent, 1, step, pid, nullptr), "A");
+
+    JointController::Gains windup = pid;
+    windup.anti_windup = false;
+    report("PID -> current, no anti-wu", run_step(ControlLoop::Mode::PositionToCurrent, 1, step, windup, nullptr), "A");
+
+    JointController::Gains impedance = pid;
+    impedance.law = JointController::Law::Impedance;
+    impedance.kp = 0.6f;   // stiffness, A/deg
+    impedance.kd = 0.025f; // damping, A/dps
+    report("impedance -> current", run_step(ControlLoop::Mode::PositionToCurrent, 1, step, impedance, nullptr), "A");
+
+    // Same spring with the load fed forward instead of integrated
+    impedance.bias = LOAD_A;
+    report("impedance + load ff", run_step(ControlLoop::Mode::PositionToCurrent, 1, step, impedance, nullptr), "A");
+
+    // Drive speed loop underneath: P on position with velocity feedforward
+    JointController::Gains pos_vel;
+    pos_vel.kp = 25.0f;      // dps per deg
+    pos_vel.kff_vel = 1.0f;
+    pos_vel.out_limit = 360.0f;
+    report("P -> velocity", run_step(ControlLoop::Mode::PositionToVelocity, 1, step, pos_vel, nullptr), "dps");
+
+    // Cascade: position at 250 Hz -> velocity PI at 1 kHz -> current
+    JointController::Gains vel_pi;
+    vel_pi.kp = 0.02f;       // A per dps
+    vel_pi.ki = 0.5f;
+    vel_pi.kff_vel = 1.0f / 2000.0f; // inertia: A per dps^2
+    vel_pi.out_limit = 5.0f;
+    report("cascade 250 Hz / 1 kHz", run_step(ControlLoop::Mode::Cascade, 4, step, pos_vel, &vel_pi), "A");
+
+    if (argc > 2) trace_dump(argv[2]);
+    return rt_check_report() == 0 ? 0 : 2;
+}
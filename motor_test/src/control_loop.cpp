@@ -0,0 +1,138 @@
+#include "control_loop.hpp"
+#include "trace.hpp"
+#include "rt_check.hpp"
+#include <algorithm>
+#include <iostream>
+
+ControlLoop::ControlLoop(CanTransport *bus, Mode mode, unsigned outer_divider)
+    : bus(bus), mode(mode), outer_divider(std::max(1u, outer_divider)) {}
+
+int ControlLoop::add_motor(MotorControl *motor) {
+    uint8_t probe[8];
+    bool ok = (mode == Mode::PositionToVelocity) ? motor->encode_velocity(0.0f, probe)
+                                                 : motor->encode_current(0.0f, probe);
+    if (count >= MAX_MOTORS || !ok) {
+        std::cerr << "[ControlLoop] Cannot stream "
+                  << (mode == Mode::PositionToVelocity ? "speed" : "current") << " to " << motor->get_name() << "\n";
+        return -1;
+    }
+    // The estimator needs the angle from somewhere
+    if (!motor->command_reply_has_position() && !motor->encode_position_request(probe)) {
+        std::cerr << "[ControlLoop] Cannot read the position of " << motor->get_name() << "\n";
+        return -1;
+    }
+    motors[count] = motor;
+    return (int)count++;
+}
+
+void ControlLoop::set_reference(size_t index, float pos_deg, float vel_dps, float acc_dps2) {
+    if (index >= count) return;
+    std::lock_guard<std::mutex> lock(reference_write_mutex);
+    references[index].store({pos_deg, vel_dps, acc_dps2});
+}
+
+void ControlLoop::feed(size_t index, float pos_deg, double t) {
+    if (index < count) estimator.update(index, pos_deg, t);
+}
+
+void ControlLoop::compute(double t, float dt, float *out) {
+    TRACE_SPAN("control", "compute");
+    {
+        TRACE_SPAN("control", "estimator");
+        estimator.predict(t, est_pos.data(), est_vel.data());
+    }
+
+    for (size_t j = 0; j < count; ++j) {
+        // New reference, unless it is being written right now
+        uint32_t v = references[j].version();
+        if (v != reference_version[j] && references[j].try_load(active[j])) reference_version[j] = v;
+        // No position: hold the joint where it is when that becomes known
+        if (std::isnan(active[j].pos) && !std::isnan(est_pos[j])) {
+            active[j].pos = est_pos[j];
+            active[j].vel = active[j].acc = 0.0f;
+        }
+        ref_pos[j] = active[j].pos;
+        ref_vel[j] = active[j].vel;
+        ref_acc[j] = active[j].acc;
+    }
+
+    // Outer position law at 1/outer_divider of the tick rate, output held in between
+    if (outer_phase == 0) {
+        TRACE_SPAN("control", "position law");
+        position.update(dt * outer_divider, ref_pos.data(), ref_vel.data(), ref_acc.data(),
+                        est_pos.data(), est_vel.data(), outer_out.data());
+    }
+    outer_phase = (outer_phase + 1) % outer_divider;
+
+    if (mode == Mode::Cascade) {
+        // Velocity law: reference from the outer loop, its kff_vel scales the reference acceleration
+        TRACE_SPAN("control", "velocity law");
+        std::copy(outer_out.begin(), outer_out.begin() + count, inner_ref.begin());
+        velocity.update(dt, inner_ref.data(), ref_acc.data(), nullptr, est_vel.data(), nullptr, inner_out.data());
+        std::copy(inner_out.begin(), inner_out.begin() + count, out);
+    } else {
+        std::copy(outer_out.begin(), outer_out.begin() + count, out);
+    }
+}
+
+size_t ControlLoop::tick() {
+    auto now = std::chrono::steady_clock::now();
+    if (!started) {
+        epoch = last_tick = now;
+        started = true;
+    }
+    double t = std::chrono::duration<double>(now - epoch).count();
+    float dt = std::chrono::duration<float>(now - last_tick).count();
+    last_tick = now;
+    return tick(t, dt);
+}
+
+size_t ControlLoop::tick(double t, float dt) {
+    RT_SECTION();
+    TRACE_SPAN("control", "tick");
+
+    // Replies of the previous tick carry the angle the estimator needs
+    uint32_t rid;
+    uint8_t data[8];
+    uint8_t len;
+    while (bus->poll_msg(rid, data, len)) {
+        TRACE_SPAN("motor", "decode");
+        for (size_t i = 0; i < count; ++i) {
+            if (!motors[i]->decode_reply(rid, data, len)) continue;
+            // Only the answer to the latest command times the round trip;
+            // after a missed reply, the next one may be the late one
+            if (unanswered[i] == 1) estimator.observe_round_trip(i, t - sent_at[i]);
+            if (unanswered[i] > 0) unanswered[i]--;
+            if (motors[i]->reply_has_position(data, len)) estimator.update(i, motors[i]->get_state().pos, t);
+            break;
+        }
+    }
+
+    compute(t, dt, command.data());
+
+    bus->begin_batch();
+    size_t sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bool ok = (mode == Mode::PositionToVelocity) ? motors[i]->velocity_write(command[i] / 6.0f)
+                                                     : motors[i]->current_write(command[i]);
+        if (!ok) continue;
+        sent++;
+        sent_at[i] = t;
+        if (unanswered[i] < UINT8_MAX) unanswered[i]++;
+        // Its reply has no angle: read it along (answered after the command)
+        if (!motors[i]->command_reply_has_position()) motors[i]->position_request();
+    }
+    bus->flush();
+    return sent;
+}
+
+void ControlLoop::stop() {
+    for (size_t i = 0; i < count; ++i) {
+        command[i] = 0.0f;
+        if (mode == Mode::PositionToVelocity) motors[i]->velocity_write(0.0f);
+        else motors[i]->current_write(0.0f);
+    }
+    position.reset();
+    velocity.reset();
+    outer_phase = 0;
+}
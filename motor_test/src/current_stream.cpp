@@ -0,0 +1,44 @@
+#include "current_stream.hpp"
+#include "rt_check.hpp"
+#include <iostream>
+
+CurrentStream::CurrentStream(CanTransport *bus) : bus(bus) {}
+
+int CurrentStream::add_motor(MotorControl *motor) {
+    uint8_t probe[8];
+    if (count >= MAX_MOTORS || !motor->encode_current(0.0f, probe)) {
+        std::cerr << "[CurrentStream] Cannot stream current to " << motor->get_name() << "\n";
+        return -1;
+    }
+    motors[count] = motor;
+    targets[count] = 0.0f;
+    return (int)count++;
+}
+
+void CurrentStream::set_target(size_t index, float amps) {
+    if (index < count) targets[index] = amps;
+}
+
+void CurrentStream::set_targets(const float *amps, size_t n) {
+    for (size_t i = 0; i < n && i < count; ++i) targets[i] = amps[i];
+}
+
+size_t CurrentStream::tick() {
+    RT_SECTION();
+    // Replies of the previous tick; each motor recognises its own
+    drain_replies(bus, motors.data(), count);
+
+    // One submission for the whole tick on the io_uring backend
+    bus->begin_batch();
+    size_t sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (motors[i]->current_write(targets[i])) sent++;
+    }
+    bus->flush();
+    return sent;
+}
+
+void CurrentStream::stop() {
+    targets.fill(0.0f);
+    tick();
+}
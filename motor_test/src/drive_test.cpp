@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include "contact_detector.hpp"
+#include "control_loop.hpp"
+#include "fault_monitor.hpp"
+#include "loopback_bus.hpp"
+#include "motion_queue.hpp"
+#include "motor_control.hpp"
+#include "sim_motor.hpp"
+#include "test_check.hpp"
+#include "thermal_model.hpp"
+#include "trajectory.hpp"
+
+// Host-side logic of the single drives, and their fault monitoring, on simulated motors
+
+// The move loops sample every 50 ms; with the reply that late on the virtual
+// clock, each tick of move_and_monitor() moves the drive exactly one sample
+constexpr auto SAMPLE = std::chrono::milliseconds(50);
+constexpr auto TICK = std::chrono::microseconds(2000);
+
+static void test_contact_detector() {
+    ContactDetector det(2);
+
+    // Accelerating: the current is high for the settle time, then drops to friction
+    const float move[] = {0.0f, 2.0f, 2.0f, 0.2f, 0.2f, 0.25f, 0.2f, 0.2f};
+    for (float a : move) {
+        float cur[2] = {a, a};
+        CHECK(det.update(cur, 0.05f) == 0);
+    }
+    CHECK_NEAR(det.get_mean(0), 0.21, 0.01);
+
+    // A stall on joint 1 only; a disarmed joint does not see its spike
+    float stall[2] = {0.2f, 4.0f};
+    CHECK(det.update(stall, 0.05f, 0x1) == 0);
+    CHECK(det.update(stall, 0.05f) == 0x2);
+    CHECK(det.in_contact(1) && !det.in_contact(0));
+
+    // reset() drops the old baseline: the next move's acceleration is no contact
+    det.reset(1);
+    CHECK(!det.in_contact(1) && det.get_mean(1) == 0.0f);
+    for (float a : move) {
+        float cur[2] = {0.2f, a};
+        CHECK(det.update(cur, 0.05f) == 0);
+    }
+}
+
+static void test_move_contact() {
+    LoopbackBus bus(SAMPLE);
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    ContactDetector contact(1);
+    rmd.set_contact_detector(&contact);
+
+    // Obstacle-free moves from standstill, re-armed between moves like main.cpp
+    contact.reset(0);
+    rmd.move_and_monitor(90.0f, 60.0f);
+    CHECK(!contact.in_contact(0));
+    CHECK_NEAR(sim.get_pos(), 90.0, 0.01);
+    contact.reset(0);
+    rmd.move_and_monitor(180.0f, 60.0f);
+    CHECK(!contact.in_contact(0));
+    CHECK_NEAR(sim.get_pos(), 180.0, 0.01);
+
+    // Closing on an object: holds where it stalled instead of pushing on
+    sim.set_obstacle(260.0f);
+    contact.reset(0);
+    rmd.move_and_monitor(330.0f, 60.0f);
+    CHECK(contact.in_contact(0));
+    CHECK(sim.is_blocked());
+    CHECK_NEAR(sim.get_target(), 260.0, 1.0);
+}
+
+// Streams setpoints like the gateway's CAN tick; returns the highest angle passed
+static float stream_lktech(LoopbackBus &bus, SimLKtechMotor &sim, LKtech_Motor &lk, float target, int ticks) {
+    MotorControl *motors[1] = {&lk};
+    float peak = sim.get_pos();
+    for (int k = 0; k < ticks; ++k) {
+        drain_replies(&bus, motors, 1);
+        lk.setpoint_write(target, 30.0f);
+        bus.advance(TICK);
+        peak = std::max(peak, sim.get_pos());
+    }
+    drain_replies(&bus, motors, 1);
+    return peak;
+}
+
+static void test_lktech_direction() {
+    LoopbackBus bus;
+    SimLKtechMotor sim(0x142);
+    bus.attach(&sim);
+    LKtech_Motor lk(0x142, &bus, "LK_Sim");
+
+    // No angle yet: only the read goes out, its reply brings the angle
+    CHECK(!lk.setpoint_write(90.0f, 30.0f));
+    CHECK(bus.get_tx_count() == 1);
+    MotorControl *motors[1] = {&lk};
+    drain_replies(&bus, motors, 1);
+    CHECK_NEAR(lk.get_state().pos, 0.0, 0.01);
+
+    stream_lktech(bus, sim, lk, 90.0f, 400);
+    CHECK_NEAR(sim.get_pos(), 90.0, 0.01);
+    CHECK_NEAR(lk.get_state().pos, 90.0, 0.01);
+
+    // Down: spins backwards instead of the long way round through 360
+    float peak = stream_lktech(bus, sim, lk, 30.0f, 400);
+    CHECK(peak <= 90.01f);
+    CHECK_NEAR(sim.get_pos(), 30.0, 0.01);
+    CHECK_NEAR(lk.get_state().pos, 30.0, 0.01);
+}
+
+// Finger curl through via points and back open, as in gesture_bench
+const float GESTURE[] = {40.0f, 80.0f, 90.0f, 45.0f, 0.0f};
+constexpr float GESTURE_DPS = 360.0f;
+constexpr float GESTURE_ACCEL = 3600.0f;  // same as the simulated drive
+
+struct GestureRun {
+    float seconds = 0.0f;
+    float peak = 0.0f;  // highest setpoint sent
+};
+
+// Streams one gesture to the simulated drive at the control rate, in virtual
+// time; with no queue, one setpoint per waypoint held until the drive is there
+static GestureRun run_gesture(MotionQueue *queue) {
+    LoopbackBus bus;
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    MotorControl *motors[1] = {&rmd};
+    GestureRun run;
+    size_t w = 0;
+    if (queue) {
+        queue->reset(0, sim.get_pos());
+        for (float target : GESTURE) queue->push(0, target, GESTURE_DPS);
+    }
+    for (int k = 0; k < 5000; ++k) {
+        float setpoint = GESTURE[w];
+        if (queue) queue->step(TICK.count() * 1e-6f, &setpoint);
+        drain_replies(&bus, motors, 1);
+        rmd.setpoint_write(setpoint, GESTURE_DPS / 6.0f);
+        bus.advance(TICK);
+        run.seconds += TICK.count() * 1e-6f;
+        run.peak = std::max(run.peak, setpoint);
+
+        // The queue's goal is the last waypoint; stop-and-go takes them one by one
+        size_t goal = queue ? std::size(GESTURE) - 1 : w;
+        bool there = std::abs(sim.get_pos() - GESTURE[goal]) < 0.5f && std::abs(sim.get_vel()) < 1.0f;
+        if (there && goal + 1 == std::size(GESTURE) && (!queue || queue->idle())) break;
+        if (there && !queue) w++;
+    }
+    return run;
+}
+
+static void test_motion_queue_timing() {
+    GestureRun stop_and_go = run_gesture(nullptr);
+    MotionQueue queue(1, GESTURE_ACCEL);
+    queue.set_lookahead(false);
+    GestureRun at_rest = run_gesture(&queue);
+    queue.set_lookahead(true);
+    GestureRun lookahead = run_gesture(&queue);
+    queue.set_blend_radius(5.0f);
+    GestureRun blend = run_gesture(&queue);
+
+    // Stopping at every waypoint costs the same with or without the queue;
+    // look-ahead keeps the speed through 40 and 80, the blend turns before 90
+    CHECK(stop_and_go.seconds < 1.0f);
+    CHECK_NEAR(at_rest.seconds, stop_and_go.seconds, 0.1 * stop_and_go.seconds);
+    CHECK(lookahead.seconds < 0.85f * stop_and_go.seconds);
+    CHECK(blend.seconds < lookahead.seconds);
+    CHECK_NEAR(lookahead.peak, 90.0, 0.01);
+    CHECK_NEAR(blend.peak, 85.0, 0.01);
+}
+
+static void test_trajectory_queue() {
+    LoopbackBus bus;
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    MotorControl *motors[1] = {&rmd};
+
+    // Three waypoints at once: the queue runs them as one profile
+    std::vector<Waypoint> waypoints(3);
+    waypoints[0] = {0.0f, 0, 20.0f, 60.0f, 1.0f};
+    waypoints[1] = {0.0f, 0, 40.0f, 60.0f, 1.0f};
+    waypoints[2] = {0.0f, 0, 10.0f, 60.0f, 1.0f};
+    std::vector<TrajectoryStep> steps = compile_trajectory(waypoints, TICK);
+    TrajectoryRunner runner(&bus, motors, 1);
+    MotionQueue queue(1, GESTURE_ACCEL, 2.0f);
+    runner.set_motion_queue(&queue);
+
+    // The drives move with the wall clock the runner ticks on
+    std::atomic<bool> running{true};
+    std::thread clock([&] {
+        while (running.load()) {
+            bus.advance(TICK);
+            std::this_thread::sleep_for(TICK);
+        }
+    });
+    CHECK(runner.run(steps, TICK, std::chrono::milliseconds(1000)));
+    running = false;
+    clock.join();
+
+    CHECK(queue.idle());
+    CHECK_NEAR(sim.get_pos(), 10.0, 1.5);
+    CHECK(runner.get_stats().moves == 3);
+    CHECK(runner.get_stats().error_samples > 0);
+}
+
+static void test_control_round_trip() {
+    // Replies 1 ms after each command, decoded at the next 2 ms tick
+    LoopbackBus bus(std::chrono::microseconds(1000));
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    ControlLoop loop(&bus, ControlLoop::Mode::PositionToCurrent);
+    CHECK(loop.add_motor(&rmd) == 0);
+    loop.set_reference(0, 10.0f);
+
+    CHECK(loop.get_estimator().get_latency(0) == 0.0);
+    for (int k = 0; k < 50; ++k) {
+        loop.tick(k * 0.002, 0.002f);
+        bus.advance(TICK);
+    }
+    // Half the command-to-decode time
+    CHECK_NEAR(loop.get_estimator().get_latency(0), 0.001, 1e-6);
+}
+
+static void test_control_lktech() {
+    LoopbackBus bus;
+    SimLKtechMotor sim(0x142);
+    bus.attach(&sim);
+    LKtech_Motor lk(0x142, &bus, "LK_Sim");
+    ControlLoop loop(&bus, ControlLoop::Mode::PositionToVelocity);
+    CHECK(loop.add_motor(&lk) == 0);
+    JointController::Gains gains;
+    gains.kp = 5.0f;
+    gains.out_limit = 180.0f;
+    loop.position_law().set_gains(gains);
+    loop.set_reference(0, 30.0f);
+
+    // Speed command plus a 0x94 read per tick; the reads feed the estimator
+    for (int k = 0; k < 1000; ++k) {
+        CHECK(loop.tick(k * 0.002, 0.002f) == 1);
+        bus.advance(TICK);
+    }
+    CHECK(bus.get_tx_count() == 2000);
+    CHECK_NEAR(sim.get_pos(), 30.0, 0.5);
+    std::array<float, ControlLoop::MAX_MOTORS> pos, vel;
+    loop.get_estimator().predict(2.0, pos.data(), vel.data());
+    CHECK_NEAR(pos[0], 30.0, 0.5);
+}
+
+static void test_thermal_model() {
+    // Defaults: 300 s time constant, 3 A continuous, 80 C limit, 10 s horizon
+    ThermalModel thermal(2);
+    const float none[2] = {NAN, NAN};
+    const float dt = 0.1f;
+    CHECK_NEAR(thermal.get_temp(0), 30.0, 1e-6);
+    CHECK_NEAR(thermal.time_to_limit(0, 5.0f), 300.0 * std::log(138.75 / 88.75), 0.5);
+    CHECK(thermal.time_to_limit(0, 2.0f) < 0.0f);
+
+    // Constant 5 A on joint 0 for 60 s: first-order rise towards 168.75 C
+    const float five[2] = {5.0f, 0.0f};
+    float cold_allowed = thermal.allowed_current(0);
+    float prev = thermal.get_temp(0);
+    bool rising = true;
+    for (int k = 0; k < 600; ++k) {
+        thermal.update(five, none, dt);
+        rising = rising && thermal.get_temp(0) > prev;
+        prev = thermal.get_temp(0);
+    }
+    CHECK(rising);
+    CHECK_NEAR(thermal.get_temp(0), 30.0 + 138.75 * (1.0 - std::exp(-0.2)), 0.1);
+    CHECK_NEAR(thermal.get_temp(1), 30.0, 1e-6);
+    CHECK(thermal.allowed_current(0) < cold_allowed);
+    CHECK_NEAR(thermal.allowed_current(1), cold_allowed, 1e-3);
+
+    // Asking for 10 A all along: full current while cold, then derated to the
+    // continuous rating so the winding settles at the limit, never above it
+    ThermalModel derated(1);
+    CHECK(derated.derate(0, 10.0f) == 10.0f);
+    float peak = 0.0f;
+    for (int k = 0; k < 6000; ++k) {
+        float amps = derated.derate(0, 10.0f);
+        derated.update_joint(0, amps, NAN, dt);
+        peak = std::max(peak, derated.get_temp(0));
+    }
+    CHECK(peak <= 80.0f);
+    CHECK_NEAR(derated.get_temp(0), 80.0, 1.0);
+    CHECK_NEAR(derated.allowed_current(0), 3.0, 0.1);
+    CHECK(derated.derate(0, -10.0f) == -derated.allowed_current(0));
+    CHECK(derated.time_to_limit(0, 10.0f) < 1.0f);
+
+    // Cooldown at zero current: one time constant takes 1 - 1/e of the excess
+    float hot = derated.get_temp(0);
+    for (int k = 0; k < 3000; ++k) derated.update_joint(0, 0.0f, NAN, dt);
+    CHECK_NEAR(derated.get_temp(0), 30.0 + (hot - 30.0) * std::exp(-1.0), 0.1);
+    CHECK(derated.allowed_current(0) > 10.0f);
+
+    // A measured temperature pulls the estimate over within a few seconds
+    for (int k = 0; k < 50; ++k) derated.update_joint(0, 0.0f, 40.0f, dt);
+    CHECK_NEAR(derated.get_temp(0), 40.0, 0.1);
+}
+
+static void test_fault_drive_error() {
+    // The RMD error flags come with the 0x9A status only, which has no angle
+    LoopbackBus loopback;
+    SimRMDMotor sim(0x141);
+    RMD_Motor rmd(0x141, &loopback, "RMD_Sim");
+    const uint8_t status[8] = {0x9A};
+    uint32_t rid;
+    uint8_t reply[8];
+    sim.set_error(0x1000);
+    CHECK(sim.handle_frame(0x141, status, 8, rid, reply));
+    CHECK(rmd.decode_reply(rid, reply, 8));
+    CHECK(rmd.get_state().err_msg == 0x1000);
+    CHECK(!rmd.reply_has_position(reply, 8));
+
+    // A FaultMonitor on one end of a socketpair; the other end is the bus,
+    // where an RMD and an LKtech drive answer its status reads
+    int fds[2];
+    CHECK(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds) == 0);
+    SimRMDMotor sim_rmd(0x141);
+    SimLKtechMotor sim_lk(0x142);
+    SimMotor *sims[2] = {&sim_rmd, &sim_lk};
+    std::atomic<uint16_t> lk_error{0};
+    std::atomic<int> stops{0};
+    std::atomic<bool> running{true};
+    std::thread wire([&] {
+        while (running.load()) {
+            struct can_frame frame {};
+            if (recv(fds[1], &frame, sizeof(frame), MSG_DONTWAIT) != (ssize_t)sizeof(frame)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            sim_lk.set_error(lk_error.load());
+            if (frame.data[0] == 0x80) stops++;
+            for (SimMotor *drive : sims) {
+                struct can_frame answer {};
+                if (!drive->handle_frame(frame.can_id, frame.data, frame.can_dlc, answer.can_id, answer.data)) continue;
+                answer.can_dlc = 8;
+                (void)!send(fds[1], &answer, sizeof(answer), 0);
+            }
+        }
+    });
+
+    FaultConfig cfg;
+    cfg.heartbeat = std::chrono::milliseconds(5);
+    cfg.error_poll = std::chrono::milliseconds(10);
+    cfg.feedback_timeout = std::chrono::milliseconds(500);
+    cfg.handle_signals = false;
+    FaultMonitor monitor(fds[0], cfg);
+    CHECK(monitor.add_motor({MotorProtocol::RMD, 0x141, true}) == 0);
+    CHECK(monitor.add_motor({MotorProtocol::LKtech, 0x142, true}) == 1);
+    CHECK(monitor.start());
+
+    // Healthy drives answer the reads and are left alone
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!monitor.is_tripped());
+    CHECK(monitor.get_heartbeat_count() >= 4);
+
+    // Over-temperature flag on the LKtech: both drives get their stop
+    lk_error = 0x08;
+    for (int k = 0; k < 200 && !monitor.is_tripped(); ++k) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    CHECK(monitor.is_tripped());
+    const FaultReport &report = monitor.get_report();
+    CHECK(report.fault == Fault::DriveError);
+    CHECK(report.motor == 1 && report.code == 0x08);
+    CHECK(report.stops_sent == 2);
+    for (int k = 0; k < 200 && stops.load() < 2; ++k) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(stops.load() == 2);
+
+    monitor.stop();
+    running = false;
+    wire.join();
+    close(fds[1]);
+}
+
+int main() {
+    test_contact_detector();
+    test_move_contact();
+    test_lktech_direction();
+    test_motion_queue_timing();
+    test_trajectory_queue();
+    test_control_round_trip();
+    test_control_lktech();
+    test_thermal_model();
+    test_fault_drive_error();
+    return test_result("drive_test");
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include "sim_motor.hpp"
+#include "motion_queue.hpp"
+#include "joint_estimator.hpp"
+
+// Position/velocity estimates at a 1 kHz control rate from sparse, quantized,
+// delayed feedback, in virtual time on the simulated drive:
+//   hold    : last sample, velocity by finite difference of samples
+//   kalman  : JointEstimator, receive time as measurement time
+//   kalman+ : JointEstimator with the one-way latency subtracted
+// Feedback is the RMD command reply angle (1 deg), polled every N ms and
+// delivered after the bus latency.
+//   ./estimator_bench [poll_ms] [latency_ms] [jerk_density]
+constexpr double DT = 0.001;
+constexpr float SPEED_DPS = 360.0f;
+constexpr float ACCEL_DPS2 = 3600.0f;
+const float GESTURE[] = {40.0f, 80.0f, 90.0f, 45.0f, 0.0f};
+
+struct Sample {
+    double rx_time;
+    float pos;
+};
+
+struct ErrorStats {
+    double pos_sq = 0.0, vel_sq = 0.0;
+    size_t n = 0;
+    void add(float pos_err, float vel_err) {
+        pos_sq += (double)pos_err * pos_err;
+        vel_sq += (double)vel_err * vel_err;
+        n++;
+    }
+    void print(const char *name) const {
+        std::cout << "[estimator_bench] " << name << ": position rms " << std::sqrt(pos_sq / n)
+                  << " deg, velocity rms " << std::sqrt(vel_sq / n) << " deg/s" << std::endl;
+    }
+};
+
+int main(int argc, char **argv) {
+    int poll_ms = argc > 1 ? std::atoi(argv[1]) : 10;
+    double latency = (argc > 2 ? std::atof(argv[2]) : 2.0) / 1000.0;
+    JointEstimator::Params params;
+    if (argc > 3) params.jerk_density = std::strtof(argv[3], nullptr);
+    if (poll_ms <= 0) return 1;
+
+    SimRMDMotor sim(0x141);
+    MotionQueue queue(1, ACCEL_DPS2, 5.0f);
+    queue.reset(0, 0.0f);
+
+    JointEstimator raw_kf(1, params), comp_kf(1, params);
+    comp_kf.observe_round_trip(0, 2.0 * latency);
+
+    std::deque<Sample> in_flight;
+    float hold_pos = NAN, hold_vel = 0.0f;
+    double hold_time = 0.0;
+    ErrorStats hold, kalman, kalman_comp;
+
+    const int ticks = 20000; // 20 s
+    for (int k = 0; k < ticks; ++k) {
+        double now = k * DT;
+        if (queue.idle()) {
+            for (float w : GESTURE) queue.push(0, w, SPEED_DPS);
+        }
+
+        // Drive: streamed setpoint, 1 kHz model step
+        float setpoint;
+        queue.step((float)DT, &setpoint);
+        uint8_t frame[8] = {0xA4, 0x01, 0, 0, 0, 0, 0, 0};
+        uint16_t speed = (uint16_t)SPEED_DPS;
+        int32_t p = (int32_t)std::lround(setpoint * 100.0f);
+        frame[2] = speed & 0xFF;
+        frame[3] = speed >> 8;
+        for (int i = 0; i < 4; ++i) frame[4 + i] = (uint8_t)(p >> (8 * i));
+        uint8_t reply[8];
+        uint32_t reply_id;
+        sim.handle_frame(0x141, frame, 8, reply_id, reply);
+        sim.step((float)DT);
+
+        // Sparse feedback: reply angle in whole degrees, arriving `latency` later
+        if (k % poll_ms == 0) in_flight.push_back({now + latency, std::round(sim.get_pos())});
+        while (!in_flight.empty() && in_flight.front().rx_time <= now + 1e-9) {
+            Sample s = in_flight.front();
+            in_flight.pop_front();
+            if (!std::isnan(hold_pos)) hold_vel = (float)((s.pos - hold_pos) / (s.rx_time - hold_time));
+            hold_pos = s.pos;
+            hold_time = s.rx_time;
+            raw_kf.update(0, s.pos, s.rx_time);
+            comp_kf.update(0, s.pos, s.rx_time);
+        }
+        if (std::isnan(hold_pos)) continue;
+
+        float true_pos = sim.get_pos(), true_vel = sim.get_vel();
+        float pos, vel;
+        hold.add(hold_pos - true_pos, hold_vel - true_vel);
+        raw_kf.predict(now, &pos, &vel);
+        kalman.add(pos - true_pos, vel - true_vel);
+        comp_kf.predict(now, &pos, &vel);
+        kalman_comp.add(pos - true_pos, vel - true_vel);
+    }
+
+    std::cout << "[estimator_bench] feedback every " << poll_ms << " ms, 1 deg resolution, "
+              << latency * 1000.0 << " ms latency" << std::endl;
+    hold.print("hold   ");
+    kalman.print("kalman ");
+    kalman_comp.print("kalman+");
+    return 0;
+}
@@ -0,0 +1,254 @@
+#include "fault_monitor.hpp"
+#include <iostream>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+static const uint8_t STOP_FRAME[8] = {0x80, 0, 0, 0, 0, 0, 0, 0};          // set_state(0x80)
+static const uint8_t STATUS_READ[8] = {0x9A, 0, 0, 0, 0, 0, 0, 0};         // RMD / LKtech status 1
+static const uint8_t BIONIC_STATUS_READ[8] = {0x0E, 0, 0, 0x01, 0, 0, 0, 0};
+
+// Signal handler state: only async-signal-safe operations on these
+static int g_wake_fd = -1;
+static volatile sig_atomic_t g_signal = 0;
+static volatile int64_t g_signal_ns = 0;
+static struct sigaction g_prev_int, g_prev_term;
+
+static int64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void on_signal(int sig) {
+    if (g_signal == 0) {
+        g_signal_ns = monotonic_ns();
+        g_signal = sig;
+    }
+    int saved = errno;
+    char b = 1;
+    (void)!write(g_wake_fd, &b, 1);
+    errno = saved;
+}
+
+const char *fault_name(Fault fault) {
+    switch (fault) {
+        case Fault::None: return "none";
+        case Fault::FeedbackLost: return "feedback lost";
+        case Fault::DriveError: return "drive error";
+        case Fault::OverTemperature: return "over temperature";
+        case Fault::Signal: return "signal";
+        case Fault::Requested: return "requested";
+    }
+    return "?";
+}
+
+FaultMonitor::FaultMonitor(const std::string &interface, const FaultConfig &cfg)
+    : cfg(cfg), bus(interface) {
+    init();
+}
+
+FaultMonitor::FaultMonitor(int fd, const FaultConfig &cfg)
+    : cfg(cfg), bus(fd) {
+    init();
+}
+
+void FaultMonitor::init() {
+    bus.set_receive_local(cfg.accept_local_frames);
+    // Keep heartbeats away from the application's socket; on vcan the
+    // simulator is local and has to see them (and the stops)
+    bus.set_loopback(cfg.accept_local_frames);
+    if (pipe2(wake_pipe, O_NONBLOCK | O_CLOEXEC) < 0) wake_pipe[0] = wake_pipe[1] = -1;
+}
+
+FaultMonitor::~FaultMonitor() {
+    stop();
+    if (wake_pipe[0] >= 0) close(wake_pipe[0]);
+    if (wake_pipe[1] >= 0) close(wake_pipe[1]);
+    bus.shutdown();
+}
+
+int FaultMonitor::add_motor(const MotorInfo &info) {
+    if (count >= MAX_MOTORS || running.load()) return -1;
+    // Shadow driver on the monitor's socket, used only to decode replies
+    motors[count] = make_motor(info, &bus);
+    protocols[count] = info.protocol;
+    return (int)count++;
+}
+
+bool FaultMonitor::start() {
+    if (running.load() || bus.get_fd() < 0 || wake_pipe[0] < 0) return false;
+
+    auto now = Clock::now();
+    for (size_t i = 0; i < count; ++i) last_rx[i] = last_heartbeat[i] = now;
+
+    if (cfg.handle_signals) {
+        g_wake_fd = wake_pipe[1];
+        g_signal = 0;
+        struct sigaction sa {};
+        sa.sa_handler = on_signal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGINT, &sa, &g_prev_int);
+        sigaction(SIGTERM, &sa, &g_prev_term);
+    }
+
+    running = true;
+    worker = std::thread(&FaultMonitor::run, this);
+    return true;
+}
+
+void FaultMonitor::stop() {
+    if (!running.exchange(false)) return;
+    char b = 0;
+    (void)!write(wake_pipe[1], &b, 1);
+    if (worker.joinable() && worker.get_id() != std::this_thread::get_id()) worker.join();
+    else if (worker.joinable()) worker.detach();
+    if (cfg.handle_signals) {
+        sigaction(SIGINT, &g_prev_int, nullptr);
+        sigaction(SIGTERM, &g_prev_term, nullptr);
+        g_wake_fd = -1;
+    }
+}
+
+void FaultMonitor::trip() {
+    trip_requested = true;
+    char b = 2;
+    (void)!write(wake_pipe[1], &b, 1);
+}
+
+bool FaultMonitor::drain(Clock::time_point now) {
+    uint32_t rid;
+    uint8_t data[8];
+    uint8_t len;
+    while (bus.poll_msg(rid, data, len)) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!motors[i]->decode_reply(rid, data, len)) continue;
+            last_rx[i] = now;
+            const RMDFeedback &st = motors[i]->get_state();
+            // Bionic status frames carry the code; RMD/LKtech flag it in the 0x9A reply
+            bool error = (protocols[i] == MotorProtocol::Bionic) ? st.msg_class == 1 && st.err_msg != 0
+                                                                 : st.err_msg > 0;
+            if (error) {
+                report.fault = Fault::DriveError;
+                report.motor = (int)i;
+                report.code = st.err_msg;
+                return true;
+            }
+            if (st.temp > cfg.max_temp_c) {
+                report.fault = Fault::OverTemperature;
+                report.motor = (int)i;
+                report.value = st.temp;
+                return true;
+            }
+            break;
+        }
+    }
+    return false;
+}
+
+bool FaultMonitor::check_ages(Clock::time_point now, Clock::time_point &onset) {
+    for (size_t i = 0; i < count; ++i) {
+        if (now - last_rx[i] <= cfg.feedback_timeout) continue;
+        report.fault = Fault::FeedbackLost;
+        report.motor = (int)i;
+        report.value = std::chrono::duration<float, std::milli>(now - last_rx[i]).count();
+        onset = last_rx[i] + cfg.feedback_timeout;
+        return true;
+    }
+    return false;
+}
+
+void FaultMonitor::send_heartbeats(Clock::time_point now) {
+    for (size_t i = 0; i < count; ++i) {
+        bool bionic = protocols[i] == MotorProtocol::Bionic;
+        bool silent = cfg.heartbeat.count() > 0 && now - last_rx[i] >= cfg.heartbeat &&
+                      now - last_heartbeat[i] >= cfg.heartbeat;
+        // RMD/LKtech command replies have no error flags: read them while busy too
+        bool errors = !bionic && cfg.error_poll.count() > 0 && now - last_heartbeat[i] >= cfg.error_poll;
+        if (!silent && !errors) continue;
+        const uint8_t *frame = bionic ? BIONIC_STATUS_READ : STATUS_READ;
+        if (bus.send_msg(motors[i]->get_id(), frame, 8, TxClass::Poll)) heartbeats++;
+        last_heartbeat[i] = now;
+    }
+}
+
+void FaultMonitor::stop_all(Clock::time_point onset, Clock::time_point detected) {
+    // Every motor gets its stop: safety frames overtake anything queued, and a
+    // full TX queue is waited out, never skipped
+    size_t rejected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!bus.send_msg(motors[i]->get_id(), STOP_FRAME, 8, TxClass::Safety)) rejected++;
+    }
+    auto give_up = std::max(cfg.stop_deadline * 10, std::chrono::microseconds(100000));
+    while (bus.get_tx_pending(TxClass::Safety) > 0 && Clock::now() - detected < give_up) {
+        bus.flush(std::chrono::microseconds(100));
+    }
+    size_t remaining = rejected + bus.get_tx_pending(TxClass::Safety);
+    auto done = Clock::now();
+
+    report.stops_sent = count - remaining;
+    report.detect_latency = std::chrono::duration_cast<std::chrono::microseconds>(detected - onset);
+    report.stop_latency = std::chrono::duration_cast<std::chrono::microseconds>(done - detected);
+    report.deadline_met = remaining == 0 && done - onset <= cfg.stop_deadline;
+}
+
+void FaultMonitor::run() {
+    struct pollfd fds[2] = {{bus.get_fd(), POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+    auto period_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg.period).count();
+    struct timespec timeout {(time_t)(period_ns / 1000000000), (long)(period_ns % 1000000000)};
+
+    while (running.load()) {
+        ppoll(fds, 2, &timeout, nullptr);
+        auto now = Clock::now();
+        Clock::time_point onset = now;
+        bool fault = false;
+
+        if (fds[1].revents & POLLIN) {
+            char buf[16];
+            while (read(wake_pipe[0], buf, sizeof(buf)) > 0) {}
+        }
+        if (!running.load()) break;
+
+        if (g_signal != 0 && cfg.handle_signals) {
+            report.fault = Fault::Signal;
+            report.code = g_signal;
+            // steady_clock is CLOCK_MONOTONIC
+            onset = Clock::time_point(std::chrono::nanoseconds(g_signal_ns));
+            fault = true;
+        } else if (trip_requested.load()) {
+            report.fault = Fault::Requested;
+            fault = true;
+        } else if (drain(now)) {
+            fault = true;
+        } else if (check_ages(now, onset)) {
+            fault = true;
+        }
+
+        if (!fault) {
+            send_heartbeats(now);
+            continue;
+        }
+
+        stop_all(onset, now);
+        tripped = true;
+        std::cerr << "[FaultMonitor] " << fault_name(report.fault);
+        if (report.motor >= 0) std::cerr << " on " << motors[report.motor]->get_name();
+        if (report.fault == Fault::DriveError || report.fault == Fault::Signal) std::cerr << " (" << report.code << ")";
+        if (!std::isnan(report.value)) std::cerr << " (" << report.value << ")";
+        std::cerr << ": " << report.stops_sent << "/" << count << " motors stopped, detect "
+                  << report.detect_latency.count() << " us + stop " << report.stop_latency.count() << " us"
+                  << (report.deadline_met ? "" : " - DEADLINE MISSED") << std::endl;
+        if (on_trip) on_trip(report);
+
+        if (report.fault == Fault::Signal) {
+            // Motors are stopped: terminate the way the signal would have
+            int sig = report.code;
+            sigaction(sig, sig == SIGINT ? &g_prev_int : &g_prev_term, nullptr);
+            raise(sig);
+        }
+        break;
+    }
+}
@@ -0,0 +1,267 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <csignal>
+#include <poll.h>
+#include <unistd.h>
+#include "can_bus.hpp"
+#include "loopback_bus.hpp"
+#include "sim_motor.hpp"
+#include "motor_control.hpp"
+#include "spi_hand.hpp"
+#include "hand_gateway.hpp"
+#include "motor_discovery.hpp"
+#include "fault_monitor.hpp"
+#include "hand_shm_server.hpp"
+#include "periodic_loop.hpp"
+#include "metrics_exporter.hpp"
+#include "trace.hpp"
+#include "rt_check.hpp"
+
+// Whole-hand gateway: CAN motors and the SPI servo board driven from one pose, e.g.
+//   ./motor_sim vcan0 rmd 0x141 &
+//   ./hand_gateway vcan0 loopback rmd:0x141
+// then type one line of joint targets (degrees) per pose: CAN joints in the
+// order given, then Pinky, Ring, Middle, Index, Thumb DOF1, Thumb DOF2.
+// With "sim" as the CAN interface each motor talks to a simulated drive over
+// an in-process LoopbackBus (no kernel CAN needed), e.g.
+//   ./hand_gateway sim loopback rmd:0x141 lk:0x142
+// With --shm other processes command the hand through /hand_shm (hand_shm.hpp).
+// CAN_BACKEND=io_uring batches each CAN tick into one syscall. With
+// --metrics <file> bus and motor counters are written to <file> every second
+// in Prometheus text format. With --trace <file> (and -DMOTOR_TRACE=ON) the
+// spans of every loop thread are written on exit as a Chrome trace. Built with
+// -DMOTOR_RT_CHECK=ON, allocations and blocking calls in the loop ticks are
+// reported on exit (RT_CHECK=abort stops at the first one).
+// On a kernel CAN interface a FaultMonitor stops every motor on lost feedback,
+// drive errors, over-temperature or Ctrl-C, as in motor_test; otherwise Ctrl-C
+// ends the input loop and the normal shutdown below runs.
+constexpr auto CONTROL_PERIOD = std::chrono::microseconds(2000);
+constexpr int INPUT_POLL_MS = 100;
+constexpr float GATEWAY_SPEED_RPM = 10.0f;
+constexpr auto SIM_STEP = std::chrono::microseconds(1000);
+
+void usage() {
+    std::cout << "Usage: hand_gateway <can interface|sim|none> <spidev device|loopback|none> "
+                 "[--shm] [--metrics <file>] [--trace <file>] [rmd:<id>|lk:<id>|bionic:<id> ...]\n";
+}
+
+// Set by SIGINT/SIGTERM when no FaultMonitor handles them
+static volatile sig_atomic_t g_quit = 0;
+
+static void on_quit(int) {
+    g_quit = 1;
+}
+
+// Waits for a line on stdin; false on EOF or once asked to quit
+static bool read_line(std::string &line, const FaultMonitor *monitor) {
+    struct pollfd fd {STDIN_FILENO, POLLIN, 0};
+    while (!g_quit && !(monitor && monitor->is_tripped())) {
+        if (poll(&fd, 1, INPUT_POLL_MS) > 0) return (bool)std::getline(std::cin, line);
+    }
+    return false;
+}
+
+std::unique_ptr<SimMotor> make_sim_motor(const MotorInfo &info) {
+    switch (info.protocol) {
+    case MotorProtocol::RMD: return std::make_unique<SimRMDMotor>(info.id);
+    case MotorProtocol::LKtech: return std::make_unique<SimLKtechMotor>(info.id);
+    case MotorProtocol::Bionic: return std::make_unique<SimBionicMotor>(info.id);
+    }
+    return nullptr;
+}
+
+void print_state(const HandGateway &gw) {
+    HandState st;
+    gw.get_state(st);
+    std::cout << "[HandGateway] pose " << st.pose_id << (st.synchronized ? " (synchronized)" : " (pending)")
+              << " | servo " << finger_status_name(st.spi_status) << (st.spi_acked ? ", acked" : "")
+              << "\n  pos:";
+    for (size_t i = 0; i < st.joints; ++i) std::cout << " " << st.pos[i];
+    std::cout << "\n  max dispatch: CAN " << gw.get_max_can_dispatch_us() << " us, SPI "
+              << gw.get_max_spi_dispatch_us() << " us | overruns CAN " << gw.get_can_overruns()
+              << " SPI " << gw.get_spi_overruns() << std::endl;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+
+    std::string can_if = argv[1];
+    std::string spi_dev = argv[2];
+
+    std::unique_ptr<CanTransport> bus;
+    LoopbackBus *sim_bus = nullptr;
+    if (can_if == "sim") {
+        auto loopback = std::make_unique<LoopbackBus>();
+        sim_bus = loopback.get();
+        bus = std::move(loopback);
+    } else if (can_if != "none") {
+        bus = std::make_unique<CANBus>(can_if, can_backend_from_env());
+    }
+    std::vector<std::unique_ptr<SimMotor>> sims;
+
+    std::unique_ptr<SpiTransport> transport;
+    if (spi_dev == "loopback") {
+        transport = std::make_unique<LoopbackSpiSlave>();
+    } else if (spi_dev != "none") {
+        auto dev = std::make_unique<SpidevTransport>(spi_dev);
+        if (!dev->is_open()) return 1;
+        transport = std::move(dev);
+    }
+    std::unique_ptr<SpiHandLink> link;
+    if (transport) link = std::make_unique<SpiHandLink>(transport.get());
+
+    HandGateway gateway(bus.get(), link.get());
+    std::vector<std::unique_ptr<MotorControl>> motors;
+    std::vector<MotorInfo> infos;
+    // Every drive enabled below is disabled again on the way out
+    auto disable_all = [&motors] {
+        for (auto &m : motors) m->set_state(0x80);
+    };
+    bool use_shm = false;
+    std::string metrics_path;
+    std::string trace_path;
+    for (int i = 3; i < argc; ++i) {
+        if (std::string(argv[i]) == "--shm") {
+            use_shm = true;
+            continue;
+        }
+        if (std::string(argv[i]) == "--metrics" && i + 1 < argc) {
+            metrics_path = argv[++i];
+            continue;
+        }
+        if (std::string(argv[i]) == "--trace" && i + 1 < argc) {
+            trace_path = argv[++i];
+            continue;
+        }
+        auto motor = bus ? make_motor(argv[i], bus.get()) : nullptr;
+        if (!motor) {
+            std::cerr << "[HandGateway] Bad motor '" << argv[i] << "'\n";
+            usage();
+            return 1;
+        }
+        MotorInfo info;
+        parse_motor_spec(argv[i], info);
+        if (sim_bus) {
+            sims.push_back(make_sim_motor(info));
+            sim_bus->attach(sims.back().get());
+        }
+        motor->set_state(0x81); // enable
+        motors.push_back(std::move(motor));
+        infos.push_back(info);
+        if (gateway.add_can_joint(motors.back().get(), GATEWAY_SPEED_RPM) < 0) {
+            disable_all();
+            return 1;
+        }
+    }
+
+    // Simulated drives move in real time
+    PeriodicLoop sim_clock;
+    if (sim_bus) sim_clock.start(SIM_STEP, [sim_bus] { sim_bus->advance(SIM_STEP); });
+
+    gateway.start(CONTROL_PERIOD);
+
+    std::unique_ptr<FaultMonitor> monitor;
+    if (bus && !sim_bus && !motors.empty()) {
+        FaultConfig fault_cfg;
+        fault_cfg.accept_local_frames = can_if.compare(0, 4, "vcan") == 0;
+        monitor = std::make_unique<FaultMonitor>(can_if, fault_cfg);
+        for (const MotorInfo &info : infos) monitor->add_motor(info);
+        // A setpoint the CAN tick sent after the stops would start the motor
+        // again: stop the tick, then repeat the stops
+        monitor->set_on_trip([&gateway, &disable_all](const FaultReport &) {
+            gateway.stop();
+            disable_all();
+        });
+        if (!monitor->start()) monitor.reset();
+    }
+    if (!monitor) {
+        struct sigaction sa {};
+        sa.sa_handler = on_quit;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGINT, &sa, nullptr);
+        sigaction(SIGTERM, &sa, nullptr);
+    }
+
+    std::unique_ptr<MetricsExporter> exporter;
+    if (!metrics_path.empty()) {
+        exporter = std::make_unique<MetricsExporter>(metrics_path);
+        if (bus) exporter->add_bus(can_if, bus.get());
+        for (const auto &m : motors) exporter->add_motor(m.get());
+        exporter->start();
+    }
+
+    // Shared-memory bridge: mailbox commands become poses as soon as a client
+    // rings, and the state is published at least every period
+    std::unique_ptr<HandShmServer> shm;
+    std::atomic<bool> shm_running{false};
+    std::thread shm_thread;
+    if (use_shm) {
+        shm = std::make_unique<HandShmServer>(HAND_SHM_DEFAULT_NAME, gateway.size());
+        if (!shm->is_open()) {
+            gateway.stop();
+            disable_all();
+            return 1;
+        }
+        shm_running = true;
+        shm_thread = std::thread([&gateway, &shm, &shm_running] {
+            TRACE_THREAD_NAME("hand_shm");
+            HandState st;
+            while (shm_running.load(std::memory_order_relaxed)) {
+                shm->wait_commands(CONTROL_PERIOD);
+                gateway.get_state(st);
+                if (shm->poll_commands(st.target, st.joints) > 0) {
+                    gateway.set_pose(st.target, st.joints);
+                    gateway.get_state(st);
+                }
+                shm->publish(st);
+            }
+        });
+    }
+    std::cout << "[HandGateway] " << gateway.size() << " joints, period "
+              << CONTROL_PERIOD.count() << " us. Enter targets (deg), 's' for state, 'q' to quit." << std::endl;
+
+    // Steady state: the loops are running
+    rt_check_arm(true);
+
+    std::string line;
+    while (read_line(line, monitor.get())) {
+        if (line == "q") break;
+        if (line == "s" || line.empty()) {
+            print_state(gateway);
+            continue;
+        }
+        std::istringstream in(line);
+        std::vector<float> pose;
+        float v;
+        while (in >> v) pose.push_back(v);
+        gateway.set_pose(pose.data(), pose.size());
+
+        // Let both transports pick it up before reporting
+        std::this_thread::sleep_for(2 * CONTROL_PERIOD);
+        print_state(gateway);
+    }
+
+    rt_check_arm(false);
+    rt_check_report();
+    // Joins the monitor thread, so a trip's on_trip has finished
+    if (monitor) monitor->stop();
+    shm_running = false;
+    if (shm_thread.joinable()) shm_thread.join();
+    gateway.stop();
+    disable_all();
+    sim_clock.stop();
+    if (exporter) exporter->stop();
+    if (!trace_path.empty()) trace_dump(trace_path);
+    if (bus) bus->shutdown();
+    return 0;
+}
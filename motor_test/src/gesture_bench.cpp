@@ -0,0 +1,90 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include "loopback_bus.hpp"
+#include "motor_control.hpp"
+#include "sim_motor.hpp"
+#include "motion_queue.hpp"
+
+// Gesture throughput on the simulated drive, in virtual time at the control rate:
+// one finger curl (via points, then back open) executed
+//   a) as one stop-and-go move per waypoint, like move_and_monitor(), and
+//   b) through MotionQueue streaming setpoints every tick, with look-ahead
+//      off (stops at every waypoint), on, and on with a blend radius.
+// Setpoints go through the real driver's streaming path over a LoopbackBus and
+// are answered by SimRMDMotor, so the only thing missing compared to vcan is
+// the socket. b) is what motor_test --batch --blend runs (TrajectoryRunner).
+//   ./gesture_bench [gestures] [blend_deg]
+constexpr float DT = 0.002f;             // 500 Hz control rate
+constexpr float SPEED_DPS = 360.0f;      // segment speed limit (60 rpm)
+constexpr float ACCEL_DPS2 = 3600.0f;     // same as the simulated drive
+constexpr float TOLERANCE_DEG = 1.0f;
+const float GESTURE[] = {40.0f, 80.0f, 90.0f, 45.0f, 0.0f};
+constexpr size_t GESTURE_LEN = sizeof(GESTURE) / sizeof(GESTURE[0]);
+
+struct Rig {
+    LoopbackBus bus;
+    SimRMDMotor sim{0x141};
+    RMD_Motor driver{0x141, &bus, "RMD_Sim"};
+    float time_s = 0.0f;
+
+    Rig() { bus.attach(&sim); }
+
+    // One control tick: decode the last reply, send a setpoint, let the drive move
+    void tick(float target_deg) {
+        MotorControl *motors[1] = {&driver};
+        drain_replies(&bus, motors, 1);
+        driver.setpoint_write(target_deg, SPEED_DPS / 6.0f);
+        bus.advance(std::chrono::microseconds((int)(DT * 1e6f)));
+        time_s += DT;
+    }
+};
+
+// move_and_monitor() checks the position every 50 ms
+constexpr int MONITOR_TICKS = 25;
+
+float run_stop_and_go(int gestures) {
+    Rig rig;
+    for (int g = 0; g < gestures; ++g) {
+        for (size_t w = 0; w < GESTURE_LEN; ++w) {
+            do {
+                for (int k = 0; k < MONITOR_TICKS; ++k) rig.tick(GESTURE[w]);
+            } while (std::abs(rig.sim.get_pos() - GESTURE[w]) > TOLERANCE_DEG);
+        }
+    }
+    return rig.time_s;
+}
+
+float run_queued(int gestures, bool lookahead, float blend_deg) {
+    Rig rig;
+    MotionQueue queue(1, ACCEL_DPS2, blend_deg);
+    queue.set_lookahead(lookahead);
+    queue.reset(0, rig.sim.get_pos());
+    float setpoint = 0.0f;
+    for (int g = 0; g < gestures; ++g) {
+        for (size_t w = 0; w < GESTURE_LEN; ++w) queue.push(0, GESTURE[w], SPEED_DPS);
+        do {
+            queue.step(DT, &setpoint);
+            rig.tick(setpoint);
+        } while (!queue.idle() || std::abs(rig.sim.get_pos() - GESTURE[GESTURE_LEN - 1]) > TOLERANCE_DEG);
+    }
+    return rig.time_s;
+}
+
+void report(const char *mode, int gestures, float seconds) {
+    std::cout << "[gesture_bench] " << mode << ": " << seconds / gestures * 1000.0f << " ms/gesture, "
+              << gestures * 60.0f / seconds << " gestures/min" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    int gestures = argc > 1 ? std::atoi(argv[1]) : 100;
+    float blend = argc > 2 ? std::strtof(argv[2], nullptr) : 5.0f;
+    if (gestures <= 0) return 1;
+
+    report("stop-and-go               ", gestures, run_stop_and_go(gestures));
+    report("queue, no look-ahead      ", gestures, run_queued(gestures, false, 0.0f));
+    report("queue, look-ahead         ", gestures, run_queued(gestures, true, 0.0f));
+    std::cout << "[gesture_bench] blend radius " << blend << " deg:" << std::endl;
+    report("queue, look-ahead + blend ", gestures, run_queued(gestures, true, blend));
+    return 0;
+}
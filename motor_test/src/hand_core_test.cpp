@@ -0,0 +1,328 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include "finger_frame.h"
+#include "force_filter.h"
+#include "hand_gateway.hpp"
+#include "loopback_bus.hpp"
+#include "servo_motion.h"
+#include "sim_motor.hpp"
+#include "spi_hand.hpp"
+#include "telemetry_reader.hpp"
+#include "test_check.hpp"
+
+// Hand board cores shared with the sketches (../src), run on the host, and
+// the host's SPI link and gateway talking to them
+
+static void test_finger_frame() {
+    const uint16_t raw[FINGER_FRAME_DOF] = {0, 4500, 9000, 18000, 65535, 1};
+    uint8_t frame[FINGER_FRAME_SIZE];
+
+    fingerEncodeCommand(0x13, raw, frame);
+    CHECK(frame[0] == (FINGER_SYNC_COMMAND | 0x03)); // sequence wraps at 4 bits
+    CHECK(frame[3] == (4500 & 0xFF) && frame[4] == (4500 >> 8));
+
+    uint8_t seq = 0;
+    uint16_t out[FINGER_FRAME_DOF] = {};
+    CHECK(fingerDecodeCommand(frame, &seq, out));
+    CHECK(seq == 0x03);
+    CHECK(std::memcmp(raw, out, sizeof(raw)) == 0);
+
+    // Any flipped bit fails the CRC, and so does a bad sync nibble
+    for (int byte = 0; byte < FINGER_FRAME_SIZE; ++byte) {
+        uint8_t bad[FINGER_FRAME_SIZE];
+        std::memcpy(bad, frame, sizeof(bad));
+        bad[byte] ^= 0x10;
+        CHECK(!fingerDecodeCommand(bad, &seq, out));
+    }
+
+    // Replies carry the status and their own CRC; commands are not replies
+    uint8_t status = 0;
+    fingerEncodeReply(0x07, raw, 0x12, frame);
+    CHECK(fingerDecodeReply(frame, &seq, out, &status));
+    CHECK(seq == 0x07 && status == 0x12);
+    CHECK(std::memcmp(raw, out, sizeof(raw)) == 0);
+    CHECK(!fingerDecodeCommand(frame, &seq, out));
+    frame[13] = 0x02;
+    CHECK(!fingerDecodeReply(frame, &seq, out, &status));
+
+    // NAN on the host is a hold on the wire and back
+    const float angles[FINGER_DOF] = {10.0f, NAN, 655.35f, 0.0f, NAN, 90.0f};
+    encode_finger_packet(0x04, angles, frame);
+    CHECK(frame[3] == 0xFF && frame[4] == 0xFF);
+    FingerPacket cmd = decode_finger_command(frame);
+    CHECK(cmd.valid && std::isnan(cmd.angle_deg[1]) && std::isnan(cmd.angle_deg[4]));
+    CHECK_NEAR(cmd.angle_deg[2], 655.34, 1e-3); // clamped below the hold value
+    CHECK_NEAR(cmd.angle_deg[5], 90.0, 1e-3);
+}
+
+static void test_servo_motion() {
+    ServoMotion motion(100.0f); // deg/s
+    const float start[SERVO_DOF] = {10, 10, 10, 10, 10, 10};
+    motion.begin(1000, start);
+    CHECK(motion.status() == SERVO_STATUS_IDLE);
+    CHECK(!motion.update(1000));
+
+    float target[SERVO_DOF] = {60, 10, 0, 10, 10, 10};
+    motion.setTarget(target);
+    CHECK(motion.status() == SERVO_STATUS_MOVING);
+
+    // 100 ms at 100 deg/s: 10 deg toward the target, both directions
+    CHECK(motion.update(1100));
+    CHECK_NEAR(motion.position(0), 20.0f, 1e-4);
+    CHECK_NEAR(motion.position(2), 0.0f, 1e-4);  // 10 deg away: arrives, no overshoot
+    CHECK_NEAR(motion.position(1), 10.0f, 1e-4);
+    CHECK(motion.status() == SERVO_STATUS_MOVING);
+
+    motion.update(1600);
+    CHECK_NEAR(motion.position(0), 60.0f, 1e-4);
+    CHECK(motion.status() == SERVO_STATUS_DONE);
+    CHECK(!motion.update(1700));
+
+    // A new target restarts the slew; a halt freezes the servos where they are
+    motion.setTarget(0, 0.0f);
+    motion.update(1800);
+    CHECK_NEAR(motion.position(0), 50.0f, 1e-4);
+    motion.halt();
+    CHECK(motion.status() == SERVO_STATUS_HALT);
+    CHECK(!motion.update(2000));
+    CHECK_NEAR(motion.position(0), 50.0f, 1e-4);
+    motion.setTarget(0, 40.0f);
+    CHECK(motion.status() == SERVO_STATUS_MOVING);
+
+    // millis() wrap-around
+    ServoMotion wrap(100.0f);
+    wrap.begin(0xFFFFFFF0u, start);
+    wrap.setTarget(target);
+    wrap.update(0x00000050u); // 96 ms later
+    CHECK_NEAR(wrap.position(0), 19.6f, 1e-3);
+}
+
+static void test_force_filter() {
+    ForceFilter force;
+    CHECK(force.median() == 0 && force.mean() == 0);
+    CHECK(!force.outOfRange(-100, 100)); // nothing sampled yet
+
+    force.push(30);
+    force.push(-10);
+    force.push(20);
+    CHECK(force.count() == 3 && !force.full());
+    CHECK(force.median() == 20);
+    CHECK(force.mean() == 13);
+    force.push(40);
+    CHECK(force.median() == 25); // even count: mean of the middle two
+
+    // One spike does not move the median out of range, a sustained load does
+    ForceFilter spiky;
+    for (int i = 0; i < FORCE_FILTER_SIZE; ++i) spiky.push(100);
+    spiky.push(900000);
+    CHECK(spiky.full());
+    CHECK(spiky.median() == 100);
+    CHECK(!spiky.outOfRange(-500000, 500000));
+    for (int i = 0; i < FORCE_FILTER_SIZE / 2; ++i) spiky.push(600000);
+    CHECK(spiky.outOfRange(-500000, 500000));
+
+    // The window slides: old samples leave the sorted copy too
+    for (int i = 0; i < FORCE_FILTER_SIZE; ++i) spiky.push(-200 - i);
+    CHECK(spiky.median() == -203);
+    CHECK(spiky.mean() == -203);
+    CHECK(!spiky.outOfRange(-500000, 500000)); // negative readings are in range
+    CHECK(spiky.outOfRange(0, 500000));
+    for (int i = 0; i < FORCE_FILTER_SIZE; ++i) spiky.push(-600000);
+    CHECK(spiky.outOfRange(-500000, 500000));
+
+    spiky.reset();
+    CHECK(spiky.count() == 0 && !spiky.outOfRange(-500000, 500000));
+}
+
+// Round trip through COBS of a buffer, zeros and all
+static bool cobs_round_trip(const uint8_t *in, uint8_t len) {
+    uint8_t wire[2 * HAND_TELEMETRY_WIRE_SIZE];
+    uint8_t out[2 * HAND_TELEMETRY_WIRE_SIZE];
+    uint8_t n = cobsEncode(in, len, wire);
+    for (uint8_t k = 0; k < n; ++k) {
+        if (wire[k] == 0) return false;
+    }
+    return cobsDecode(wire, n, out) == len && std::memcmp(in, out, len) == 0;
+}
+
+static void test_telemetry_codec() {
+    // Zero bytes anywhere, all zeros, no zeros; lengths stay below 254 so the
+    // uint8_t encoded length cannot wrap
+    const uint8_t mixed[] = {0x00, 0x11, 0x00, 0x00, 0x22, 0x33, 0x00};
+    CHECK(cobs_round_trip(mixed, sizeof(mixed)));
+    uint8_t block[HAND_TELEMETRY_WIRE_SIZE];
+    std::memset(block, 0, sizeof(block));
+    CHECK(cobs_round_trip(block, sizeof(block)));
+    for (size_t k = 0; k < sizeof(block); ++k) block[k] = (uint8_t)(k + 1);
+    CHECK(cobs_round_trip(block, sizeof(block)));
+    const uint8_t truncated[] = {0x05, 0x11, 0x22};
+    CHECK(cobsDecode(truncated, sizeof(truncated), block) == 0);
+
+    // Every field at its limit: no zero in the record, the longest COBS frame
+    HandTelemetry t{};
+    t.timeMs = 0xFFFFFFFFu;
+    t.seq = 0xFF;
+    t.status = 0x12;
+    for (size_t i = 0; i < HAND_TELEMETRY_DOF; ++i) {
+        t.pos[i] = 0xFFFF;
+        t.target[i] = 0xFFFF;
+    }
+    t.force = -1;
+    t.crcErrors = 0xFFFF;
+    t.rxOverruns = 0xFFFF;
+    uint8_t wire[HAND_TELEMETRY_WIRE_SIZE];
+    CHECK(telemetryEncode(&t, wire) == HAND_TELEMETRY_WIRE_SIZE);
+    CHECK(wire[HAND_TELEMETRY_WIRE_SIZE - 1] == 0x00);
+    HandTelemetry back{};
+    CHECK(telemetryDecode(wire, HAND_TELEMETRY_WIRE_SIZE - 1, &back));
+    CHECK(back.timeMs == t.timeMs && back.seq == t.seq && back.status == t.status);
+    CHECK(std::memcmp(back.pos, t.pos, sizeof(t.pos)) == 0);
+    CHECK(std::memcmp(back.target, t.target, sizeof(t.target)) == 0);
+    CHECK(back.force == -1 && back.crcErrors == 0xFFFF && back.rxOverruns == 0xFFFF);
+
+    // The other extreme: mostly zeros, force at INT32_MIN
+    HandTelemetry low{};
+    low.force = INT32_MIN;
+    uint8_t n = telemetryEncode(&low, wire);
+    CHECK(telemetryDecode(wire, n - 1, &back));
+    CHECK(back.force == INT32_MIN && back.timeMs == 0 && back.pos[5] == 0);
+
+    // A flipped bit fails the CRC; the reader drops that frame and takes the next
+    telemetryEncode(&t, wire);
+    uint8_t stream[2 * HAND_TELEMETRY_WIRE_SIZE];
+    std::memcpy(stream, wire, sizeof(wire));
+    std::memcpy(stream + sizeof(wire), wire, sizeof(wire));
+    stream[10] ^= 0x04;
+    CHECK(!telemetryDecode(stream, HAND_TELEMETRY_WIRE_SIZE - 1, &back));
+    TelemetryReader reader;
+    HandTelemetry out[2];
+    CHECK(reader.feed(stream, sizeof(stream), out, 2) == 1);
+    CHECK(reader.get_frame_count() == 1 && reader.get_error_count() == 1);
+    CHECK(out[0].timeMs == t.timeMs && out[0].crcErrors == 0xFFFF);
+}
+
+// Passes transfers through, corrupting one byte of every reply while `corrupt` is set
+class CorruptingSpi : public SpiTransport {
+public:
+    explicit CorruptingSpi(SpiTransport *inner) : inner(inner) {}
+    bool corrupt = false;
+
+    bool transfer(const uint8_t *tx, uint8_t *rx, size_t len, size_t count) override {
+        if (!inner->transfer(tx, rx, len, count)) return false;
+        for (size_t p = 0; corrupt && p < count; ++p) rx[p * len + 5] ^= 0x01;
+        return true;
+    }
+
+private:
+    SpiTransport *inner;
+};
+
+static void test_spi_link() {
+    uint32_t ms = 0;  // the board's millis()
+    LoopbackSpiSlave slave(1000.0f, [&ms] { return ms; });
+    CorruptingSpi spi(&slave);
+    SpiHandLink link(&spi);
+    const float pose[FINGER_DOF] = {10, 20, 30, 40, 0, 0};
+
+    // The reply to the first packet is the board's power-up feedback
+    CHECK(link.send_angles(pose));
+    CHECK(!link.is_acked());
+    CHECK(link.get_reply().valid && link.get_status() == FingerStatus::Idle);
+
+    // The next packet's reply acknowledges it
+    CHECK(link.poll());
+    CHECK(link.is_acked());
+    CHECK(link.get_status() == FingerStatus::Moving);
+    CHECK(link.get_reply_errors() == 0);
+
+    // Replies report where the servos are, not the echoed command: 40 deg at 1000 deg/s
+    ms += 60;
+    CHECK(link.poll());
+    CHECK(link.is_acked());
+    CHECK(link.get_status() == FingerStatus::Done);
+    for (size_t i = 0; i < FINGER_DOF; ++i) CHECK_NEAR(link.get_reply().angle_deg[i], pose[i], 0.01);
+
+    // A corrupted reply is dropped: no ack, the last good reply stays
+    spi.corrupt = true;
+    CHECK(link.poll());
+    CHECK(!link.is_acked());
+    CHECK(link.get_reply_errors() == 1);
+    CHECK(link.get_reply().valid && link.get_status() == FingerStatus::Done);
+    spi.corrupt = false;
+    CHECK(link.poll());
+    CHECK(link.is_acked());
+    CHECK(slave.get_crc_errors() == 0);
+
+    // Batches: each reply trails its packet by one
+    float batch[3 * FINGER_DOF] = {};
+    for (size_t k = 0; k < 3; ++k) batch[k * FINGER_DOF] = 50.0f + k;
+    FingerPacket replies[3];
+    CHECK(link.send_batch(batch, 3, replies));
+    CHECK(replies[0].valid && replies[1].valid && replies[2].valid);
+    CHECK(((replies[1].seq + 1) & FINGER_SEQ_MASK) == replies[2].seq);
+    CHECK(link.is_acked());
+}
+
+// Polls the gateway state until pred holds, at most 1 s of wall time
+template <typename Pred>
+static bool wait_state(const HandGateway &gateway, HandState &st, Pred pred) {
+    for (int k = 0; k < 200; ++k) {
+        gateway.get_state(st);
+        if (pred(st)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+static void test_gateway_servo_hold() {
+    // The board's millis() moves 1 ms per packet, so the servos move as the
+    // gateway polls them
+    std::atomic<uint32_t> ms{0};
+    LoopbackSpiSlave slave(1000.0f, [&ms] { return ms.fetch_add(1); });
+
+    // A previous session left the servos at 40 deg
+    SpiHandLink setup(&slave);
+    const float at40[FINGER_DOF] = {40, 40, 40, 40, 40, 40};
+    setup.send_angles(at40);
+    ms += 60;
+
+    LoopbackBus bus;
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    SpiHandLink link(&slave);
+    HandGateway gateway(&bus, &link);
+    CHECK(gateway.add_can_joint(&rmd, 30.0f) == 0);
+    HandState st;
+    gateway.get_state(st);
+    CHECK(std::isnan(st.target[1]));
+    CHECK(gateway.start(std::chrono::microseconds(1000)));
+
+    // A pose for the CAN joint only: nothing goes to the board
+    const float pose[2] = {20.0f, 10.0f};
+    gateway.set_pose(pose, 1);
+    CHECK(wait_state(gateway, st, [](const HandState &s) { return s.synchronized; }));
+    CHECK(std::isnan(st.pos[1]));
+
+    // One servo: it moves, the others hold where they are
+    gateway.set_pose(pose, 2);
+    CHECK(wait_state(gateway, st, [](const HandState &s) {
+        return s.synchronized && s.spi_status == (uint8_t)FingerStatus::Done && std::abs(s.pos[1] - 10.0f) < 0.01f;
+    }));
+    for (size_t k = 1; k < FINGER_DOF; ++k) CHECK_NEAR(st.pos[1 + k], 40.0, 0.01);
+    gateway.stop();
+}
+
+int main() {
+    test_finger_frame();
+    test_servo_motion();
+    test_force_filter();
+    test_telemetry_codec();
+    test_spi_link();
+    test_gateway_servo_hold();
+    return test_result("hand_core_test");
+}
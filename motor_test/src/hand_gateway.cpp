@@ -0,0 +1,158 @@
+#include "hand_gateway.hpp"
+#include "rt_check.hpp"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+// Readers outside the ticks retry until the copy is whole
+template <typename T>
+static T load_whole(const SeqlockValue<T> &shared) {
+    T out;
+    while (!shared.try_load(out)) std::this_thread::yield();
+    return out;
+}
+
+HandGateway::HandGateway(CanTransport *bus, SpiHandLink *spi)
+    : bus(bus), spi(spi) {
+    // No setpoints until the first pose sets them
+    for (size_t i = 0; i < MAX_JOINTS; ++i) pose.target[i] = NAN;
+    for (size_t i = 0; i < MAX_CAN_JOINTS; ++i) can_fb.pos[i] = NAN;
+    for (size_t k = 0; k < FINGER_DOF; ++k) spi_fb.pos[k] = NAN;
+    can_pose = spi_pose = pose;
+    shared_pose.store(pose);
+    shared_can.store(can_fb);
+    shared_spi.store(spi_fb);
+}
+
+HandGateway::~HandGateway() {
+    stop();
+}
+
+int HandGateway::add_can_joint(MotorControl *motor, float vel_rpm) {
+    uint8_t probe[8];
+    if (!bus || can_count >= MAX_CAN_JOINTS || can_loop.is_running() ||
+        !motor->encode_position(0.0f, vel_rpm, probe)) {
+        std::cerr << "[HandGateway] Cannot stream positions to " << motor->get_name() << "\n";
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(pose_mtx);
+    // Servo DOFs follow the CAN joints: shift them up by one
+    if (spi) {
+        for (size_t k = FINGER_DOF; k-- > 0;) pose.target[can_count + 1 + k] = pose.target[can_count + k];
+    }
+    motors[can_count] = motor;
+    vel_limit[can_count] = vel_rpm;
+    pose.target[can_count] = NAN; // no setpoint until the first pose
+    can_pose = spi_pose = pose;
+    shared_pose.store(pose);
+    return (int)can_count++;
+}
+
+bool HandGateway::start(std::chrono::microseconds period) {
+    if (can_loop.is_running() || spi_loop.is_running()) return false;
+    if (bus && can_count > 0) can_loop.start(period, [this] { can_tick(); });
+    if (spi) spi_loop.start(period, [this] { spi_tick(); });
+    return true;
+}
+
+void HandGateway::stop() {
+    can_loop.stop();
+    spi_loop.stop();
+}
+
+void HandGateway::set_pose(const float *targets_deg, size_t n) {
+    std::lock_guard<std::mutex> lock(pose_mtx);
+    n = std::min(n, size());
+    for (size_t i = 0; i < n; ++i) pose.target[i] = targets_deg[i];
+    pose.id++;
+    pose.stamp = std::chrono::steady_clock::now();
+    shared_pose.store(pose);
+}
+
+void HandGateway::get_state(HandState &out) const {
+    CanFeedback can = load_whole(shared_can);
+    SpiFeedback servo = load_whole(shared_spi);
+    std::lock_guard<std::mutex> lock(pose_mtx);
+    out.joints = size();
+    out.pose_id = pose.id;
+    out.can_pose_id = can.pose_id;
+    out.spi_pose_id = servo.pose_id;
+    out.synchronized = (can_count == 0 || can.pose_id == pose.id) && (!spi || servo.pose_id == pose.id);
+    for (size_t i = 0; i < MAX_JOINTS; ++i) {
+        out.target[i] = pose.target[i];
+        out.pos[i] = NAN;
+    }
+    for (size_t i = 0; i < can_count; ++i) out.pos[i] = can.pos[i];
+    if (spi) {
+        for (size_t k = 0; k < FINGER_DOF; ++k) out.pos[can_count + k] = servo.pos[k];
+    }
+    out.spi_status = servo.status;
+    out.spi_acked = servo.acked;
+}
+
+int64_t HandGateway::get_max_can_dispatch_us() const {
+    return load_whole(shared_can).max_dispatch_us;
+}
+
+int64_t HandGateway::get_max_spi_dispatch_us() const {
+    return load_whole(shared_spi).max_dispatch_us;
+}
+
+void HandGateway::can_tick() {
+    RT_SECTION();
+    // Mid-write: last tick's pose, the new one is picked up next tick
+    shared_pose.try_load(can_pose);
+
+    // Replies to the previous tick's setpoints are the feedback (passive)
+    drain_replies(bus, motors.data(), can_count);
+    bus->begin_batch();
+    for (size_t i = 0; i < can_count; ++i) {
+        if (!std::isnan(can_pose.target[i])) motors[i]->setpoint_write(can_pose.target[i], vel_limit[i]);
+    }
+    bus->flush();
+    auto sent = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < can_count; ++i) can_fb.pos[i] = motors[i]->get_state().pos;
+    if (can_pose.id != can_fb.pose_id && can_pose.id > 0) {
+        int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(sent - can_pose.stamp).count();
+        can_fb.max_dispatch_us = std::max(can_fb.max_dispatch_us, us);
+        can_fb.pose_id = can_pose.id;
+    }
+    shared_can.store(can_fb);
+}
+
+void HandGateway::spi_tick() {
+    RT_SECTION();
+    shared_pose.try_load(spi_pose);
+    const float *target = spi_pose.target + can_count;
+    bool any_target = false;
+    for (size_t k = 0; k < FINGER_DOF; ++k) any_target |= !std::isnan(target[k]);
+    // Nothing to command before the first servo target (the board holds its
+    // power-up angles); servos without a target are sent as holds (NAN)
+    if (!any_target) {
+        if (spi_fb.pose_id != spi_pose.id) {
+            spi_fb.pose_id = spi_pose.id;
+            shared_spi.store(spi_fb);
+        }
+        return;
+    }
+
+    // One command per tick: the reply clocked back acknowledges the previous one
+    bool ok = spi->send_angles(target);
+    auto sent = std::chrono::steady_clock::now();
+    const FingerPacket &reply = spi->get_reply();
+
+    if (reply.valid) {
+        for (size_t k = 0; k < FINGER_DOF; ++k) spi_fb.pos[k] = reply.angle_deg[k];
+        spi_fb.status = reply.status;
+    }
+    spi_fb.acked = spi->is_acked();
+    if (ok && spi_pose.id != spi_fb.pose_id) {
+        int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(sent - spi_pose.stamp).count();
+        spi_fb.max_dispatch_us = std::max(spi_fb.max_dispatch_us, us);
+        spi_fb.pose_id = spi_pose.id;
+    }
+    shared_spi.store(spi_fb);
+}
@@ -0,0 +1,114 @@
+#include "hand_shm_server.hpp"
+#include <iostream>
+#include <cstdio>
+#include <new>
+#include <algorithm>
+
+HandShmServer::HandShmServer(const std::string &name, size_t joints)
+    : name(name) {
+    // Start clean: a segment left by a crashed server may hold stale slots
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        perror("Shared memory open failed");
+        return;
+    }
+    if (ftruncate(fd, sizeof(HandShmSegment)) < 0) {
+        perror("Shared memory resize failed");
+        close(fd);
+        shm_unlink(name.c_str());
+        return;
+    }
+    void *p = mmap(nullptr, sizeof(HandShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror("Shared memory map failed");
+        shm_unlink(name.c_str());
+        return;
+    }
+
+    seg = new (p) HandShmSegment;
+    seg->joints = (uint32_t)std::min(joints, HAND_SHM_MAX_JOINTS);
+    seg->next_id.store(0, std::memory_order_relaxed);
+    seg->enqueue_pos.store(0, std::memory_order_relaxed);
+    seg->dequeue_pos.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < HAND_SHM_MAILBOX_SLOTS; ++i) seg->slots[i].seq.store(i, std::memory_order_relaxed);
+    seg->doorbell.store(0, std::memory_order_relaxed);
+    seg->server_waiting.store(0, std::memory_order_relaxed);
+    seg->state_seq.store(0, std::memory_order_relaxed);
+    seg->state = HandShmState();
+    seg->state.joints = seg->joints;
+    seg->version = HAND_SHM_VERSION;
+    // Clients check the magic last, so it goes in once everything else is set
+    std::atomic_thread_fence(std::memory_order_release);
+    seg->magic = HAND_SHM_MAGIC;
+
+    std::cout << "[HandShm] Serving " << seg->joints << " joints on " << name << std::endl;
+}
+
+HandShmServer::~HandShmServer() {
+    if (!seg) return;
+    munmap(seg, sizeof(HandShmSegment));
+    shm_unlink(name.c_str());
+}
+
+size_t HandShmServer::poll_commands(float *targets, size_t n) {
+    size_t drained = 0;
+    uint64_t pos = seg->dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        HandShmSegment::Slot &slot = seg->slots[pos & (HAND_SHM_MAILBOX_SLOTS - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1) break; // empty or still being written
+
+        const HandShmCommand &cmd = slot.cmd;
+        for (size_t i = 0; i < n && i < HAND_SHM_MAX_JOINTS; ++i) {
+            if (cmd.mask & (1u << i)) targets[i] = cmd.target[i];
+        }
+        if (cmd.id > last_id) last_id = cmd.id;
+
+        slot.seq.store(pos + HAND_SHM_MAILBOX_SLOTS, std::memory_order_release);
+        pos++;
+        drained++;
+    }
+    seg->dequeue_pos.store(pos, std::memory_order_relaxed);
+    return drained;
+}
+
+bool HandShmServer::wait_commands(std::chrono::microseconds timeout) {
+    auto pending = [this] {
+        uint64_t pos = seg->dequeue_pos.load(std::memory_order_relaxed);
+        return seg->slots[pos & (HAND_SHM_MAILBOX_SLOTS - 1)].seq.load(std::memory_order_acquire) == pos + 1;
+    };
+    seg->server_waiting.store(1, std::memory_order_seq_cst);
+    uint32_t bell = seg->doorbell.load(std::memory_order_seq_cst);
+    if (!pending()) {
+        // Returns at once if the doorbell rang since it was read
+        struct timespec ts {(time_t)(timeout.count() / 1000000), (long)(timeout.count() % 1000000) * 1000};
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&seg->doorbell), FUTEX_WAIT, bell, &ts, nullptr, 0);
+    }
+    seg->server_waiting.store(0, std::memory_order_relaxed);
+    return pending();
+}
+
+void HandShmServer::publish(const float *target, const float *pos, size_t n, bool synchronized) {
+    n = std::min(n, (size_t)seg->joints);
+    uint32_t s = seg->state_seq.load(std::memory_order_relaxed);
+    seg->state_seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    HandShmState &st = seg->state;
+    st.stamp_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    st.ack_id = last_id;
+    st.joints = (uint32_t)n;
+    st.synchronized = synchronized ? 1 : 0;
+    for (size_t i = 0; i < n; ++i) {
+        st.target[i] = target[i];
+        st.pos[i] = pos[i];
+    }
+
+    seg->state_seq.store(s + 2, std::memory_order_release);
+}
+
+void HandShmServer::publish(const HandState &st) {
+    publish(st.target, st.pos, st.joints, st.synchronized);
+}
@@ -0,0 +1,94 @@
+#include "joint_controller.hpp"
+#include <algorithm>
+#include <cmath>
+
+JointController::JointController(size_t joints)
+    : joints(std::min(joints, MAX_JOINTS)) {
+    for (size_t j = 0; j < MAX_JOINTS; ++j) {
+        active_version[j] = pending[j].version();
+        reset(j);
+    }
+}
+
+void JointController::set_gains(size_t joint, const Gains &gains) {
+    if (joint >= joints) return;
+    std::lock_guard<std::mutex> lock(gains_write_mutex);
+    pending[joint].store(gains);
+}
+
+void JointController::set_gains(const Gains &gains) {
+    for (size_t j = 0; j < joints; ++j) set_gains(j, gains);
+}
+
+JointController::Gains JointController::get_gains(size_t joint) const {
+    Gains g;
+    if (joint < joints) {
+        while (!pending[joint].try_load(g)) {}
+    }
+    return g;
+}
+
+void JointController::reset(size_t joint) {
+    if (joint >= MAX_JOINTS) return;
+    integral[joint] = 0.0f;
+    prev_error[joint] = 0.0f;
+    d_filtered[joint] = 0.0f;
+    has_prev[joint] = false;
+    saturated[joint] = false;
+}
+
+void JointController::reset() {
+    for (size_t j = 0; j < joints; ++j) reset(j);
+}
+
+void JointController::update(float dt, const float *ref, const float *ref_rate, const float *ref_acc,
+                             const float *meas, const float *meas_rate, float *out) {
+    for (size_t j = 0; j < joints; ++j) {
+        // New gains: take them if the copy is clean, else keep the old ones a tick longer
+        uint32_t v = pending[j].version();
+        if (v != active_version[j] && pending[j].try_load(active[j])) active_version[j] = v;
+        const Gains &g = active[j];
+
+        if (std::isnan(meas[j]) || dt <= 0.0f) {
+            out[j] = 0.0f;
+            continue;
+        }
+
+        float e = ref[j] - meas[j];
+        float r_rate = ref_rate ? ref_rate[j] : 0.0f;
+        float r_acc = ref_acc ? ref_acc[j] : 0.0f;
+
+        float de;
+        if (meas_rate && !std::isnan(meas_rate[j])) {
+            de = r_rate - meas_rate[j];
+        } else {
+            float raw = has_prev[j] ? (e - prev_error[j]) / dt : 0.0f;
+            if (g.d_cutoff_hz > 0.0f) {
+                float alpha = dt / (dt + 1.0f / (2.0f * (float)M_PI * g.d_cutoff_hz));
+                d_filtered[j] += alpha * (raw - d_filtered[j]);
+            } else {
+                d_filtered[j] = raw;
+            }
+            de = d_filtered[j];
+        }
+        prev_error[j] = e;
+        has_prev[j] = true;
+
+        float ff = g.kff_vel * r_rate + g.kff_acc * r_acc + g.bias;
+        float i_term = (g.law == Law::Pid) ? integral[j] : 0.0f;
+        float u = g.kp * e + i_term + g.kd * de + ff;
+        float u_sat = std::max(-g.out_limit, std::min(g.out_limit, u));
+        saturated[j] = (u != u_sat);
+        out[j] = u_sat;
+
+        if (g.law != Law::Pid || g.ki == 0.0f) continue;
+        float next = integral[j] + g.ki * e * dt;
+        if (g.anti_windup) {
+            // Integrate only while it can pull the output back inside the limit
+            bool winding = (u > g.out_limit && e > 0.0f) || (u < -g.out_limit && e < 0.0f);
+            if (!winding) integral[j] = std::max(-g.out_limit, std::min(g.out_limit, next));
+        } else {
+            integral[j] = next;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#include "joint_estimator.hpp"
+#include <algorithm>
+#include <cmath>
+
+JointEstimator::JointEstimator(size_t joints)
+    : JointEstimator(joints, Params()) {}
+
+JointEstimator::JointEstimator(size_t joints, const Params &params)
+    : joints(std::min(joints, MAX_JOINTS)), params(params) {
+    for (size_t j = 0; j < MAX_JOINTS; ++j) {
+        set_resolution(j, params.resolution);
+        latency[j] = 0.0;
+        reset(j);
+    }
+}
+
+void JointEstimator::set_resolution(size_t joint, float deg) {
+    if (joint >= MAX_JOINTS) return;
+    R[joint] = deg * deg / 12.0f + params.sensor_noise * params.sensor_noise;
+}
+
+void JointEstimator::observe_round_trip(size_t joint, double rtt_s) {
+    if (joint >= joints || rtt_s < 0.0) return;
+    // One-way latency, smoothed over ~10 samples
+    double one_way = 0.5 * rtt_s;
+    latency[joint] = (latency[joint] == 0.0) ? one_way : latency[joint] + 0.1 * (one_way - latency[joint]);
+}
+
+void JointEstimator::reset(size_t joint) {
+    if (joint >= MAX_JOINTS) return;
+    started[joint] = false;
+    p[joint] = v[joint] = a[joint] = 0.0f;
+    P00[joint] = P01[joint] = P02[joint] = P11[joint] = P12[joint] = P22[joint] = 0.0f;
+    t_meas[joint] = 0.0;
+}
+
+void JointEstimator::update(size_t joint, float pos_deg, double rx_time) {
+    if (joint >= joints || std::isnan(pos_deg)) return;
+    const size_t j = joint;
+    double t = rx_time - latency[j];
+
+    if (!started[j]) {
+        p[j] = pos_deg;
+        v[j] = 0.0f;
+        a[j] = 0.0f;
+        P00[j] = R[j];
+        P01[j] = P02[j] = P12[j] = 0.0f;
+        P11[j] = params.init_vel_std * params.init_vel_std;
+        P22[j] = params.init_acc_std * params.init_acc_std;
+        t_meas[j] = t;
+        started[j] = true;
+        return;
+    }
+
+    // Older than the state (reordered replies): nothing to gain from it
+    float dt = (float)(t - t_meas[j]);
+    if (dt < 0.0f) return;
+
+    // Predict: x = F x, P = F P F' + Q (white jerk)
+    float h = 0.5f * dt * dt;
+    p[j] += v[j] * dt + a[j] * h;
+    v[j] += a[j] * dt;
+
+    float r00 = P00[j] + dt * P01[j] + h * P02[j];
+    float r01 = P01[j] + dt * P11[j] + h * P12[j];
+    float r02 = P02[j] + dt * P12[j] + h * P22[j];
+    float r11 = P11[j] + dt * P12[j];
+    float r12 = P12[j] + dt * P22[j];
+
+    float q = params.jerk_density;
+    float dt2 = dt * dt, dt3 = dt2 * dt, dt4 = dt3 * dt, dt5 = dt4 * dt;
+    P00[j] = r00 + dt * r01 + h * r02 + q * dt5 / 20.0f;
+    P01[j] = r01 + dt * r02 + q * dt4 / 8.0f;
+    P02[j] = r02 + q * dt3 / 6.0f;
+    P11[j] = r11 + dt * r12 + q * dt3 / 3.0f;
+    P12[j] = r12 + q * dt2 / 2.0f;
+    P22[j] = P22[j] + q * dt;
+
+    // Update with H = [1 0 0]
+    float S = P00[j] + R[j];
+    float k0 = P00[j] / S, k1 = P01[j] / S, k2 = P02[j] / S;
+    float y = pos_deg - p[j];
+    p[j] += k0 * y;
+    v[j] += k1 * y;
+    a[j] += k2 * y;
+
+    float c00 = P00[j], c01 = P01[j], c02 = P02[j];
+    P00[j] = c00 - k0 * c00;
+    P01[j] = c01 - k0 * c01;
+    P02[j] = c02 - k0 * c02;
+    P11[j] = P11[j] - k1 * c01;
+    P12[j] = P12[j] - k1 * c02;
+    P22[j] = P22[j] - k2 * c02;
+
+    t_meas[j] = t;
+}
+
+void JointEstimator::update(const float *pos_deg, double rx_time) {
+    for (size_t j = 0; j < joints; ++j) update(j, pos_deg[j], rx_time);
+}
+
+void JointEstimator::predict(double t, float *pos_deg, float *vel_dps, float *acc_dps2) const {
+    for (size_t j = 0; j < joints; ++j) {
+        float dt = (float)(t - t_meas[j]);
+        float h = 0.5f * dt * dt;
+        float nan = started[j] ? 0.0f : NAN;
+        pos_deg[j] = p[j] + v[j] * dt + a[j] * h + nan;
+        vel_dps[j] = v[j] + a[j] * dt + nan;
+        if (acc_dps2) acc_dps2[j] = a[j] + nan;
+    }
+}
+
+float JointEstimator::get_pos_std(size_t joint) const {
+    return started[joint] ? std::sqrt(std::max(0.0f, P00[joint])) : NAN;
+}
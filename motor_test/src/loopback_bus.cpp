@@ -0,0 +1,84 @@
+#include "loopback_bus.hpp"
+#include "sim_motor.hpp"
+#include "trace.hpp"
+#include <algorithm>
+
+LoopbackBus::LoopbackBus(std::chrono::microseconds reply_delay) : reply_delay(reply_delay) {}
+
+bool LoopbackBus::attach(SimMotor *motor) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (motor_count >= MAX_MOTORS) return false;
+    motors[motor_count++] = motor;
+    return true;
+}
+
+void LoopbackBus::advance(std::chrono::microseconds dt) {
+    std::lock_guard<std::mutex> lock(mtx);
+    advance_locked(dt);
+}
+
+std::chrono::microseconds LoopbackBus::now() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return clock;
+}
+
+void LoopbackBus::advance_locked(std::chrono::microseconds dt) {
+    while (dt.count() > 0) {
+        auto step = std::min(dt, MODEL_STEP);
+        for (size_t i = 0; i < motor_count; ++i) motors[i]->step(step.count() * 1e-6f);
+        clock += step;
+        dt -= step;
+    }
+}
+
+bool LoopbackBus::send_msg(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls) {
+    (void)cls;
+    if (len > 8) return false;
+    TRACE_SPAN("can", "send_msg");
+    std::lock_guard<std::mutex> lock(mtx);
+    metrics.tx_frames.add();
+
+    for (size_t i = 0; i < motor_count; ++i) {
+        RxFrame reply;
+        if (!motors[i]->handle_frame(id, data, len, reply.id, reply.data)) continue;
+        if (rx_size == RX_CAPACITY) {
+            rx_overflows.add();
+            continue;
+        }
+        reply.due = clock + reply_delay;
+        reply.len = 8;
+        rx[(rx_head + rx_size++) % RX_CAPACITY] = reply;
+    }
+    return true;
+}
+
+void LoopbackBus::pop_locked(uint32_t &id, uint8_t *data, uint8_t &len) {
+    const RxFrame &f = rx[rx_head];
+    id = f.id;
+    len = f.len;
+    std::copy(f.data, f.data + f.len, data);
+    rx_head = (rx_head + 1) % RX_CAPACITY;
+    rx_size--;
+    metrics.rx_frames.add();
+}
+
+bool LoopbackBus::read_msg(uint32_t &id, std::vector<uint8_t> &data) {
+    TRACE_SPAN("can", "read_msg");
+    std::lock_guard<std::mutex> lock(mtx);
+    if (rx_size == 0) return false;
+    // Replies are queued in due order: waiting for this one is time passing
+    if (rx[rx_head].due > clock) advance_locked(rx[rx_head].due - clock);
+    uint8_t buf[8];
+    uint8_t len;
+    pop_locked(id, buf, len);
+    data.assign(buf, buf + len);
+    return true;
+}
+
+bool LoopbackBus::poll_msg(uint32_t &id, uint8_t *data, uint8_t &len) {
+    TRACE_SPAN("can", "poll_msg");
+    std::lock_guard<std::mutex> lock(mtx);
+    if (rx_size == 0 || rx[rx_head].due > clock) return false;
+    pop_locked(id, data, len);
+    return true;
+}
@@ -2,15 +2,73 @@
 #include <chrono>
 #include <thread>
 #include <cmath>
+#include <cstdlib>
 #include <memory> // For std::unique_ptr
 #include "motor_control.hpp"
 #include "can_bus.hpp"
+#include "contact_detector.hpp"
+#include "thermal_model.hpp"
+#include "trajectory.hpp"
+#include "motor_discovery.hpp"
+#include "fault_monitor.hpp"
+#include <vector>
 
 // Define placeholder CAN IDs (Please check these IDs for your specific setup)
 constexpr uint32_t LKTECH_CAN_ID = 0x141; // Common ID for LKtech motors
 constexpr uint32_t RMD_BIONIC_CAN_ID = 0x01;  // Example ID for RMD Bionic (often low, e.g., 0x01)
 constexpr uint32_t RMD_STANDARD_CAN_ID = 0x141; // Common ID for RMD Standard Motor 1
 
+// Control rate of batch mode
+constexpr auto BATCH_PERIOD = std::chrono::microseconds(2000);
+
+// Batch mode: motor_test <interface> --batch <waypoint file> [--blend <deg>] [<rmd|lk|bionic>:<id> ...]
+// Joint k of the waypoint file is the k-th motor given, or the k-th discovered
+// motor (sorted by protocol and ID) if none are given. With --blend the
+// waypoints run through a MotionQueue: look-ahead through same-direction
+// waypoints and reversals turned up to <deg> early (0: look-ahead only).
+int run_batch(CANBus &bus, const std::string &path, char **specs, int n_specs,
+              const std::vector<MotorInfo> &discovered, float blend_deg) {
+    std::vector<Waypoint> waypoints;
+    if (!load_waypoints(path, waypoints)) return 1;
+    std::vector<TrajectoryStep> steps = compile_trajectory(waypoints, BATCH_PERIOD);
+    std::cout << "Compiled " << steps.size() << " waypoints (" << steps.size() * sizeof(TrajectoryStep)
+              << " bytes) at " << BATCH_PERIOD.count() << " us per tick\n";
+
+    std::vector<MotorInfo> infos = discovered;
+    if (n_specs > 0) {
+        infos.clear();
+        for (int i = 0; i < n_specs; ++i) {
+            MotorInfo info;
+            if (!parse_motor_spec(specs[i], info)) {
+                std::cerr << "Bad motor '" << specs[i] << "', expected rmd:<id>, lk:<id> or bionic:<id>\n";
+                return 1;
+            }
+            infos.push_back(info);
+        }
+        if (enable_motors(&bus, infos) < infos.size()) {
+            disable_motors(&bus, infos);
+            return 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<MotorControl>> owned;
+    std::vector<MotorControl *> motors;
+    for (const MotorInfo &info : infos) {
+        owned.push_back(make_motor(info, &bus));
+        motors.push_back(owned.back().get());
+    }
+
+    TrajectoryRunner runner(&bus, motors.data(), motors.size());
+    MotionQueue queue(motors.size(), 2000.0f, std::isnan(blend_deg) ? 0.0f : blend_deg);
+    if (!std::isnan(blend_deg)) runner.set_motion_queue(&queue);
+    bool ok = runner.run(steps, BATCH_PERIOD);
+    if (ok) runner.report();
+
+    // The discovered motors are disabled by the caller
+    if (n_specs > 0) disable_motors(&bus, infos);
+    return ok ? 0 : 1;
+}
+
 void usage() {
     std::cout << "\n======================================================\n";
     std::cout << "  Motor Control Test Application\n";
@@ -22,15 +80,61 @@ void usage() {
     std::cout << "Enter selection (1, 2, or 3): ";
 }
 
-int main() {
-    std::cout << "Initializing CAN bus (can0)..." << std::endl;
-    CANBus bus("can0");
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+int main(int argc, char **argv) {
+    // Optional interface argument, e.g. vcan0 when running against motor_sim
+    std::string interface = argc > 1 ? argv[1] : "can0";
+    // CAN_BACKEND=io_uring selects the batched backend
+    CANBackend backend = can_backend_from_env();
+    std::cout << "Initializing CAN bus (" << interface << ", " << can_backend_name(backend) << ")..." << std::endl;
+    CANBus bus(interface, backend);
+
+    // --- Discovery: probe every protocol's ID range, enable with confirmed replies ---
+    std::vector<MotorInfo> found = discover_motors(&bus);
+    enable_motors(&bus, found);
+
+    if (argc > 3 && std::string(argv[2]) == "--batch") {
+        int first_spec = 4;
+        float blend_deg = NAN;
+        if (argc > 5 && std::string(argv[4]) == "--blend") {
+            blend_deg = std::strtof(argv[5], nullptr);
+            first_spec = 6;
+        }
+        int rc = run_batch(bus, argv[3], argv + first_spec, argc - first_spec, found, blend_deg);
+        disable_motors(&bus, found);
+        bus.shutdown();
+        return rc;
+    }
 
     std::unique_ptr<MotorControl> motor = nullptr;
     int selection = 0;
-    
-    // --- Motor Selection Loop ---
+
+    // --- Pick a discovered motor (no prompt if there is only one) ---
+    while (!motor && !found.empty()) {
+        selection = 1;
+        if (found.size() > 1) {
+            std::cout << "\nDiscovered motors:\n";
+            for (size_t i = 0; i < found.size(); ++i) {
+                std::cout << "  " << i + 1 << ". " << protocol_name(found[i].protocol) << " (ID: 0x"
+                          << std::hex << found[i].id << std::dec << ")" << (found[i].enabled ? "" : " not enabled") << "\n";
+            }
+            std::cout << "Enter selection (1-" << found.size() << "): ";
+            std::cin >> selection;
+            if (std::cin.fail()) {
+                std::cin.clear();
+                std::cin.ignore(10000, '\n');
+                continue;
+            }
+        }
+        if (selection < 1 || selection > (int)found.size()) {
+            std::cout << "Invalid selection. Please try again.\n";
+            continue;
+        }
+        motor = make_motor(found[selection - 1], &bus);
+        std::cout << "\nSelected: " << motor->get_name() << "\n";
+    }
+
+    // --- Nothing answered: manual selection with the default IDs ---
+    MotorInfo manual;
     while (!motor) {
         usage();
         std::cin >> selection;
@@ -44,14 +148,17 @@ int main() {
 
         switch (selection) {
             case 1:
+                manual = {MotorProtocol::LKtech, LKTECH_CAN_ID, false};
                 motor = std::make_unique<LKtech_Motor>(LKTECH_CAN_ID, &bus, "LKtech_MG6");
                 std::cout << "\nSelected: LKtech MG6 (ID: 0x" << std::hex << LKTECH_CAN_ID << std::dec << ")\n";
                 break;
             case 2:
+                manual = {MotorProtocol::Bionic, RMD_BIONIC_CAN_ID, false};
                 motor = std::make_unique<RMD_BionicMotor>(RMD_BIONIC_CAN_ID, &bus, "RMD_Bionic");
                 std::cout << "\nSelected: RMD Bionic (ID: 0x" << std::hex << RMD_BIONIC_CAN_ID << std::dec << ")\n";
                 break;
             case 3:
+                manual = {MotorProtocol::RMD, RMD_STANDARD_CAN_ID, false};
                 motor = std::make_unique<RMD_Motor>(RMD_STANDARD_CAN_ID, &bus, "RMD_Standard");
                 std::cout << "\nSelected: RMD Standard (ID: 0x" << std::hex << RMD_STANDARD_CAN_ID << std::dec << ")\n";
                 break;
@@ -62,13 +169,32 @@ int main() {
 
     // --- Motor Enable and Main Loop ---
     
-    // Command 0x81 (RMD motors) or 1 (LKtech motors) typically means enable/running
-    motor->set_state(0x81); 
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Command 0x81 (RMD motors) or 1 (LKtech motors) typically means enable/running;
+    // discovered motors are enabled already, a manual pick waits for its reply here
+    if (manual.id != 0) {
+        std::vector<MotorInfo> one{manual};
+        enable_motors(&bus, one);
+    }
+
+    // Stop a move at the object instead of stalling until the timeout
+    ContactDetector contact(1);
+    motor->set_contact_detector(&contact);
+
+    // Derate the current limit from the motor's reported temperature
+    ThermalModel thermal(1);
+    motor->set_thermal_model(&thermal, 0);
+
+    // Stop every motor on lost feedback, drive errors, over-temperature or Ctrl-C
+    FaultConfig fault_cfg;
+    fault_cfg.accept_local_frames = interface.compare(0, 4, "vcan") == 0;
+    FaultMonitor monitor(interface, fault_cfg);
+    if (manual.id != 0) monitor.add_motor(manual);
+    for (const MotorInfo &info : found) monitor.add_motor(info);
+    if (monitor.start()) motor->set_abort_flag(monitor.get_tripped_flag());
 
     std::cout << "Motor is ready. Type 'exit' to quit.\n" << std::endl;
 
-    while (true) {
+    while (!monitor.is_tripped()) {
         std::string pos_input;
         std::cout << "Enter ABSOLUTE target position (degrees): ";
         std::cin >> pos_input;
@@ -90,6 +216,7 @@ int main() {
         std::cout << "\n--- Moving motor ---" << std::endl;
 
         // --- Execute Movement based on selection ---
+        contact.reset(0);
         motor->move_and_monitor(target_deg, vel_rpm);
         
         std::cout << "--------------------\n" << std::endl;
@@ -97,7 +224,10 @@ int main() {
 
     // --- Cleanup ---
     // Command 0x80 (RMD) or 0 (LKtech) typically means motor stop/off
+    monitor.stop();
     motor->set_state(0x80);
+    // Discovery enabled every motor that answered, not just the one driven here
+    disable_motors(&bus, found);
     bus.shutdown();
 
     std::cout << "\nProgram terminated.\n" << std::endl;
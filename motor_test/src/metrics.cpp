@@ -0,0 +1,19 @@
+#include "metrics.hpp"
+
+uint64_t LatencyHistogram::count() const {
+    uint64_t n = 0;
+    for (const auto &b : buckets) n += b.load(std::memory_order_relaxed);
+    return n;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+    uint64_t rank = (uint64_t)(p * (double)(n - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        seen += buckets[b].load(std::memory_order_relaxed);
+        if (seen >= rank) return bucket_upper(b);
+    }
+    return bucket_upper(BUCKETS - 1);
+}
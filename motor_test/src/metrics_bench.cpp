@@ -0,0 +1,65 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "metrics.hpp"
+#include "metrics_exporter.hpp"
+#include "motor_control.hpp"
+#include "sim_motor.hpp"
+
+// Cost of the hot-path metric updates, and of decoding a reply with its
+// counter, on this machine; then a sample export of one simulated motor.
+// Numbers are only meaningful in an optimized build (-DCMAKE_BUILD_TYPE=Release).
+//   ./metrics_bench [iterations] [snapshot file]
+template <typename F>
+double ns_per_call(int n, F &&fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+int main(int argc, char **argv) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    if (n <= 0) return 1;
+
+    // Latency-like values: mostly ~200 us with a long tail
+    std::mt19937_64 rng(1);
+    std::lognormal_distribution<double> dist(std::log(200000.0), 0.5);
+    std::vector<uint64_t> samples(4096);
+    for (auto &s : samples) s = (uint64_t)dist(rng);
+
+    MetricCounter counter;
+    SharedMetricCounter shared;
+    LatencyHistogram hist;
+    double baseline = ns_per_call(n, [&](int i) { asm volatile("" : : "r"(samples[i & 4095]) : "memory"); });
+    double add_ns = ns_per_call(n, [&](int) { counter.add(); });
+    double shared_ns = ns_per_call(n, [&](int) { shared.add(); });
+    double rec_ns = ns_per_call(n, [&](int i) { hist.record(samples[i & 4095]); });
+
+    // Real hot path: decode an RMD command reply (counted in the motor's metrics)
+    SimRMDMotor sim(0x141);
+    RMD_Motor motor(0x141, nullptr, "RMD_Sim");
+    uint8_t cmd[8], reply[8];
+    uint32_t reply_id = 0;
+    motor.encode_current(0.5f, cmd);
+    sim.handle_frame(0x141, cmd, 8, reply_id, reply);
+    double decode_ns = ns_per_call(n, [&](int) { motor.decode_reply(reply_id, reply, 8); });
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "[metrics_bench] " << n << " updates: loop " << baseline << " ns, counter add "
+              << add_ns - baseline << " ns, shared add " << shared_ns - baseline << " ns, histogram record " << rec_ns - baseline << " ns, RMD decode + count "
+              << decode_ns - baseline << " ns" << std::endl;
+    std::cout << "[metrics_bench] histogram p50 " << hist.percentile(0.5) / 1000.0 << " us, p99 "
+              << hist.percentile(0.99) / 1000.0 << " us, p99.9 " << hist.percentile(0.999) / 1000.0
+              << " us (" << hist.count() << " samples, " << motor.get_metrics().rx_frames.get() << " replies)" << std::endl;
+
+    if (argc > 2) {
+        MetricsExporter exporter(argv[2]);
+        exporter.add_motor(&motor);
+        if (!exporter.write_snapshot()) return 1;
+        std::cout << "[metrics_bench] Snapshot written to " << argv[2] << std::endl;
+    }
+    return 0;
+}
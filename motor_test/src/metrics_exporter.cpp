@@ -0,0 +1,167 @@
+#include "metrics_exporter.hpp"
+#include <iostream>
+#include <cstdio>
+
+// Histogram buckets are exported at powers of two from ~1 us to ~17 s; the
+// finer HDR buckets stay in memory for percentiles
+constexpr unsigned EXPORT_MIN_BITS = 10;
+constexpr unsigned EXPORT_MAX_BITS = 34;
+
+static void append_family(std::string &out, const char *name, const char *type, const char *help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+static void append_sample(std::string &out, const char *name, const char *suffix, const std::string &labels,
+                          const char *value) {
+    out += name;
+    out += suffix;
+    out += '{';
+    out += labels;
+    out += "} ";
+    out += value;
+    out += '\n';
+}
+
+static void append_counter(std::string &out, const char *name, const std::string &labels, uint64_t v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+    append_sample(out, name, "", labels, buf);
+}
+
+static void append_histogram(std::string &out, const char *name, const std::string &labels,
+                             const LatencyHistogram &h) {
+    // Buckets read once, so the cumulative counts and _count agree
+    uint64_t counts[LatencyHistogram::BUCKETS];
+    uint64_t total = 0;
+    for (size_t b = 0; b < LatencyHistogram::BUCKETS; ++b) total += counts[b] = h.bucket_count(b);
+
+    char value[32];
+    size_t b = 0;
+    uint64_t cumulative = 0;
+    for (unsigned bits = EXPORT_MIN_BITS; bits <= EXPORT_MAX_BITS; ++bits) {
+        uint64_t le_ns = 1ULL << bits;
+        // Everything below 2^bits, i.e. <= le
+        for (; b < LatencyHistogram::bucket_of(le_ns); ++b) cumulative += counts[b];
+        char le[48];
+        std::snprintf(le, sizeof(le), ",le=\"%.9g\"", (double)le_ns * 1e-9);
+        std::snprintf(value, sizeof(value), "%llu", (unsigned long long)cumulative);
+        append_sample(out, name, "_bucket", labels + le, value);
+    }
+    std::snprintf(value, sizeof(value), "%llu", (unsigned long long)total);
+    append_sample(out, name, "_bucket", labels + ",le=\"+Inf\"", value);
+    std::snprintf(value, sizeof(value), "%.9g", (double)h.sum_ns() * 1e-9);
+    append_sample(out, name, "_sum", labels, value);
+    std::snprintf(value, sizeof(value), "%llu", (unsigned long long)total);
+    append_sample(out, name, "_count", labels, value);
+}
+
+MetricsExporter::MetricsExporter(const std::string &path, std::chrono::milliseconds period)
+    : path(path), period(period) {}
+
+MetricsExporter::~MetricsExporter() { stop(); }
+
+bool MetricsExporter::add_bus(const std::string &name, CanTransport *bus) {
+    if (bus_count >= MAX_BUSES || loop.is_running()) return false;
+    bus_names[bus_count] = name;
+    buses[bus_count++] = bus;
+    return true;
+}
+
+bool MetricsExporter::add_motor(const MotorControl *motor) {
+    if (motor_count >= MAX_MOTORS || loop.is_running()) return false;
+    motors[motor_count++] = motor;
+    return true;
+}
+
+bool MetricsExporter::start() {
+    if (!loop.start(std::chrono::duration_cast<std::chrono::microseconds>(period), [this] { write_snapshot(); }))
+        return false;
+    std::cout << "[MetricsExporter] Writing " << path << " every " << period.count() << " ms" << std::endl;
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!loop.is_running()) return;
+    loop.stop();
+    write_snapshot();
+}
+
+std::string MetricsExporter::render() {
+    std::string out;
+    out.reserve(4096 + 8192 * (bus_count + motor_count));
+
+    std::string labels[MAX_BUSES];
+    for (size_t i = 0; i < bus_count; ++i) labels[i] = "bus=\"" + bus_names[i] + "\"";
+
+    append_family(out, "can_tx_frames_total", "counter", "Frames written to the socket.");
+    for (size_t i = 0; i < bus_count; ++i) append_counter(out, "can_tx_frames_total", labels[i], buses[i]->get_metrics().tx_frames.get());
+    append_family(out, "can_rx_frames_total", "counter", "Frames received.");
+    for (size_t i = 0; i < bus_count; ++i) append_counter(out, "can_rx_frames_total", labels[i], buses[i]->get_metrics().rx_frames.get());
+    append_family(out, "can_rx_local_dropped_total", "counter", "Frames from other local sockets filtered out.");
+    for (size_t i = 0; i < bus_count; ++i) append_counter(out, "can_rx_local_dropped_total", labels[i], buses[i]->get_metrics().rx_local_dropped.get());
+
+    // TX scheduler, per priority class
+    static const char *CLASS_NAMES[TX_CLASSES] = {"safety", "setpoint", "poll"};
+    TxStats stats[MAX_BUSES];
+    for (size_t i = 0; i < bus_count; ++i) stats[i] = buses[i]->get_tx_stats();
+    append_family(out, "can_tx_queued_total", "counter", "Frames that waited for room in the kernel TX queue.");
+    for (size_t i = 0; i < bus_count; ++i)
+        for (size_t c = 0; c < TX_CLASSES; ++c)
+            append_counter(out, "can_tx_queued_total", labels[i] + ",class=\"" + CLASS_NAMES[c] + "\"", stats[i].queued[c]);
+    append_family(out, "can_tx_retried_total", "counter", "Waiting frames written later.");
+    for (size_t i = 0; i < bus_count; ++i)
+        for (size_t c = 0; c < TX_CLASSES; ++c)
+            append_counter(out, "can_tx_retried_total", labels[i] + ",class=\"" + CLASS_NAMES[c] + "\"", stats[i].retried[c]);
+    append_family(out, "can_tx_dropped_total", "counter", "Frames rejected by a full queue or failed for good.");
+    for (size_t i = 0; i < bus_count; ++i)
+        for (size_t c = 0; c < TX_CLASSES; ++c)
+            append_counter(out, "can_tx_dropped_total", labels[i] + ",class=\"" + CLASS_NAMES[c] + "\"", stats[i].dropped[c]);
+    append_family(out, "can_tx_superseded_total", "counter", "Queued setpoints replaced by a newer one.");
+    for (size_t i = 0; i < bus_count; ++i) append_counter(out, "can_tx_superseded_total", labels[i], stats[i].superseded);
+    append_family(out, "can_read_wait_seconds", "histogram", "Time blocked in read_msg().");
+    for (size_t i = 0; i < bus_count; ++i) append_histogram(out, "can_read_wait_seconds", labels[i], buses[i]->get_metrics().read_wait);
+
+    std::string motor_labels[MAX_MOTORS];
+    for (size_t i = 0; i < motor_count; ++i) {
+        char id[16];
+        std::snprintf(id, sizeof(id), "0x%X", (unsigned)motors[i]->get_id());
+        motor_labels[i] = "motor=\"" + motors[i]->get_name() + "\",id=\"" + id + "\"";
+    }
+    append_family(out, "motor_tx_frames_total", "counter", "Frames sent to the motor.");
+    for (size_t i = 0; i < motor_count; ++i) append_counter(out, "motor_tx_frames_total", motor_labels[i], motors[i]->get_metrics().tx_frames.get());
+    append_family(out, "motor_rx_frames_total", "counter", "Replies decoded.");
+    for (size_t i = 0; i < motor_count; ++i) append_counter(out, "motor_rx_frames_total", motor_labels[i], motors[i]->get_metrics().rx_frames.get());
+    append_family(out, "motor_read_timeouts_total", "counter", "Blocking reads that gave up without a reply.");
+    for (size_t i = 0; i < motor_count; ++i) append_counter(out, "motor_read_timeouts_total", motor_labels[i], motors[i]->get_metrics().read_timeouts.get());
+    append_family(out, "motor_read_retries_total", "counter", "Frames or failed reads skipped while waiting for a reply.");
+    for (size_t i = 0; i < motor_count; ++i) append_counter(out, "motor_read_retries_total", motor_labels[i], motors[i]->get_metrics().read_retries.get());
+    append_family(out, "motor_reply_latency_seconds", "histogram", "Request sent to reply decoded, blocking reads.");
+    for (size_t i = 0; i < motor_count; ++i) append_histogram(out, "motor_reply_latency_seconds", motor_labels[i], motors[i]->get_metrics().reply_latency);
+    return out;
+}
+
+bool MetricsExporter::write_snapshot() {
+    std::string text = render();
+    std::string tmp = path + ".tmp";
+    FILE *f = std::fopen(tmp.c_str(), "w");
+    if (!f) {
+        perror("Metrics snapshot open failed");
+        return false;
+    }
+    bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        perror("Metrics snapshot write failed");
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#include "motion_queue.hpp"
+#include <algorithm>
+#include <cmath>
+
+MotionQueue::MotionQueue(size_t joints, float accel_dps2, float blend_deg)
+    : n(std::min(joints, MAX_JOINTS)), accel(accel_dps2), blend(blend_deg) {}
+
+void MotionQueue::reset(size_t joint, float pos_deg) {
+    if (joint >= n) return;
+    Joint &j = joints[joint];
+    j.head = 0;
+    j.count = 0;
+    j.pos = pos_deg;
+    j.speed = 0.0f;
+}
+
+bool MotionQueue::push(size_t joint, float target_deg, float vel_dps) {
+    if (joint >= n || !(vel_dps != 0.0f)) return false;
+    Joint &j = joints[joint];
+    if (j.count >= DEPTH) return false;
+
+    Segment &s = j.seg[(j.head + j.count) % DEPTH];
+    s.end = target_deg;
+    s.vmax = std::abs(vel_dps);
+    j.count++;
+    plan(j);
+    return true;
+}
+
+void MotionQueue::set_lookahead(bool enable) {
+    lookahead = enable;
+    for (size_t i = 0; i < n; ++i) plan(joints[i]);
+}
+
+void MotionQueue::set_blend_radius(float deg) {
+    blend = std::max(0.0f, deg);
+    for (size_t i = 0; i < n; ++i) plan(joints[i]);
+}
+
+bool MotionQueue::idle() const {
+    for (size_t i = 0; i < n; ++i) {
+        if (joints[i].count > 0) return false;
+    }
+    return true;
+}
+
+// Recomputes goals and exit speeds of the queued segments (backward pass).
+// The head segment is in progress: its start is the current position.
+void MotionQueue::plan(Joint &j) {
+    if (j.count == 0) return;
+
+    // Directions and reversal blends, front to back
+    float start = j.pos;
+    for (size_t k = 0; k < j.count; ++k) {
+        Segment &s = at(j, k);
+        float d = s.end - start;
+        s.dir = (d > 0.0f) ? 1 : (d < 0.0f ? -1 : 0);
+        s.goal = s.end;
+        start = s.end;
+    }
+    if (lookahead && blend > 0.0f) {
+        for (size_t k = 0; k + 1 < j.count; ++k) {
+            Segment &s = at(j, k);
+            Segment &next = at(j, k + 1);
+            if (s.dir == 0 || next.dir == 0 || s.dir == next.dir) continue;
+            // Turn early, but never past half of either neighbouring segment
+            float seg_start = (k == 0) ? j.pos : at(j, k - 1).end;
+            float len_in = std::abs(s.end - seg_start);
+            float len_out = std::abs(next.end - s.end);
+            float r = std::min(blend, 0.5f * std::min(len_in, len_out));
+            if (k == 0) r = std::min(r, std::abs(s.end - j.pos)); // head already under way
+            s.goal = s.end - s.dir * r;
+        }
+    }
+
+    // Exit speeds, back to front: the last segment ends at rest
+    float next_entry_cap = 0.0f; // fastest speed at which the rest can still stop in time
+    for (size_t k = j.count; k-- > 0;) {
+        Segment &s = at(j, k);
+        float exit = 0.0f;
+        if (lookahead && k + 1 < j.count) {
+            const Segment &next = at(j, k + 1);
+            if (s.dir != 0 && s.dir == next.dir) exit = std::min({s.vmax, next.vmax, next_entry_cap});
+        }
+        s.exit = exit;
+
+        float seg_start = (k == 0) ? j.pos : at(j, k - 1).goal;
+        float len = std::abs(s.goal - seg_start);
+        next_entry_cap = std::sqrt(exit * exit + 2.0f * accel * len);
+    }
+}
+
+void MotionQueue::pop(Joint &j) {
+    j.head = (j.head + 1) % DEPTH;
+    j.count--;
+}
+
+void MotionQueue::step(float dt, float *setpoint_deg, float *velocity_dps) {
+    for (size_t i = 0; i < n; ++i) {
+        Joint &j = joints[i];
+        float t = dt;
+
+        // Consume the time slice, possibly across several short segments
+        while (j.count > 0 && t > 0.0f) {
+            Segment &s = at(j, 0);
+            float remaining = (s.goal - j.pos) * s.dir;
+            if (s.dir == 0 || remaining <= 0.0f) {
+                j.pos = s.goal;
+                j.speed = (s.dir != 0) ? std::min(j.speed, s.exit) : 0.0f;
+                int8_t dir = s.dir;
+                pop(j);
+                if (j.count > 0 && at(j, 0).dir != dir) j.speed = 0.0f;
+                plan(j);
+                continue;
+            }
+
+            // Accelerate, cruise, or brake so the planned exit speed is met
+            float brake = std::sqrt(s.exit * s.exit + 2.0f * accel * remaining);
+            float v = std::min({s.vmax, j.speed + accel * t, brake});
+            v = std::max(v, 0.0f);
+            float travel = 0.5f * (j.speed + v) * t;
+
+            if (travel >= remaining && v > 0.0f) {
+                // Reaches the goal inside this slice: carry the rest of the time over
+                float used = remaining / std::max(0.5f * (j.speed + v), 1e-6f);
+                j.pos = s.goal;
+                j.speed = std::min(v, s.exit);
+                t -= std::min(used, t);
+                int8_t dir = s.dir;
+                pop(j);
+                if (j.count > 0 && at(j, 0).dir != dir) j.speed = 0.0f;
+                plan(j);
+            } else {
+                j.pos += s.dir * travel;
+                j.speed = v;
+                t = 0.0f;
+            }
+        }
+        if (j.count == 0) j.speed = 0.0f;
+
+        setpoint_deg[i] = j.pos;
+        if (velocity_dps) velocity_dps[i] = (j.count > 0) ? at(j, 0).dir * j.speed : 0.0f;
+    }
+}
@@ -1,4 +1,5 @@
 #include "motor_control.hpp"
+#include "trace.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -8,23 +9,168 @@
 // ===============================================================
 // Base MotorControl Implementation
 // ===============================================================
-MotorControl::MotorControl(uint32_t id, CANBus *bus, const std::string &name)
+MotorControl::MotorControl(uint32_t id, CanTransport *bus, const std::string &name)
     : id(id), bus(bus), name(name) {}
 
+size_t MotorControl::drain_pending() {
+    uint32_t rid;
+    uint8_t data[8];
+    uint8_t len;
+    size_t decoded = 0;
+
+    while (bus->poll_msg(rid, data, len)) {
+        TRACE_SPAN("motor", "decode");
+        if (decode_reply(rid, data, len)) decoded++;
+    }
+    return decoded;
+}
+
+bool MotorControl::read_reply() {
+    if (drain_pending() > 0) return true;
+
+    uint32_t rid;
+    std::vector<uint8_t> data;
+
+    for (int i = 0; i < 20; ++i) {
+        if (!bus->read_msg(rid, data)) {
+            metrics.read_retries.add();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        TRACE_SPAN("motor", "decode");
+        if (decode_reply(rid, data.data(), data.size())) return true;
+        metrics.read_retries.add();
+    }
+    metrics.read_timeouts.add();
+    return false;
+}
+
+void MotorControl::report_bus_usage(uint64_t frames_before, int ticks) const {
+    if (ticks <= 0) return;
+    float per_tick = (float)(bus_frames() - frames_before) / (float)ticks;
+    std::cout << "[" << name << "] " << ticks << " ticks, " << per_tick << " frames/tick ("
+              << (passive_feedback ? "passive" : "polled") << " feedback)" << std::endl;
+}
+
+bool MotorControl::check_contact(float dt, float target_deg, float vel_rpm) {
+    if (!contact_detector || std::isnan(state.current)) return false;
+    // Decelerating from v over the settle time covers at most v * t / 2
+    float brake_deg = std::abs(vel_rpm) * 6.0f * contact_detector->get_settle() * 0.5f;
+    uint32_t armed = !std::isnan(state.pos) && std::abs(target_deg - state.pos) > brake_deg;
+    return (contact_detector->update(&state.current, dt, armed) & 0x1) != 0;
+}
+
+void MotorControl::report_contact(std::chrono::steady_clock::time_point detected_at) const {
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - detected_at).count();
+    std::cout << "\n[" << name << "] Contact at " << state.pos << " deg (" << state.current
+              << " A), holding. Spike-to-stop latency: " << latency << " us" << std::endl;
+}
+
+void MotorControl::update_thermal(float dt) {
+    if (!thermal || std::isnan(state.current)) return;
+    thermal->update_joint(thermal_joint, state.current, state.temp, dt);
+}
+
+bool MotorControl::current_write(float amps) {
+    if (thermal) amps = thermal->derate(thermal_joint, amps);
+    uint8_t payload[8];
+    {
+        TRACE_SPAN("motor", "encode");
+        if (!encode_current(amps, payload)) return false;
+    }
+    return send_frame(payload);
+}
+
+bool MotorControl::velocity_write(float rpm) {
+    uint8_t payload[8];
+    {
+        TRACE_SPAN("motor", "encode");
+        if (!encode_velocity(rpm, payload)) return false;
+    }
+    return send_frame(payload);
+}
+
+bool MotorControl::position_request() {
+    uint8_t req[8];
+    if (!encode_position_request(req)) return false;
+    return send_frame(req, TxClass::Poll);
+}
+
+bool MotorControl::send_setpoint(const uint8_t *payload) {
+    if (command_reply_has_position()) return send_frame(payload);
+    bool ok = !std::isnan(state.pos) && send_frame(payload);
+    position_request();
+    return ok;
+}
+
+bool MotorControl::setpoint_write(float pos_deg, float vel_rpm) {
+    uint8_t payload[8];
+    {
+        TRACE_SPAN("motor", "encode");
+        if (!encode_position(pos_deg, vel_rpm, payload)) return false;
+    }
+    return send_setpoint(payload);
+}
+
+bool MotorControl::setpoint_write(float pos_deg, float vel_rpm, float cur) {
+    uint8_t payload[8];
+    {
+        TRACE_SPAN("motor", "encode");
+        if (!encode_position(pos_deg, vel_rpm, cur, payload)) return false;
+    }
+    return send_setpoint(payload);
+}
+
+void drain_replies(CanTransport *bus, MotorControl *const *motors, size_t count) {
+    uint32_t rid;
+    uint8_t data[8];
+    uint8_t len;
+
+    while (bus->poll_msg(rid, data, len)) {
+        TRACE_SPAN("motor", "decode");
+        for (size_t i = 0; i < count; ++i) {
+            if (motors[i]->decode_reply(rid, data, len)) break;
+        }
+    }
+}
+
+// Helper: little-endian int16 from a reply payload
+static int16_t le_int16(const uint8_t *d) {
+    return (int16_t)((uint16_t)d[0] | ((uint16_t)d[1] << 8));
+}
+
+// Helper: saturating float -> int16 for command fields
+static int16_t to_int16(float v) {
+    return (int16_t)std::max(-32768.0f, std::min(32767.0f, std::round(v)));
+}
+
+// Helper: 0xA2 speed closed loop, int32 speedControl in 0.01 dps (little-endian)
+static void encode_speed_a2(float dps, uint8_t *out) {
+    double raw = std::round((double)dps * 100.0);
+    int32_t v = (int32_t)std::max(-2147483648.0, std::min(2147483647.0, raw));
+    std::fill(out, out + 8, 0);
+    out[0] = 0xA2;
+    out[4] = v & 0xFF;
+    out[5] = (v >> 8) & 0xFF;
+    out[6] = (v >> 16) & 0xFF;
+    out[7] = (v >> 24) & 0xFF;
+}
+
 // ===============================================================
 // LKtech_Motor Implementation
 // ===============================================================
-LKtech_Motor::LKtech_Motor(uint32_t id, CANBus *bus, const std::string &name)
+LKtech_Motor::LKtech_Motor(uint32_t id, CanTransport *bus, const std::string &name)
     : MotorControl(id, bus, name) {}
 
 void LKtech_Motor::set_state(int cmd) {
-    std::vector<uint8_t> payload(8, 0);
+    uint8_t payload[8] = {};
     payload[0] = static_cast<uint8_t>(cmd);
-    bus->send_msg(id, payload);
+    send_frame(payload, TxClass::Safety);
 }
 
-std::vector<uint8_t> LKtech_Motor::position_write(float pos_deg, float vel_rpm) {
-    std::vector<uint8_t> payload(8, 0);
+bool LKtech_Motor::position_write(float pos_deg, float vel_rpm) {
+    uint8_t payload[8] = {};
     int32_t pos_int = (int32_t)(pos_deg * 3600.0f);
     uint16_t vel_raw = (uint16_t)(std::abs(vel_rpm) * 6.0f * 36.0f);
     // uint8_t vel_dir = (vel_rpm < 0) ? 1 : 0;
@@ -41,23 +187,33 @@ std::vector<uint8_t> LKtech_Motor::position_write(float pos_deg, float vel_rpm)
     payload[6] = (pos_int >> 16) & 0xFF;
     payload[7] = (pos_int >> 24) & 0xFF;
 
-    bus->send_msg(id, payload);
-    return payload;
+    return send_frame(payload);
 }
 
 float LKtech_Motor::position_read() {
-    std::vector<uint8_t> req(8, 0);
+    uint8_t req[8] = {};
     req[0] = 0x94; // Read position command
-    bus->send_msg(id, req);
+    drain_pending();
+    send_frame(req, TxClass::Poll);
+    auto sent = std::chrono::steady_clock::now();
 
     uint32_t r_id;
     std::vector<uint8_t> data;
 
     // Wait for response
     for (int i = 0; i < 20; i++) {
-        if (!bus->read_msg(r_id, data)) continue;
-        if (r_id != id) continue;
-        if (data.size() < 8) continue;
+        if (!bus->read_msg(r_id, data) || r_id != id || data.size() < 8) {
+            metrics.read_retries.add();
+            continue;
+        }
+        // Status replies (0x9A heartbeats) share the ID: only 0x94 carries the angle
+        if (data[0] != 0x94) {
+            decode_reply(r_id, data.data(), data.size());
+            metrics.read_retries.add();
+            continue;
+        }
+        metrics.rx_frames.add();
+        metrics.reply_latency.record(std::chrono::steady_clock::now() - sent);
 
         uint32_t raw = 
             (uint32_t)data[4] |
@@ -68,6 +224,7 @@ float LKtech_Motor::position_read() {
         float pos_deg = (float)raw / 3600.0f;
         return std::round(pos_deg * 100.0f) / 100.0f; 
     }
+    metrics.read_timeouts.add();
     return -1.0f; 
 }
 
@@ -75,6 +232,77 @@ float LKtech_Motor::read_feedback() {
     return position_read();
 }
 
+bool LKtech_Motor::decode_reply(uint32_t rid, const uint8_t *data, size_t len) {
+    if (rid != id || len < 8) return false;
+
+    switch (data[0]) {
+        case 0x94: {
+            uint32_t raw = (uint32_t)data[4] | ((uint32_t)data[5] << 8) |
+                           ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+            state.pos = std::round((float)raw / 3600.0f * 100.0f) / 100.0f;
+            metrics.rx_frames.add();
+            return true;
+        }
+        case 0x9A:
+            // Status 1: temp, voltage (0.1 V), error flags (bit 0 under-voltage, bit 3 over-temperature)
+            state.temp = (float)(int8_t)data[1];
+            state.err_msg = data[7];
+            metrics.rx_frames.add();
+            return true;
+        case 0x9C: case 0xA1: case 0xA2: case 0xA6:
+            // Same layout as 0x9C: temp, iq (-2048..2048 = -33..33 A), speed (dps), encoder.
+            // The encoder field is raw single-turn counts, so position still needs 0x94.
+            state.temp = (float)(int8_t)data[1];
+            state.current = (float)le_int16(&data[2]) * 33.0f / 2048.0f;
+            state.vel = (float)le_int16(&data[4]) / (6.0f * 36.0f);
+            metrics.rx_frames.add();
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool LKtech_Motor::encode_current(float amps, uint8_t *out) const {
+    // 0xA1 torque closed loop: iqControl -2000..2000 maps to -32..32 A
+    int16_t iq = to_int16(std::max(-2000.0f, std::min(2000.0f, amps * 2000.0f / 32.0f)));
+    std::fill(out, out + 8, 0);
+    out[0] = 0xA1;
+    out[4] = iq & 0xFF;
+    out[5] = (iq >> 8) & 0xFF;
+    return true;
+}
+
+bool LKtech_Motor::encode_velocity(float rpm, uint8_t *out) const {
+    // Motor-side speed, same 36:1 scaling as position_write
+    encode_speed_a2(rpm * 6.0f * 36.0f, out);
+    return true;
+}
+
+bool LKtech_Motor::encode_position(float pos_deg, float vel_rpm, uint8_t *out) const {
+    // 0xA6 single-turn position; spin direction from the last decoded position
+    // (the 0x94 read setpoint_write() sends along) instead of the blocking
+    // read position_write() does
+    int32_t pos_int = (int32_t)(pos_deg * 3600.0f);
+    uint16_t vel_raw = (uint16_t)(std::abs(vel_rpm) * 6.0f * 36.0f);
+    uint8_t vel_dir = (!std::isnan(state.pos) && pos_deg < state.pos) ? 1 : 0;
+
+    out[0] = 0xA6;
+    out[1] = vel_dir;
+    out[2] = vel_raw & 0xFF;
+    out[3] = (vel_raw >> 8) & 0xFF;
+    out[4] = pos_int & 0xFF;
+    out[5] = (pos_int >> 8) & 0xFF;
+    out[6] = (pos_int >> 16) & 0xFF;
+    out[7] = (pos_int >> 24) & 0xFF;
+    return true;
+}
+
+bool LKtech_Motor::encode_position_request(uint8_t *out) const {
+    std::fill(out, out + 8, 0);
+    out[0] = 0x94;
+    return true;
+}
+
 void LKtech_Motor::move_and_monitor(float target_deg, float vel_rpm) 
 {
     if (target_deg < 0 || target_deg > 360){ 
@@ -95,11 +323,20 @@ void LKtech_Motor::move_and_monitor(float target_deg, float vel_rpm)
 
     	for (;;) {
 		    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		    if (aborted()) {
+		        std::cerr << "\n[" << name << "] Move aborted.\n";
+		        break;
+		    }
 		    float current_pos_raw = position_read();
 
 		    if (current_pos_raw < -0.9f) {
 		        std::cout << "Feedback lost...\r";
 		        std::cout.flush();
+		        // A motor that never answers again must not hang the loop
+		        if (std::chrono::steady_clock::now() - start_time > max_duration) {
+		            std::cerr << "\n[" << name << "] Warning: Timeout, no feedback.\n";
+		            break;
+		        }
 		        continue;
 		    }
 
@@ -123,57 +360,69 @@ void LKtech_Motor::move_and_monitor(float target_deg, float vel_rpm)
 // ===============================================================
 // RMD_Motor Implementation
 // ===============================================================
-RMD_Motor::RMD_Motor(uint32_t id, CANBus *bus, const std::string &name)
+RMD_Motor::RMD_Motor(uint32_t id, CanTransport *bus, const std::string &name)
     : MotorControl(id, bus, name) {}
 
 void RMD_Motor::set_state(int cmd) {
-    std::vector<uint8_t> payload(8, 0);
+    uint8_t payload[8] = {};
     payload[0] = (uint8_t)cmd; 
-    bus->send_msg(id, payload);
+    send_frame(payload, TxClass::Safety);
     std::cout << "[" << name << "] Sent set state command 0x" << std::hex << cmd << std::dec << std::endl;
 }
 
-std::vector<uint8_t> RMD_Motor::position_write(float pos, float vel) {
-    std::vector<uint8_t> payload(8, 0);
+bool RMD_Motor::position_write(float pos, float vel) {
+    uint8_t payload[8] = {};
+    encode_position(pos, vel, payload);
+    return send_frame(payload);
+}
+
+bool RMD_Motor::encode_position(float pos, float vel, uint8_t *out) const {
     int32_t p = (int32_t)(pos * 100.0f);
     uint16_t vel_raw = (uint16_t)(std::abs(vel) * 6.0f);
     uint8_t vel_dir = (vel < 0.0f) ? 0x00 : 0x01;
     
-    payload[0] = 0xA4; 
-    payload[1] = vel_dir; 
-    payload[2] = vel_raw & 0xFF;
-    payload[3] = (vel_raw >> 8) & 0xFF;
-    payload[4] = p & 0xFF;
-    payload[5] = (p >> 8) & 0xFF;
-    payload[6] = (p >> 16) & 0xFF;
-    payload[7] = (p >> 24) & 0xFF;
-
-    bus->send_msg(id, payload);
-    return payload;
+    out[0] = 0xA4; 
+    out[1] = vel_dir; 
+    out[2] = vel_raw & 0xFF;
+    out[3] = (vel_raw >> 8) & 0xFF;
+    out[4] = p & 0xFF;
+    out[5] = (p >> 8) & 0xFF;
+    out[6] = (p >> 16) & 0xFF;
+    out[7] = (p >> 24) & 0xFF;
+    return true;
 }
 
 float RMD_Motor::position_read() {
-    std::vector<uint8_t> req(8, 0);
+    uint8_t req[8] = {};
     req[0] = 0x92; // Read multi-turn position
-    bus->send_msg(id, req); 
+    drain_pending();
+    send_frame(req, TxClass::Poll);
+    auto sent = std::chrono::steady_clock::now();
 
     uint32_t r_id;
     std::vector<uint8_t> data;
     
     for (int i = 0; i < 20; ++i) {
         if (!bus->read_msg(r_id, data)) {
+             metrics.read_retries.add();
              std::this_thread::sleep_for(std::chrono::milliseconds(5));
              continue;
         }
         
         // Response check 
-        if (r_id != 0x241) continue; // The original C++ used a fixed ID 0x241
-        if (data.size() < 8 || data[0] != 0x92) continue;
+        // The original C++ used a fixed ID 0x241
+        if (r_id != 0x241 || data.size() < 8 || data[0] != 0x92) {
+            metrics.read_retries.add();
+            continue;
+        }
+        metrics.rx_frames.add();
+        metrics.reply_latency.record(std::chrono::steady_clock::now() - sent);
 
         int32_t raw_pos = (data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24)); 
         
         return (float)raw_pos / 100.0f;
     }
+    metrics.read_timeouts.add();
     return 0.0f; 
 }
 
@@ -181,6 +430,52 @@ float RMD_Motor::read_feedback() {
     return position_read();
 }
 
+bool RMD_Motor::decode_reply(uint32_t rid, const uint8_t *data, size_t len) {
+    // Replies come back on 0x240 + motor ID (0x141 -> 0x241)
+    if (rid != id + 0x100 || len < 8) return false;
+
+    switch (data[0]) {
+        case 0x92: {
+            int32_t raw_pos = (data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
+            state.pos = (float)raw_pos / 100.0f;
+            metrics.rx_frames.add();
+            return true;
+        }
+        case 0x9A:
+            // Status 1: temp, brake, voltage (0.1 V), error flags (0x0002 stall,
+            // 0x0004 under-voltage, 0x0008 over-voltage, 0x0010 over-current, 0x1000 over-temperature)
+            state.temp = (float)(int8_t)data[1];
+            state.err_msg = data[6] | (data[7] << 8);
+            metrics.rx_frames.add();
+            return true;
+        case 0x9C: case 0xA1: case 0xA2: case 0xA4:
+            // temp (1 C), iq (0.01 A), speed (1 dps), angle (1 deg/LSB)
+            state.temp = (float)(int8_t)data[1];
+            state.current = (float)le_int16(&data[2]) / 100.0f;
+            state.vel = (float)le_int16(&data[4]) / 6.0f;
+            state.pos = (float)le_int16(&data[6]);
+            metrics.rx_frames.add();
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool RMD_Motor::encode_current(float amps, uint8_t *out) const {
+    // 0xA1 torque closed loop: iqControl in 0.01 A
+    int16_t iq = to_int16(amps * 100.0f);
+    std::fill(out, out + 8, 0);
+    out[0] = 0xA1;
+    out[4] = iq & 0xFF;
+    out[5] = (iq >> 8) & 0xFF;
+    return true;
+}
+
+bool RMD_Motor::encode_velocity(float rpm, uint8_t *out) const {
+    encode_speed_a2(rpm * 6.0f, out);
+    return true;
+}
+
 void RMD_Motor::move_and_monitor(float target_deg, float vel_rpm) {
     std::cout << "\n[" << name << "] Moving to absolute target: " << target_deg << " deg (Speed: " << vel_rpm << " RPM)..." << std::endl;
     
@@ -188,16 +483,37 @@ void RMD_Motor::move_and_monitor(float target_deg, float vel_rpm) {
     const auto sleep_interval = std::chrono::milliseconds(50);
     const auto max_duration = std::chrono::seconds(10);
     auto start_time = std::chrono::steady_clock::now();
+    uint64_t frames_before = bus_frames();
+    int ticks = 0;
     
     float normalized_target = std::round(target_deg * 100.0f) / 100.0f;
 
     while (true) { 
+        if (aborted()) {
+            std::cerr << "\n[" << name << "] Move aborted.\n";
+            break;
+        }
         position_write(target_deg, vel_rpm); 
+        ticks++;
 
         std::this_thread::sleep_for(sleep_interval);
         
-        float current_pos = position_read();
+        // The 0xA4 reply already carries the angle (1 deg resolution, within tolerance)
+        float current_pos = NAN;
+        if (!passive_feedback) current_pos = position_read();
+        else if (read_reply()) current_pos = state.pos;
         
+        if (!std::isnan(current_pos)) update_thermal(std::chrono::duration<float>(sleep_interval).count());
+
+        // Hold where the finger stopped instead of stalling into the timeout
+        if (!std::isnan(current_pos) &&
+            check_contact(std::chrono::duration<float>(sleep_interval).count(), target_deg, vel_rpm)) {
+            auto detected_at = std::chrono::steady_clock::now();
+            position_write(current_pos, vel_rpm);
+            report_contact(detected_at);
+            break;
+        }
+
         std::cout << "[" << name << "] Current: " << current_pos << " deg | Target: " << target_deg << " deg   \r";
         std::cout.flush();
         
@@ -211,20 +527,21 @@ void RMD_Motor::move_and_monitor(float target_deg, float vel_rpm) {
             break;
         }
     }
+    report_bus_usage(frames_before, ticks);
 }
 
 
 // ---------------------------
 // RMD_BionicMotor Implementation (matches Python bit-packed 64-bit protocol)
 // ---------------------------
-RMD_BionicMotor::RMD_BionicMotor(uint32_t id_, CANBus *bus_, const std::string &name_)
+RMD_BionicMotor::RMD_BionicMotor(uint32_t id_, CanTransport *bus_, const std::string &name_)
     : MotorControl(id_, bus_, name_) {}
 
 // set_state: send simple 8-byte payload with first byte as command
 void RMD_BionicMotor::set_state(int cmd) {
-    std::vector<uint8_t> payload(8, 0);
+    uint8_t payload[8] = {};
     payload[0] = static_cast<uint8_t>(cmd & 0xFF);
-    bus->send_msg(id, payload);
+    send_frame(payload, TxClass::Safety);
 }
 
 // Helper: float -> IEEE754 uint32
@@ -235,22 +552,65 @@ static uint32_t float_to_uint32(float f) {
 }
 
 // Helper: read 64-bit frame bytes -> uint64_t (big-endian assembled)
-static uint64_t bytes_to_uint64_be(const std::vector<uint8_t> &data) {
+static uint64_t bytes_to_uint64_be(const uint8_t *data, size_t len) {
     uint64_t v = 0;
-    for (size_t i = 0; i < 8 && i < data.size(); ++i) {
+    for (size_t i = 0; i < 8 && i < len; ++i) {
         v = (v << 8) | static_cast<uint64_t>(data[i]);
     }
     return v;
 }
 
+// Helper: decode a Bionic status frame (reply to position_write and 0x0E reads)
+static RMDFeedback decode_bionic_frame(const uint8_t *data) {
+    uint64_t frame = bytes_to_uint64_be(data, 8);
+
+    // --- Parse fields to match Python logic ---
+    RMDFeedback out;
+
+    // 1. msg_class: bits 63..61 (Python msg_bin[:3])
+    out.msg_class = static_cast<int>((frame >> 61) & 0x7ULL);
+
+    // 2. err_msg: bits 58..54 (Python msg_bin[3:8])
+    out.err_msg = static_cast<int>((frame >> 56) & 0x1FUL);
+
+    // 3. pos: bits 55..24 (Python msg_bin[8:40])
+    uint32_t pos_bits = static_cast<uint32_t>((frame >> 24) & 0xFFFFFFFFULL);
+    union { uint32_t u; float f; } conv;
+    conv.u = pos_bits;
+    out.pos = std::round(conv.f * 10.0f) / 10.0f; // Round to 1 decimal place
+
+    // 4. current: bits 23..8 (Python msg_bin[40:56], then / 100)
+    uint32_t current_raw_16bit = static_cast<uint32_t>((frame >> 8) & 0xFFFFULL);
+    out.current = std::round((static_cast<float>(current_raw_16bit) / 100.0f) * 100.0f) / 100.0f; // Round to 2 decimal places
+
+    // 5. temp: bits 7..0 (Python msg_bin[56:], then scale)
+    uint32_t temp_raw = static_cast<uint32_t>(frame & 0xFFULL);
+    out.temp = std::round(((static_cast<float>(temp_raw) - 50.0f) / 2.0f) * 10.0f) / 10.0f; // Round to 1 decimal place
+
+    return out;
+}
+
 // position_write(pos, vel) -> uses default current = 5.0
-std::vector<uint8_t> RMD_BionicMotor::position_write(float pos, float vel) {
+bool RMD_BionicMotor::position_write(float pos, float vel) {
     return position_write(pos, vel, 5.0f);
 }
 
 // position_write(pos, vel, cur) -> builds 64-bit packed frame
-std::vector<uint8_t> RMD_BionicMotor::position_write(float pos, float vel, float cur) {
-    std::vector<uint8_t> payload(8, 0);
+bool RMD_BionicMotor::position_write(float pos, float vel, float cur) {
+    uint8_t payload[8] = {};
+    encode_position(pos, vel, cur, payload);
+    return send_frame(payload);
+}
+
+// encode_position(pos, vel) -> position frame with the default 5 A limit
+bool RMD_BionicMotor::encode_position(float pos_deg, float vel_rpm, uint8_t *out) const {
+    encode_position(pos_deg, vel_rpm, 5.0f, out);
+    return true;
+}
+
+bool RMD_BionicMotor::encode_position(float pos, float vel, float cur, uint8_t *out) const {
+    // Predictive derating: hold the winding under its limit over the model horizon
+    if (thermal) cur = thermal->derate(thermal_joint, cur);
 
     // velocity * 10 -> 15 bits
     uint32_t vel_raw = static_cast<uint32_t>(std::round(std::abs(vel) * 10.0f)) & 0x7FFF; // 15 bits
@@ -275,43 +635,56 @@ std::vector<uint8_t> RMD_BionicMotor::position_write(float pos, float vel, float
 
     // Split into bytes (big-endian order)
     for (int i = 0; i < 8; ++i) {
-        payload[i] = static_cast<uint8_t>((frame >> (56 - i * 8)) & 0xFF);
+        out[i] = static_cast<uint8_t>((frame >> (56 - i * 8)) & 0xFF);
     }
+    return true;
+}
 
-    bus->send_msg(id, payload);
-    return payload;
+// encode_current(cur) -> current-mode frame, answered with the same status frame
+bool RMD_BionicMotor::encode_current(float amps, uint8_t *out) const {
+    int16_t cur_raw = to_int16(amps * 100.0f); // 0.01 A, signed
+
+    // Frame layout (bytes 3..7 unused):
+    // bits 63..61 : 3-bit header (0b011, current/torque mode)
+    // bits 60..58 : 3-bit control mode (0b000 = current)
+    // bits 57..56 : 2-bit footer 0b10 (reply with status frame)
+    // bits 55..40 : 16-bit signed current * 100
+    std::fill(out, out + 8, 0);
+    out[0] = (uint8_t)((0x3 << 5) | (0x0 << 2) | 0x2);
+    out[1] = (uint8_t)(((uint16_t)cur_raw >> 8) & 0xFF);
+    out[2] = (uint8_t)((uint16_t)cur_raw & 0xFF);
+    return true;
 }
 
 // position_read(): send read request and parse position (float)
 float RMD_BionicMotor::position_read() {
     // Send read request (0x0E 0x00 0x00 0x01)
-    std::vector<uint8_t> req(8, 0);
+    uint8_t req[8] = {};
     req[0] = 0x0E;
     req[3] = 0x01;
-    bus->send_msg(id, req);
+    drain_pending();
+    send_frame(req, TxClass::Poll);
+    auto sent = std::chrono::steady_clock::now();
 
     uint32_t rid;
     std::vector<uint8_t> data;
 
     for (int i = 0; i < 20; ++i) {
         if (!bus->read_msg(rid, data)) {
+            metrics.read_retries.add();
             std::this_thread::sleep_for(std::chrono::milliseconds(5));
             continue;
         }
-        if (rid != id) continue;
-        if (data.size() < 8) continue;
-
-        uint64_t frame = bytes_to_uint64_be(data);
-
-        // POS = bits [8..39] (Python msg_bin) -> frame bits [55..24] (Big-Endian)
-        uint32_t pos_bits = (uint32_t)((frame >> 24) & 0xFFFFFFFFULL);
-
-        union { uint32_t u; float f; } conv;
-        conv.u = pos_bits;
-        // Match Python's rounding (round to 1 decimal place)
-        return std::round(conv.f * 10.0f) / 10.0f; 
+        // POS = bits [8..39] (Python msg_bin), rounded to 1 decimal place like Python
+        if (!decode_reply(rid, data.data(), data.size())) {
+            metrics.read_retries.add();
+            continue;
+        }
+        metrics.reply_latency.record(std::chrono::steady_clock::now() - sent);
+        return state.pos;
     }
 
+    metrics.read_timeouts.add();
     return -100000.0f;
 }
 
@@ -321,6 +694,13 @@ float RMD_BionicMotor::read_feedback() {
     return fb.pos;
 }
 
+bool RMD_BionicMotor::decode_reply(uint32_t rid, const uint8_t *data, size_t len) {
+    if (rid != id || len < 8) return false;
+    state = decode_bionic_frame(data);
+    metrics.rx_frames.add();
+    return true;
+}
+
 // read_feedback_struct(): full decoding of a single 8-byte response frame
 RMDFeedback RMD_BionicMotor::read_feedback_struct() {
     RMDFeedback out;
@@ -332,40 +712,11 @@ RMDFeedback RMD_BionicMotor::read_feedback_struct() {
 
     uint32_t rid;
     std::vector<uint8_t> data;
-    if (!bus->read_msg(rid, data)) return out;
-    if (rid != id) return out;
-    if (data.size() < 8) return out;
-
-    uint64_t frame = bytes_to_uint64_be(data);
-
-    // --- Parse fields to match Python logic ---
-
-    // 1. msg_class: bits 63..61 (Python msg_bin[:3])
-    int msg_class = static_cast<int>((frame >> 61) & 0x7ULL);      
-
-    // 2. err_msg: bits 58..54 (Python msg_bin[3:8])
-    int err_msg = static_cast<int>((frame >> 56) & 0x1FUL);
-
-    // 3. pos: bits 55..24 (Python msg_bin[8:40])
-    uint32_t pos_bits = static_cast<uint32_t>((frame >> 24) & 0xFFFFFFFFULL);
-    union { uint32_t u; float f; } conv;
-    conv.u = pos_bits;
-    float pos_f = std::round(conv.f * 10.0f) / 10.0f; // Round to 1 decimal place
-
-    // 4. current: bits 23..8 (Python msg_bin[40:56], then / 100)
-    uint32_t current_raw_16bit = static_cast<uint32_t>((frame >> 8) & 0xFFFFULL);
-    float current_f = std::round((static_cast<float>(current_raw_16bit) / 100.0f) * 100.0f) / 100.0f; // Round to 2 decimal places
-
-    // 5. temp: bits 7..0 (Python msg_bin[56:], then scale)
-    uint32_t temp_raw = static_cast<uint32_t>(frame & 0xFFULL); 
-    float temp_f = std::round(((static_cast<float>(temp_raw) - 50.0f) / 2.0f) * 10.0f) / 10.0f; // Round to 1 decimal place
-
-    out.msg_class = msg_class;
-    out.err_msg = err_msg;
-    out.pos = pos_f;
-    out.current = current_f;
-    out.temp = temp_f;
-    return out;
+    if (!bus->read_msg(rid, data) || !decode_reply(rid, data.data(), data.size())) {
+        metrics.read_timeouts.add();
+        return out;
+    }
+    return state;
 }
 
 // position_write_increment: behavioral loop until target reached
@@ -385,14 +736,23 @@ void RMD_BionicMotor::position_write_increment(float deg, float vel, float cur)
     auto start = std::chrono::steady_clock::now();
 
     while (true) {
+        if (aborted()) {
+            std::cerr << "[RMD_BionicMotor] position_write_increment: aborted\n";
+            break;
+        }
+
         // send command (using float target)
         position_write((float)target, vel, cur);
 
         std::this_thread::sleep_for(sleep_interval);
 
-        // read feedback (structured) and check pos
-        RMDFeedback fb = read_feedback_struct();
+        // read feedback (reply to the write above) and check pos
+        RMDFeedback fb;
+        fb.msg_class = -1;
+        if (!passive_feedback) fb = read_feedback_struct();
+        else if (read_reply()) fb = state;
         if (fb.msg_class != -1) {
+            update_thermal(std::chrono::duration<float>(sleep_interval).count());
             std::cout << "[RMD_BionicMotor] current: " << fb.pos << " target: " << target << std::endl;
             // Check if the rounded current position matches the integer target
             if (std::fabs(std::round(fb.pos) - target) <= 0.5f) { // Use 0.5f to check against integer
@@ -419,38 +779,61 @@ void RMD_BionicMotor::position_write_absolute(float target_deg, float vel_rpm, f
     const auto sleep_interval = std::chrono::milliseconds(200);
     const auto max_duration = std::chrono::seconds(15);
     auto start_time = std::chrono::steady_clock::now();
+    uint64_t frames_before = bus_frames();
+    int ticks = 0;
 
     while (true) { 
+        if (aborted()) {
+            std::cerr << "\n[RMD_BionicMotor] Move aborted.\n";
+            break;
+        }
+
         // 1. Re-send the absolute command continuously
         position_write(target_deg, vel_rpm, current_limit); 
+        ticks++;
 
         std::this_thread::sleep_for(sleep_interval);
         
-        // 2. Read feedback
-        RMDFeedback fb = read_feedback_struct();
+        // 2. Read feedback: the status frame answering the write, or an explicit 0x0E read
+        RMDFeedback fb;
+        fb.pos = -100000.0f;
+        if (!passive_feedback) fb.pos = position_read();
+        else if (read_reply()) fb = state;
         
         // 3. Check for read errors
         if (fb.pos < -50000.0f) {
             std::cerr << "[RMD_BionicMotor] Warning: Failed to read feedback.\n";
+            if (std::chrono::steady_clock::now() - start_time > max_duration) break;
             continue;
         }
         
-        // 4. Print status on a single line
+        update_thermal(std::chrono::duration<float>(sleep_interval).count());
+
+        // 4. Hold where the finger stopped instead of stalling into the timeout
+        if (check_contact(std::chrono::duration<float>(sleep_interval).count(), target_deg, vel_rpm)) {
+            auto detected_at = std::chrono::steady_clock::now();
+            position_write(fb.pos, vel_rpm, current_limit);
+            report_contact(detected_at);
+            break;
+        }
+
+        // 5. Print status on a single line
         std::cout << "[RMD_BionicMotor] Current: " << fb.pos << " deg | Target: " << target_deg << " deg   \r";
         std::cout.flush();
         
-        // 5. Check if target is reached
+        // 6. Check if target is reached
         if (std::abs(fb.pos - target_deg) <= tolerance) {
             std::cout << "\n[RMD_BionicMotor] Target reached." << std::endl;
             break;
         }
         
-        // 6. Check for timeout
+        // 7. Check for timeout
         if (std::chrono::steady_clock::now() - start_time > max_duration) {
             std::cerr << "\n[RMD_BionicMotor] Warning: Timeout waiting for target position.\n";
             break;
         }
     }
+    report_bus_usage(frames_before, ticks);
 }
 
 void RMD_BionicMotor::move_and_monitor(float target_deg, float vel_rpm) {
@@ -0,0 +1,223 @@
+#include "motor_discovery.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+// Probe frames: a position read each protocol answers
+static const uint8_t RMD_PROBE[8] = {0x92, 0, 0, 0, 0, 0, 0, 0};       // multi-turn angle
+static const uint8_t LKTECH_PROBE[8] = {0x94, 0, 0, 0, 0, 0, 0, 0};    // single-turn angle
+static const uint8_t BIONIC_PROBE[8] = {0x0E, 0, 0, 0x01, 0, 0, 0, 0}; // status read
+static const uint8_t ENABLE[8] = {0x81, 0, 0, 0, 0, 0, 0, 0};
+static const uint8_t DISABLE[8] = {0x80, 0, 0, 0, 0, 0, 0, 0};
+
+const char *protocol_name(MotorProtocol protocol) {
+    switch (protocol) {
+        case MotorProtocol::RMD: return "RMD";
+        case MotorProtocol::LKtech: return "LKtech";
+        case MotorProtocol::Bionic: return "Bionic";
+    }
+    return "?";
+}
+
+struct ProbeFrame {
+    uint32_t id;
+    const uint8_t *data;
+};
+
+// Classifies a reply; false if it is not one of the probe/enable answers
+static bool classify_reply(uint32_t rid, const uint8_t *data, uint8_t len, MotorInfo &out) {
+    if (len < 8) return false;
+    if (rid > 0x240 && rid <= 0x27F) {
+        out.protocol = MotorProtocol::RMD;
+        out.id = rid - 0x100;
+        return true;
+    }
+    // LKtech echoes the command byte on the command ID; our own frames are not looped back
+    if (rid > 0x140 && rid <= 0x17F && (data[0] == 0x94 || data[0] == 0x81)) {
+        out.protocol = MotorProtocol::LKtech;
+        out.id = rid;
+        return true;
+    }
+    // Bionic status frame: message class 0b001 in the top bits
+    if (rid >= 0x01 && rid <= 0x3F && (data[0] >> 5) == 0x1) {
+        out.protocol = MotorProtocol::Bionic;
+        out.id = rid;
+        return true;
+    }
+    return false;
+}
+
+static bool same_motor(const MotorInfo &a, const MotorInfo &b) {
+    return a.protocol == b.protocol && a.id == b.id;
+}
+
+// Sends a frame, polling replies while the TX queue is full
+template <typename OnReply>
+static bool send_pipelined(CanTransport *bus, uint32_t id, const uint8_t *data, TxClass cls,
+                           std::chrono::steady_clock::time_point deadline, OnReply on_reply) {
+    uint32_t rid;
+    uint8_t rx[8];
+    uint8_t len;
+    while (!bus->send_msg(id, data, 8, cls)) {
+        while (bus->poll_msg(rid, rx, len)) on_reply(rid, rx, len);
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+}
+
+std::vector<MotorInfo> discover_motors(CanTransport *bus, const DiscoveryConfig &cfg) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + cfg.timeout;
+
+    // Interleave the protocols so each gets its probes onto the wire early
+    std::vector<ProbeFrame> probes;
+    for (uint32_t n = cfg.first; n <= cfg.last; ++n) {
+        if (cfg.rmd) probes.push_back({0x140 + n, RMD_PROBE});
+        if (cfg.lktech) probes.push_back({0x140 + n, LKTECH_PROBE});
+        if (cfg.bionic) probes.push_back({n, BIONIC_PROBE});
+    }
+
+    std::vector<MotorInfo> found;
+    auto last_reply = start;
+    auto on_reply = [&](uint32_t rid, const uint8_t *data, uint8_t len) {
+        MotorInfo info;
+        if (!classify_reply(rid, data, len, info)) return;
+        if (info.protocol == MotorProtocol::RMD && !cfg.rmd) return;
+        if (info.protocol == MotorProtocol::LKtech && !cfg.lktech) return;
+        if (info.protocol == MotorProtocol::Bionic && !cfg.bionic) return;
+        last_reply = std::chrono::steady_clock::now();
+        for (const MotorInfo &m : found) {
+            if (same_motor(m, info)) return;
+        }
+        found.push_back(info);
+    };
+
+    size_t sent = 0;
+    for (const ProbeFrame &p : probes) {
+        if (!send_pipelined(bus, p.id, p.data, TxClass::Poll, deadline, on_reply)) break;
+        sent++;
+    }
+    auto all_sent = std::chrono::steady_clock::now();
+    last_reply = std::max(last_reply, all_sent);
+
+    // Collect the stragglers until the bus goes quiet
+    uint32_t rid;
+    uint8_t rx[8];
+    uint8_t len;
+    while (true) {
+        while (bus->poll_msg(rid, rx, len)) on_reply(rid, rx, len);
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_reply >= cfg.quiet || now >= deadline) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    std::sort(found.begin(), found.end(), [](const MotorInfo &a, const MotorInfo &b) {
+        return a.protocol != b.protocol ? a.protocol < b.protocol : a.id < b.id;
+    });
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Discovery] " << sent << "/" << probes.size() << " probes, " << found.size()
+              << " motors in " << elapsed / 1000.0 << " ms" << std::endl;
+    for (const MotorInfo &m : found) {
+        std::cout << "  " << protocol_name(m.protocol) << " 0x" << std::hex << m.id << std::dec << "\n";
+    }
+    return found;
+}
+
+size_t enable_motors(CanTransport *bus, std::vector<MotorInfo> &motors,
+                     std::chrono::milliseconds timeout, std::chrono::milliseconds retry) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + timeout;
+    size_t confirmed = 0;
+
+    auto on_reply = [&](uint32_t rid, const uint8_t *data, uint8_t len) {
+        MotorInfo info;
+        if (!classify_reply(rid, data, len, info)) return;
+        // RMD/LKtech echo 0x81; Bionic answers the status read, healthy if err == 0
+        bool ok = (info.protocol == MotorProtocol::Bionic) ? ((data[0] & 0x1F) == 0) : (data[0] == 0x81);
+        if (!ok) return;
+        for (MotorInfo &m : motors) {
+            if (same_motor(m, info) && !m.enabled) {
+                m.enabled = true;
+                confirmed++;
+            }
+        }
+    };
+
+    for (MotorInfo &m : motors) m.enabled = false;
+    while (confirmed < motors.size() && std::chrono::steady_clock::now() < deadline) {
+        for (const MotorInfo &m : motors) {
+            if (m.enabled) continue;
+            send_pipelined(bus, m.id, ENABLE, TxClass::Safety, deadline, on_reply);
+            if (m.protocol == MotorProtocol::Bionic) send_pipelined(bus, m.id, BIONIC_PROBE, TxClass::Poll, deadline, on_reply);
+        }
+
+        auto resend = std::min(std::chrono::steady_clock::now() + retry, deadline);
+        uint32_t rid;
+        uint8_t rx[8];
+        uint8_t len;
+        while (confirmed < motors.size() && std::chrono::steady_clock::now() < resend) {
+            while (bus->poll_msg(rid, rx, len)) on_reply(rid, rx, len);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Discovery] " << confirmed << "/" << motors.size() << " motors enabled in "
+              << elapsed / 1000.0 << " ms" << std::endl;
+    for (const MotorInfo &m : motors) {
+        if (!m.enabled) {
+            std::cerr << "[Discovery] No enable reply from " << protocol_name(m.protocol) << " 0x"
+                      << std::hex << m.id << std::dec << "\n";
+        }
+    }
+    return confirmed;
+}
+
+size_t disable_motors(CanTransport *bus, const std::vector<MotorInfo> &motors) {
+    size_t sent = 0;
+    for (const MotorInfo &m : motors) {
+        if (bus->send_msg(m.id, DISABLE, 8, TxClass::Safety)) sent++;
+    }
+    bus->flush(std::chrono::microseconds(10000));
+    size_t pending = bus->get_tx_pending(TxClass::Safety);
+    std::cout << "[Discovery] " << sent - std::min(sent, pending) << "/" << motors.size() << " motors disabled" << std::endl;
+    return sent;
+}
+
+std::unique_ptr<MotorControl> make_motor(const MotorInfo &info, CanTransport *bus) {
+    std::ostringstream name;
+    name << protocol_name(info.protocol) << "_0x" << std::hex << info.id;
+    switch (info.protocol) {
+        case MotorProtocol::RMD: return std::make_unique<RMD_Motor>(info.id, bus, name.str());
+        case MotorProtocol::LKtech: return std::make_unique<LKtech_Motor>(info.id, bus, name.str());
+        case MotorProtocol::Bionic: return std::make_unique<RMD_BionicMotor>(info.id, bus, name.str());
+    }
+    return nullptr;
+}
+
+bool parse_motor_spec(const std::string &spec, MotorInfo &out) {
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos) return false;
+    std::string type = spec.substr(0, colon);
+    char *end = nullptr;
+    out.id = std::strtoul(spec.c_str() + colon + 1, &end, 0);
+    if (end == spec.c_str() + colon + 1 || *end != '\0') return false;
+    if (type == "rmd") out.protocol = MotorProtocol::RMD;
+    else if (type == "lk") out.protocol = MotorProtocol::LKtech;
+    else if (type == "bionic") out.protocol = MotorProtocol::Bionic;
+    else return false;
+    out.enabled = false;
+    return true;
+}
+
+std::unique_ptr<MotorControl> make_motor(const std::string &spec, CanTransport *bus) {
+    MotorInfo info;
+    if (!parse_motor_spec(spec, info)) return nullptr;
+    return make_motor(info, bus);
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include "can_bus.hpp"
+#include "sim_motor.hpp"
+
+// Simulated motor on a (virtual) CAN interface, e.g.:
+//   sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+//   ./motor_sim vcan0 rmd 0x141      and in another shell   ./motor_test vcan0
+// An optional obstacle angle makes the motor stall there, for contact detection.
+void usage() {
+    std::cout << "Usage: motor_sim <interface> <rmd|lk|bionic> [id] [obstacle_deg]\n";
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+
+    std::string type = argv[2];
+    std::unique_ptr<SimMotor> motor;
+    if (type == "rmd") {
+        uint32_t id = argc > 3 ? std::strtoul(argv[3], nullptr, 0) : 0x141;
+        motor = std::make_unique<SimRMDMotor>(id);
+    } else if (type == "lk") {
+        uint32_t id = argc > 3 ? std::strtoul(argv[3], nullptr, 0) : 0x141;
+        motor = std::make_unique<SimLKtechMotor>(id);
+    } else if (type == "bionic") {
+        uint32_t id = argc > 3 ? std::strtoul(argv[3], nullptr, 0) : 0x01;
+        motor = std::make_unique<SimBionicMotor>(id);
+    } else {
+        usage();
+        return 1;
+    }
+
+    if (argc > 4) motor->set_obstacle(std::strtof(argv[4], nullptr));
+
+    CANBus bus(argv[1]);
+    std::cout << "[" << motor->get_name() << "] Simulating ID 0x" << std::hex << motor->get_id()
+              << std::dec << " on " << argv[1] << std::endl;
+
+    auto last_step = std::chrono::steady_clock::now();
+    auto last_report = last_step;
+    uint64_t rx_before = 0, tx_before = 0;
+    bool was_blocked = false;
+    bool hold_pending = false;
+    auto contact_time = last_step;
+
+    uint32_t rid;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> reply(8, 0);
+
+    while (bus.read_msg(rid, data)) {
+        auto now = std::chrono::steady_clock::now();
+        motor->step(std::chrono::duration<float>(now - last_step).count());
+        last_step = now;
+
+        // Contact: time from the stall until the host commands a hold at the object
+        if (motor->is_blocked() && !was_blocked) {
+            contact_time = now;
+            hold_pending = true;
+            std::cout << "[" << motor->get_name() << "] Contact at " << motor->get_pos() << " deg" << std::endl;
+        }
+        was_blocked = motor->is_blocked();
+
+        uint32_t reply_id;
+        if (motor->handle_frame(rid, data.data(), data.size(), reply_id, reply.data()))
+            bus.send_msg(reply_id, reply);
+
+        if (hold_pending && motor->get_target() <= motor->get_pos() + 1.0f) {
+            hold_pending = false;
+            std::cout << "[" << motor->get_name() << "] Hold received "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(now - contact_time).count()
+                      << " ms after contact" << std::endl;
+        }
+
+        if (now - last_report >= std::chrono::seconds(1)) {
+            std::cout << "[" << motor->get_name() << "] pos " << motor->get_pos() << " deg | rx "
+                      << bus.get_rx_count() - rx_before << " tx " << bus.get_tx_count() - tx_before
+                      << " frames/s" << std::endl;
+            rx_before = bus.get_rx_count();
+            tx_before = bus.get_tx_count();
+            last_report = now;
+        }
+    }
+
+    bus.shutdown();
+    return 0;
+}
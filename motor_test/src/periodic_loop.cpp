@@ -0,0 +1,44 @@
+#include "periodic_loop.hpp"
+#include "trace.hpp"
+
+PeriodicLoop::~PeriodicLoop() {
+    stop();
+}
+
+bool PeriodicLoop::start(std::chrono::microseconds period_, std::function<void()> fn_) {
+    if (running.load()) return false;
+    period = period_;
+    fn = std::move(fn_);
+    ticks = 0;
+    overruns = 0;
+    running = true;
+    worker = std::thread(&PeriodicLoop::run, this);
+    return true;
+}
+
+void PeriodicLoop::stop() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void PeriodicLoop::run() {
+    TRACE_THREAD_NAME("PeriodicLoop");
+    auto next = std::chrono::steady_clock::now() + period;
+
+    while (running.load(std::memory_order_relaxed)) {
+        {
+            TRACE_SPAN("loop", "tick");
+            fn();
+        }
+        ticks.fetch_add(1, std::memory_order_relaxed);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now > next) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            next = now + period;
+            continue;
+        }
+        std::this_thread::sleep_until(next);
+        next += period;
+    }
+}
@@ -0,0 +1,131 @@
+#include "replay_bus.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <linux/can.h>
+
+// One candump -L line: "(1697040000.123456) can0 141#A100000000000000".
+// Extended IDs have 8 hex digits; remote (#R) and CAN FD (##) frames are skipped.
+static bool parse_candump_line(const std::string &line, int64_t &us, uint32_t &id, uint8_t &len, uint8_t *data) {
+    size_t close = line.find(')');
+    if (line.empty() || line[0] != '(' || close == std::string::npos) return false;
+    char *end = nullptr;
+    int64_t sec = std::strtoll(line.c_str() + 1, &end, 10);
+    if (*end != '.') return false;
+    int64_t usec = std::strtoll(end + 1, &end, 10);
+    us = sec * 1000000 + usec;
+
+    size_t id_start = line.find(' ', close + 2);
+    size_t hash = line.find('#', close);
+    if (id_start == std::string::npos || hash == std::string::npos || hash <= id_start + 1) return false;
+    std::string id_text = line.substr(id_start + 1, hash - id_start - 1);
+    id = (uint32_t)std::strtoul(id_text.c_str(), &end, 16);
+    if (*end != '\0') return false;
+    if (id_text.size() == 8) id |= CAN_EFF_FLAG;
+
+    const char *hex = line.c_str() + hash + 1;
+    if (*hex == 'R' || *hex == '#') return false;
+    len = 0;
+    while (std::isxdigit((unsigned char)hex[0]) && std::isxdigit((unsigned char)hex[1])) {
+        if (len == 8) return false;
+        char byte[3] = {hex[0], hex[1], '\0'};
+        data[len++] = (uint8_t)std::strtoul(byte, nullptr, 16);
+        hex += 2;
+    }
+    return true;
+}
+
+ReplayBus::ReplayBus(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "[ReplayBus] Cannot open " << path << "\n";
+        return;
+    }
+
+    std::string line;
+    int64_t first_us = -1;
+    size_t skipped = 0;
+    while (std::getline(in, line)) {
+        Frame f {};
+        int64_t us;
+        if (!parse_candump_line(line, us, f.id, f.len, f.data)) {
+            if (!line.empty()) skipped++;
+            continue;
+        }
+        if (first_us < 0) first_us = us;
+        f.at = std::chrono::microseconds(std::max<int64_t>(0, us - first_us));
+        frames.push_back(f);
+    }
+    open = true;
+    std::cout << "[ReplayBus] " << frames.size() << " frames from " << path;
+    if (skipped > 0) std::cout << " (" << skipped << " lines skipped)";
+    std::cout << std::endl;
+}
+
+bool ReplayBus::finished() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return next >= frames.size();
+}
+
+void ReplayBus::set_filter(uint32_t id, uint32_t mask) {
+    std::lock_guard<std::mutex> lock(mtx);
+    filter_id = id;
+    filter_mask = mask;
+}
+
+void ReplayBus::advance(std::chrono::microseconds dt) {
+    std::lock_guard<std::mutex> lock(mtx);
+    clock += dt;
+}
+
+std::chrono::microseconds ReplayBus::now() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return clock;
+}
+
+void ReplayBus::rewind() {
+    std::lock_guard<std::mutex> lock(mtx);
+    next = 0;
+    clock = std::chrono::microseconds(0);
+}
+
+bool ReplayBus::seek_locked() {
+    while (next < frames.size() && (frames[next].id & filter_mask) != (filter_id & filter_mask)) next++;
+    return next < frames.size();
+}
+
+bool ReplayBus::send_msg(uint32_t id, const uint8_t *data, uint8_t len, TxClass cls) {
+    (void)id;
+    (void)data;
+    (void)cls;
+    if (len > 8) return false;
+    metrics.tx_frames.add();
+    return true;
+}
+
+bool ReplayBus::read_msg(uint32_t &id, std::vector<uint8_t> &data) {
+    TRACE_SPAN("can", "read_msg");
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!seek_locked()) return false;
+    const Frame &f = frames[next++];
+    clock = std::max(clock, f.at);
+    id = f.id;
+    data.assign(f.data, f.data + f.len);
+    metrics.rx_frames.add();
+    return true;
+}
+
+bool ReplayBus::poll_msg(uint32_t &id, uint8_t *data, uint8_t &len) {
+    TRACE_SPAN("can", "poll_msg");
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!seek_locked() || frames[next].at > clock) return false;
+    const Frame &f = frames[next++];
+    id = f.id;
+    len = f.len;
+    std::copy(f.data, f.data + f.len, data);
+    metrics.rx_frames.add();
+    return true;
+}
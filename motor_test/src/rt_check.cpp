@@ -0,0 +1,356 @@
+// The replacements below must be real functions, not the fortified inline wrappers
+#undef _FORTIFY_SOURCE
+#include "rt_check.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#if MOTOR_RT_CHECK
+
+// glibc's allocator under its internal names, so the replacements need no dlsym
+extern "C" {
+void *__libc_malloc(size_t size) noexcept;
+void *__libc_calloc(size_t n, size_t size) noexcept;
+void *__libc_realloc(void *ptr, size_t size) noexcept;
+void *__libc_memalign(size_t alignment, size_t size) noexcept;
+void __libc_free(void *ptr) noexcept;
+}
+
+constexpr int RT_MAX_FRAMES = 24;
+constexpr int RT_SKIP_FRAMES = 2;  // rt_violation() and the replaced function
+constexpr size_t RT_MAX_SITES = 64;
+
+// One call site: the first stack trace that led to it and how often it was hit
+struct RtSite {
+    const char *what;
+    uint64_t hash;
+    uint32_t tid;
+    int frames;
+    void *stack[RT_MAX_FRAMES];
+    uint64_t count;
+};
+
+static thread_local int rt_depth = 0;      // RT_SECTION() nesting on this thread
+static thread_local bool rt_busy = false;  // inside the checker: its own calls do not count
+static std::atomic<bool> rt_armed{false};
+static std::atomic<bool> rt_abort{false};
+static std::atomic<uint64_t> rt_total{0};
+static std::atomic_flag rt_sites_lock = ATOMIC_FLAG_INIT;
+static RtSite rt_sites[RT_MAX_SITES];
+static size_t rt_site_count = 0;
+
+static bool rt_check_init() {
+    const char *mode = std::getenv("RT_CHECK");
+    if (mode && std::strcmp(mode, "abort") == 0) rt_abort = true;
+    // The first backtrace() loads libgcc_s (allocates): get that done now
+    void *frame;
+    backtrace(&frame, 1);
+    return true;
+}
+static const bool rt_initialized = rt_check_init();
+
+static inline bool rt_hot() {
+    return rt_depth > 0 && !rt_busy && rt_armed.load(std::memory_order_relaxed);
+}
+
+static void print_stack(void *const *stack, int frames) {
+    std::cerr.flush();
+    backtrace_symbols_fd(stack, frames, STDERR_FILENO);
+}
+
+__attribute__((noinline)) static void rt_violation(const char *what) {
+    rt_busy = true;
+    void *stack[RT_MAX_FRAMES + RT_SKIP_FRAMES];
+    int n = backtrace(stack, RT_MAX_FRAMES + RT_SKIP_FRAMES);
+    void **frames = stack + std::min(n, RT_SKIP_FRAMES);
+    n = std::max(0, n - RT_SKIP_FRAMES);
+    uint32_t tid = (uint32_t)syscall(SYS_gettid);
+    rt_total.fetch_add(1, std::memory_order_relaxed);
+
+    if (rt_abort.load()) {
+        std::cerr << "[RtCheck] " << what << " on real-time thread " << tid << " (steady state):\n";
+        print_stack(frames, n);
+        std::abort();
+    }
+
+    // FNV-1a over the return addresses
+    uint64_t hash = 1469598103934665603ull;
+    for (int i = 0; i < n; ++i) hash = (hash ^ (uint64_t)(uintptr_t)frames[i]) * 1099511628211ull;
+
+    while (rt_sites_lock.test_and_set(std::memory_order_acquire)) {}
+    size_t i = 0;
+    while (i < rt_site_count && !(rt_sites[i].hash == hash && rt_sites[i].what == what)) ++i;
+    if (i == rt_site_count && rt_site_count < RT_MAX_SITES) {
+        RtSite &s = rt_sites[rt_site_count++];
+        s.what = what;
+        s.hash = hash;
+        s.tid = tid;
+        s.frames = n;
+        std::memcpy(s.stack, frames, sizeof(void*) * n);
+        s.count = 0;
+    }
+    if (i < rt_site_count) rt_sites[i].count++;
+    rt_sites_lock.clear(std::memory_order_release);
+    rt_busy = false;
+}
+
+void rt_check_arm(bool armed) { rt_armed = armed; }
+void rt_check_set_abort(bool abort_on_violation) { rt_abort = abort_on_violation; }
+size_t rt_check_violation_count() { return (size_t)rt_total.load(); }
+void rt_check_enter() { rt_depth++; }
+void rt_check_leave() { rt_depth--; }
+
+size_t rt_check_report() {
+    bool was_busy = rt_busy;
+    rt_busy = true;
+    uint64_t total = rt_total.load();
+    if (total == 0) {
+        std::cerr << "[RtCheck] No allocations or blocking calls on real-time threads\n";
+        rt_busy = was_busy;
+        return 0;
+    }
+
+    while (rt_sites_lock.test_and_set(std::memory_order_acquire)) {}
+    std::cerr << "[RtCheck] " << total << " allocations / blocking calls on real-time threads at "
+              << rt_site_count << (rt_site_count == RT_MAX_SITES ? "+" : "") << " call sites\n";
+    for (size_t i = 0; i < rt_site_count; ++i) {
+        const RtSite &s = rt_sites[i];
+        std::cerr << "[RtCheck] " << s.what << " x" << s.count << ", first on thread " << s.tid << ":\n";
+        print_stack(s.stack, s.frames);
+    }
+    rt_sites_lock.clear(std::memory_order_release);
+    rt_busy = was_busy;
+    return (size_t)total;
+}
+
+// The next definition of a replaced function (libc's), looked up once
+template <typename F>
+static F real_function(std::atomic<void*> &slot, const char *name) {
+    void *fn = slot.load(std::memory_order_relaxed);
+    if (!fn) {
+        bool was_busy = rt_busy;
+        rt_busy = true;
+        fn = dlsym(RTLD_NEXT, name);
+        rt_busy = was_busy;
+        slot.store(fn, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<F>(fn);
+}
+#define RT_REAL(fn) ([]() { \
+        static std::atomic<void*> slot{nullptr}; \
+        return real_function<decltype(&::fn)>(slot, #fn); \
+    }())
+
+static bool blocking_fd(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && !(flags & O_NONBLOCK);
+}
+
+extern "C" {
+
+// --- Allocation ---
+void *malloc(size_t size) noexcept {
+    if (rt_hot()) rt_violation("malloc");
+    return __libc_malloc(size);
+}
+
+void free(void *ptr) noexcept {
+    if (ptr && rt_hot()) rt_violation("free");
+    __libc_free(ptr);
+}
+
+void *calloc(size_t n, size_t size) noexcept {
+    if (rt_hot()) rt_violation("calloc");
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept {
+    if (rt_hot()) rt_violation("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) noexcept {
+    if (rt_hot()) rt_violation("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) noexcept {
+    if (rt_hot()) rt_violation("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) noexcept {
+    if (rt_hot()) rt_violation("posix_memalign");
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void *ptr = __libc_memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+// --- Sleeps ---
+int nanosleep(const struct timespec *req, struct timespec *rem) {
+    if (rt_hot()) rt_violation("nanosleep");
+    return RT_REAL(nanosleep)(req, rem);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const struct timespec *req, struct timespec *rem) {
+    if (rt_hot()) rt_violation("clock_nanosleep");
+    return RT_REAL(clock_nanosleep)(clock, flags, req, rem);
+}
+
+int usleep(useconds_t usec) {
+    if (rt_hot()) rt_violation("usleep");
+    return RT_REAL(usleep)(usec);
+}
+
+unsigned int sleep(unsigned int seconds) {
+    if (rt_hot()) rt_violation("sleep");
+    return RT_REAL(sleep)(seconds);
+}
+
+// --- Waits with a timeout (zero timeouts only poll) ---
+int poll(struct pollfd *fds, nfds_t nfds, int timeout) {
+    if (timeout != 0 && rt_hot()) rt_violation("poll");
+    return RT_REAL(poll)(fds, nfds, timeout);
+}
+
+int ppoll(struct pollfd *fds, nfds_t nfds, const struct timespec *timeout, const sigset_t *sigmask) {
+    if ((!timeout || timeout->tv_sec != 0 || timeout->tv_nsec != 0) && rt_hot()) rt_violation("ppoll");
+    return RT_REAL(ppoll)(fds, nfds, timeout, sigmask);
+}
+
+int select(int nfds, fd_set *r, fd_set *w, fd_set *e, struct timeval *timeout) {
+    if ((!timeout || timeout->tv_sec != 0 || timeout->tv_usec != 0) && rt_hot()) rt_violation("select");
+    return RT_REAL(select)(nfds, r, w, e, timeout);
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout) {
+    if (timeout != 0 && rt_hot()) rt_violation("epoll_wait");
+    return RT_REAL(epoll_wait)(epfd, events, maxevents, timeout);
+}
+
+// --- I/O that can block ---
+ssize_t read(int fd, void *buf, size_t count) {
+    if (rt_hot() && blocking_fd(fd)) rt_violation("read");
+    return RT_REAL(read)(fd, buf, count);
+}
+
+ssize_t write(int fd, const void *buf, size_t count) {
+    if (rt_hot() && blocking_fd(fd)) rt_violation("write");
+    return RT_REAL(write)(fd, buf, count);
+}
+
+ssize_t recv(int fd, void *buf, size_t len, int flags) {
+    if (!(flags & MSG_DONTWAIT) && rt_hot() && blocking_fd(fd)) rt_violation("recv");
+    return RT_REAL(recv)(fd, buf, len, flags);
+}
+
+ssize_t recvfrom(int fd, void *buf, size_t len, int flags, struct sockaddr *addr, socklen_t *addrlen) {
+    if (!(flags & MSG_DONTWAIT) && rt_hot() && blocking_fd(fd)) rt_violation("recvfrom");
+    return RT_REAL(recvfrom)(fd, buf, len, flags, addr, addrlen);
+}
+
+ssize_t recvmsg(int fd, struct msghdr *msg, int flags) {
+    if (!(flags & MSG_DONTWAIT) && rt_hot() && blocking_fd(fd)) rt_violation("recvmsg");
+    return RT_REAL(recvmsg)(fd, msg, flags);
+}
+
+ssize_t send(int fd, const void *buf, size_t len, int flags) {
+    if (!(flags & MSG_DONTWAIT) && rt_hot() && blocking_fd(fd)) rt_violation("send");
+    return RT_REAL(send)(fd, buf, len, flags);
+}
+
+ssize_t sendto(int fd, const void *buf, size_t len, int flags, const struct sockaddr *addr, socklen_t addrlen) {
+    if (!(flags & MSG_DONTWAIT) && rt_hot() && blocking_fd(fd)) rt_violation("sendto");
+    return RT_REAL(sendto)(fd, buf, len, flags, addr, addrlen);
+}
+
+ssize_t sendmsg(int fd, const struct msghdr *msg, int flags) {
+    if (!(flags & MSG_DONTWAIT) && rt_hot() && blocking_fd(fd)) rt_violation("sendmsg");
+    return RT_REAL(sendmsg)(fd, msg, flags);
+}
+
+// --- Files and stdio ---
+int open(const char *path, int flags, ...) {
+    if (rt_hot()) rt_violation("open");
+    va_list ap;
+    va_start(ap, flags);
+    mode_t mode = (flags & (O_CREAT | O_TMPFILE)) ? (mode_t)va_arg(ap, int) : 0;
+    va_end(ap);
+    return RT_REAL(open)(path, flags, mode);
+}
+
+int openat(int dirfd, const char *path, int flags, ...) {
+    if (rt_hot()) rt_violation("openat");
+    va_list ap;
+    va_start(ap, flags);
+    mode_t mode = (flags & (O_CREAT | O_TMPFILE)) ? (mode_t)va_arg(ap, int) : 0;
+    va_end(ap);
+    return RT_REAL(openat)(dirfd, path, flags, mode);
+}
+
+FILE *fopen(const char *path, const char *mode) {
+    if (rt_hot()) rt_violation("fopen");
+    return RT_REAL(fopen)(path, mode);
+}
+
+size_t fwrite(const void *ptr, size_t size, size_t n, FILE *stream) {
+    if (rt_hot()) rt_violation("fwrite");
+    return RT_REAL(fwrite)(ptr, size, n, stream);
+}
+
+int fputs(const char *s, FILE *stream) {
+    if (rt_hot()) rt_violation("fputs");
+    return RT_REAL(fputs)(s, stream);
+}
+
+int puts(const char *s) {
+    if (rt_hot()) rt_violation("puts");
+    return RT_REAL(puts)(s);
+}
+
+int fputc(int c, FILE *stream) {
+    if (rt_hot()) rt_violation("fputc");
+    return RT_REAL(fputc)(c, stream);
+}
+
+#undef putc
+int putc(int c, FILE *stream) {
+    if (rt_hot()) rt_violation("putc");
+    return RT_REAL(putc)(c, stream);
+}
+
+int fflush(FILE *stream) {
+    if (rt_hot()) rt_violation("fflush");
+    return RT_REAL(fflush)(stream);
+}
+
+} // extern "C"
+
+#else
+
+void rt_check_arm(bool) {}
+void rt_check_set_abort(bool) {}
+size_t rt_check_violation_count() { return 0; }
+size_t rt_check_report() { return 0; }
+void rt_check_enter() {}
+void rt_check_leave() {}
+
+#endif
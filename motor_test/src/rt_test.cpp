@@ -0,0 +1,147 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "control_loop.hpp"
+#include "hand_gateway.hpp"
+#include "loopback_bus.hpp"
+#include "motion_queue.hpp"
+#include "motor_control.hpp"
+#include "rt_check.hpp"
+#include "sim_motor.hpp"
+#include "spi_hand.hpp"
+#include "test_check.hpp"
+#include "trajectory.hpp"
+
+// Real-time sections of the control paths on simulated drives: built with
+// -DMOTOR_RT_CHECK=ON and run with RT_CHECK=abort (see CMakeLists.txt), any
+// allocation or blocking call in a steady-state tick aborts the test.
+// Without the check compiled in, it only runs the ticks.
+
+constexpr auto TICK = std::chrono::microseconds(1000);
+
+// Moves the bus clock along with the wall clock for the threaded runners
+class BusClock {
+public:
+    explicit BusClock(LoopbackBus &bus) : thread([this, &bus] {
+        while (running.load()) {
+            bus.advance(TICK);
+            std::this_thread::sleep_for(TICK);
+        }
+    }) {}
+    ~BusClock() {
+        running = false;
+        thread.join();
+    }
+
+    // Prevent copy/move
+    BusClock(const BusClock&) = delete;
+    BusClock& operator=(const BusClock&) = delete;
+
+private:
+    std::atomic<bool> running{true};
+    std::thread thread;
+};
+
+static void test_control_loop() {
+    LoopbackBus bus;
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    ControlLoop loop(&bus, ControlLoop::Mode::Cascade, 4);
+    CHECK(loop.add_motor(&rmd) == 0);
+    JointController::Gains outer;
+    outer.kp = 20.0f;
+    outer.out_limit = 360.0f;
+    JointController::Gains inner;
+    inner.kp = 0.02f;
+    inner.out_limit = 2.0f;
+    loop.position_law().set_gains(outer);
+    loop.velocity_law().set_gains(inner);
+    loop.set_reference(0, 30.0f);
+
+    // The first tick is start-up
+    for (int k = 0; k < 500; ++k) {
+        if (k == 1) rt_check_arm(true);
+        loop.tick(k * 1e-3, 1e-3f);
+        bus.advance(TICK);
+    }
+    rt_check_arm(false);
+    CHECK(bus.get_tx_count() == 500);
+    CHECK(sim.get_pos() > 1.0f);
+}
+
+static void test_trajectory() {
+    LoopbackBus bus;
+    SimRMDMotor sim_a(0x141);
+    SimRMDMotor sim_b(0x142);
+    bus.attach(&sim_a);
+    bus.attach(&sim_b);
+    RMD_Motor a(0x141, &bus, "RMD_A");
+    RMD_Motor b(0x142, &bus, "RMD_B");
+    MotorControl *motors[2] = {&a, &b};
+
+    std::vector<Waypoint> waypoints(4);
+    waypoints[0] = {0.00f, 0, 10.0f, 30.0f, 1.0f};
+    waypoints[1] = {0.00f, 1, -10.0f, 30.0f, 1.0f};
+    waypoints[2] = {0.10f, 0, 0.0f, 30.0f, 1.0f};
+    waypoints[3] = {0.10f, 1, 0.0f, 30.0f, 1.0f};
+    std::vector<TrajectoryStep> steps = compile_trajectory(waypoints, TICK);
+
+    TrajectoryRunner runner(&bus, motors, 2);
+    BusClock clock(bus);
+    rt_check_arm(true);
+    CHECK(runner.run(steps, TICK, std::chrono::milliseconds(300)));
+    rt_check_arm(false);
+    CHECK(runner.get_stats().moves == 4);
+    CHECK(runner.get_stats().ticks > 100);
+
+    // Again through a MotionQueue, from where the first run left the joints
+    MotionQueue queue(2, 3600.0f, 2.0f);
+    runner.set_motion_queue(&queue);
+    rt_check_arm(true);
+    CHECK(runner.run(steps, TICK, std::chrono::milliseconds(300)));
+    rt_check_arm(false);
+    CHECK(runner.get_stats().moves == 4);
+    CHECK(queue.idle());
+}
+
+static void test_gateway() {
+    LoopbackBus bus;
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    LoopbackSpiSlave slave;
+    SpiHandLink link(&slave);
+
+    HandGateway gateway(&bus, &link);
+    CHECK(gateway.add_can_joint(&rmd, 30.0f) == 0);
+    BusClock clock(bus);
+    CHECK(gateway.start(TICK));
+
+    // Start-up: the first pose reaches both transports
+    const float pose[1 + FINGER_DOF] = {20, 10, 20, 30, 40, 0, 0};
+    gateway.set_pose(pose, 1 + FINGER_DOF);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    rt_check_arm(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    gateway.set_pose(pose, 1 + FINGER_DOF);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    rt_check_arm(false);
+    gateway.stop();
+
+    HandState st;
+    gateway.get_state(st);
+    CHECK(st.synchronized);
+    CHECK(st.spi_acked);
+    CHECK(sim.get_pos() > 1.0f);
+}
+
+int main() {
+    test_control_loop();
+    test_trajectory();
+    test_gateway();
+    CHECK(rt_check_report() == 0);
+    return test_result("rt_test");
+}
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <thread>
+#include "hand_shm.hpp"
+#include "hand_shm_server.hpp"
+
+// Cross-process round trip of the shared-memory interface: a client process
+// sends a command and spins until the server process acknowledges it in the
+// published state. By default the server sleeps in wait_commands() between
+// 2 ms periods like hand_gateway --shm; with "spin" it busy-polls like a
+// dedicated gateway core would.
+//   ./shm_bench [round trips] [wait|spin]
+constexpr const char *BENCH_SHM_NAME = "/hand_shm_bench";
+
+int run_client(int rounds) {
+    HandShmClient client(BENCH_SHM_NAME);
+    if (!client.is_open()) {
+        std::cerr << "[shm_bench] Client could not map " << BENCH_SHM_NAME << "\n";
+        return 1;
+    }
+
+    std::vector<int64_t> rtt_ns;
+    rtt_ns.reserve(rounds);
+    float pose[HAND_SHM_MAX_JOINTS] = {};
+    int timeouts = 0;
+    for (int i = 0; i < rounds; ++i) {
+        pose[0] = (float)(i % 90);
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t id = client.send(pose, client.joints());
+        if (id == 0 || !client.wait_ack(id, std::chrono::microseconds(10000))) {
+            timeouts++;
+            continue;
+        }
+        rtt_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+    }
+
+    std::sort(rtt_ns.begin(), rtt_ns.end());
+    auto pct = [&](double p) { return rtt_ns.empty() ? 0 : rtt_ns[(size_t)(p * (rtt_ns.size() - 1))]; };
+    std::cout << "[shm_bench] " << rtt_ns.size() << " round trips, " << timeouts << " timeouts | p50 "
+              << pct(0.5) / 1000.0 << " us, p99 " << pct(0.99) / 1000.0 << " us, max "
+              << pct(1.0) / 1000.0 << " us" << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 100000;
+    bool spin = argc > 2 && std::string(argv[2]) == "spin";
+
+    HandShmServer server(BENCH_SHM_NAME, HAND_SHM_MAX_JOINTS);
+    if (!server.is_open()) return 1;
+
+    pid_t child = fork();
+    if (child < 0) {
+        perror("fork failed");
+        return 1;
+    }
+    if (child == 0) _exit(run_client(rounds));
+
+    float target[HAND_SHM_MAX_JOINTS] = {};
+    float pos[HAND_SHM_MAX_JOINTS] = {};
+    int status = 0;
+    for (uint32_t k = 0;; ++k) {
+        if (!spin) server.wait_commands(std::chrono::microseconds(2000));
+        if (server.poll_commands(target, HAND_SHM_MAX_JOINTS) > 0) {
+            server.publish(target, pos, HAND_SHM_MAX_JOINTS, true);
+        } else if (spin) {
+            std::this_thread::yield();
+        }
+        if (((k & 0xFFFF) == 0 || !spin) && waitpid(child, &status, WNOHANG) == child) break;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
@@ -0,0 +1,257 @@
+#include "sim_motor.hpp"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+// ===============================================================
+// Base SimMotor Implementation
+// ===============================================================
+SimMotor::SimMotor(uint32_t id, const std::string &name)
+    : id(id), name(name) {}
+
+void SimMotor::set_position_target(float deg, float max_dps) {
+    mode = Mode::Position;
+    target_deg = deg;
+    max_speed_dps = max_dps;
+}
+
+void SimMotor::set_velocity_target(float dps) {
+    mode = Mode::Velocity;
+    target_vel_dps = dps;
+}
+
+void SimMotor::set_current_target(float amps) {
+    mode = Mode::Current;
+    target_current = amps;
+}
+
+void SimMotor::step(float dt) {
+    if (dt <= 0.0f) return;
+
+    float prev_vel = vel_dps;
+    if (!enabled) {
+        vel_dps = 0.0f;
+    } else if (mode == Mode::Current) {
+        // 2000 dps^2 per amp, viscous damping with a 0.1 s time constant
+        float accel = 2000.0f * (target_current - load_a) - 10.0f * vel_dps;
+        vel_dps += accel * dt;
+        pos_deg += vel_dps * dt;
+    } else if (mode == Mode::Velocity) {
+        // Speed loop with a 3600 dps^2 acceleration limit
+        float max_dv = 3600.0f * dt;
+        vel_dps += std::max(-max_dv, std::min(max_dv, target_vel_dps - vel_dps));
+        pos_deg += vel_dps * dt;
+    } else {
+        // Trapezoidal profile: 3600 dps^2 like the speed loop, braking in time to
+        // stop at the target, never faster than the commanded speed limit
+        const float accel = 3600.0f;
+        float err = target_deg - pos_deg;
+        float stop_speed = std::sqrt(2.0f * accel * std::abs(err));
+        float desired = std::copysign(std::min(max_speed_dps, stop_speed), err);
+        float max_dv = accel * dt;
+        vel_dps += std::max(-max_dv, std::min(max_dv, desired - vel_dps));
+        float move = vel_dps * dt;
+        if (std::abs(move) >= std::abs(err) && move * err >= 0.0f) {
+            // Arrives within this step
+            pos_deg = target_deg;
+            vel_dps = 0.0f;
+        } else {
+            pos_deg += move;
+        }
+    }
+
+    // Stall against the object: position clamps and current builds with the push
+    blocked = !std::isnan(obstacle_deg) && pos_deg >= obstacle_deg;
+    if (blocked) {
+        pos_deg = obstacle_deg;
+        vel_dps = 0.0f;
+    }
+
+    if (enabled && mode == Mode::Current) {
+        current_a = target_current;
+    } else if (blocked) {
+        float push = (mode == Mode::Velocity) ? 0.05f * target_vel_dps : 0.2f * (target_deg - pos_deg);
+        current_a = std::min(8.0f, 0.5f + std::max(0.0f, push));
+    } else {
+        // Current: friction plus acceleration torque
+        float accel = (vel_dps - prev_vel) / dt;
+        current_a = 0.2f * (vel_dps != 0.0f ? 1.0f : 0.0f) + 0.0005f * std::abs(accel);
+    }
+
+    // Temperature: first-order I^2 heating towards 30 C ambient
+    temp_c += dt * (0.05f * current_a * current_a - (temp_c - 30.0f) / 120.0f);
+}
+
+// Helper: little-endian int16 into a reply payload
+static void put_le_int16(uint8_t *d, int16_t v) {
+    d[0] = (uint8_t)(v & 0xFF);
+    d[1] = (uint8_t)((v >> 8) & 0xFF);
+}
+
+static int16_t clamp_int16(float v) {
+    return (int16_t)std::max(-32768.0f, std::min(32767.0f, std::round(v)));
+}
+
+// ===============================================================
+// SimRMDMotor: 0x140 + ID commands, 0x240 + ID replies
+// ===============================================================
+SimRMDMotor::SimRMDMotor(uint32_t id, const std::string &name)
+    : SimMotor(id, name) {}
+
+bool SimRMDMotor::handle_frame(uint32_t rid, const uint8_t *data, size_t len,
+                               uint32_t &reply_id, uint8_t reply[8]) {
+    if (rid != id || len < 8) return false;
+
+    reply_id = id + 0x100;
+    std::memset(reply, 0, 8);
+    reply[0] = data[0];
+
+    switch (data[0]) {
+        case 0x80: enabled = false; return true;
+        case 0x81: enabled = true; return true;
+        case 0x92: {
+            int32_t p = (int32_t)std::round(pos_deg * 100.0f);
+            for (int i = 0; i < 4; ++i) reply[4 + i] = (uint8_t)((p >> (8 * i)) & 0xFF);
+            return true;
+        }
+        case 0x9A:
+            // Status 1: temp, brake, voltage (0.1 V), error flags
+            reply[1] = (uint8_t)(int8_t)std::round(temp_c);
+            put_le_int16(&reply[4], clamp_int16(voltage_v * 10.0f));
+            put_le_int16(&reply[6], (int16_t)error_flags);
+            return true;
+        case 0x9C:
+            break;
+        case 0xA4: {
+            int32_t p = (int32_t)(data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
+            set_position_target((float)p / 100.0f, (float)(data[2] | (data[3] << 8)));
+            break;
+        }
+        case 0xA1: {
+            set_current_target((float)(int16_t)(data[4] | (data[5] << 8)) / 100.0f);
+            break;
+        }
+        case 0xA2: {
+            int32_t v = (int32_t)(data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
+            set_velocity_target((float)v / 100.0f);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    // Command reply: temp, iq (0.01 A), speed (1 dps), angle (1 deg)
+    reply[1] = (uint8_t)(int8_t)std::round(temp_c);
+    put_le_int16(&reply[2], clamp_int16(current_a * 100.0f));
+    put_le_int16(&reply[4], clamp_int16(vel_dps));
+    put_le_int16(&reply[6], clamp_int16(pos_deg));
+    return true;
+}
+
+// ===============================================================
+// SimLKtechMotor: replies on the command ID, 36:1 output scaling
+// ===============================================================
+SimLKtechMotor::SimLKtechMotor(uint32_t id, const std::string &name)
+    : SimMotor(id, name) {}
+
+bool SimLKtechMotor::handle_frame(uint32_t rid, const uint8_t *data, size_t len,
+                                  uint32_t &reply_id, uint8_t reply[8]) {
+    if (rid != id || len < 8) return false;
+
+    reply_id = id;
+    std::memset(reply, 0, 8);
+    reply[0] = data[0];
+
+    switch (data[0]) {
+        case 0x80: enabled = false; return true;
+        case 0x81: enabled = true; return true;
+        case 0x94: {
+            // Single-turn angle, 0..359.99 deg
+            float turn = std::fmod(pos_deg, 360.0f);
+            if (turn < 0.0f) turn += 360.0f;
+            uint32_t raw = (uint32_t)std::round(turn * 3600.0f) % (360 * 3600);
+            for (int i = 0; i < 4; ++i) reply[4 + i] = (uint8_t)((raw >> (8 * i)) & 0xFF);
+            return true;
+        }
+        case 0x9A:
+            // Status 1: temp, voltage (0.1 V), error flags in the last byte
+            reply[1] = (uint8_t)(int8_t)std::round(temp_c);
+            put_le_int16(&reply[3], clamp_int16(voltage_v * 10.0f));
+            reply[7] = (uint8_t)error_flags;
+            return true;
+        case 0x9C:
+            break;
+        case 0xA6: {
+            // Single-turn target, reached spinning the way data[1] says (0 towards
+            // increasing angle, 1 towards decreasing), the long way round if need be
+            int32_t p = (int32_t)(data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
+            float ahead = std::fmod((float)p / 3600.0f - pos_deg, 360.0f);
+            if (ahead < 0.0f) ahead += 360.0f;
+            if (ahead > 359.99f) ahead -= 360.0f; // within the 0.01 deg resolution: there
+            float goal = (data[1] && ahead >= 0.01f) ? pos_deg - (360.0f - ahead) : pos_deg + ahead;
+            set_position_target(goal, (float)(data[2] | (data[3] << 8)) / 36.0f);
+            break;
+        }
+        case 0xA1: {
+            set_current_target((float)(int16_t)(data[4] | (data[5] << 8)) * 32.0f / 2000.0f);
+            break;
+        }
+        case 0xA2: {
+            int32_t v = (int32_t)(data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
+            set_velocity_target((float)v / 100.0f / 36.0f);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    // Same layout as 0x9C: temp, iq (-2048..2048 = -33..33 A), motor speed (dps), encoder
+    reply[1] = (uint8_t)(int8_t)std::round(temp_c);
+    put_le_int16(&reply[2], clamp_int16(current_a * 2048.0f / 33.0f));
+    put_le_int16(&reply[4], clamp_int16(vel_dps * 36.0f));
+    return true;
+}
+
+// ===============================================================
+// SimBionicMotor: 64-bit packed frames, replies on the command ID
+// ===============================================================
+SimBionicMotor::SimBionicMotor(uint32_t id, const std::string &name)
+    : SimMotor(id, name) {}
+
+bool SimBionicMotor::handle_frame(uint32_t rid, const uint8_t *data, size_t len,
+                                  uint32_t &reply_id, uint8_t reply[8]) {
+    if (rid != id || len < 8) return false;
+
+    uint64_t frame = 0;
+    for (int i = 0; i < 8; ++i) frame = (frame << 8) | data[i];
+
+    uint32_t header = (uint32_t)((frame >> 61) & 0x7ULL);
+    if (header == 0x1) {
+        // Position frame: pos float bits 60..29, vel*10 bits 28..14 (rpm)
+        uint32_t pos_bits = (uint32_t)((frame >> 29) & 0xFFFFFFFFULL);
+        float pos;
+        std::memcpy(&pos, &pos_bits, sizeof(pos));
+        set_position_target(pos, (float)((frame >> 14) & 0x7FFFULL) / 10.0f * 6.0f);
+    } else if (header == 0x3) {
+        // Current frame: signed current * 100 in bits 55..40
+        set_current_target((float)(int16_t)((data[1] << 8) | data[2]) / 100.0f);
+    } else if (data[0] != 0x0E) {
+        return false;
+    }
+
+    // Status frame: class 0b001, err 0, pos float, |current|*100, temp*2+50
+    uint32_t pos_bits;
+    std::memcpy(&pos_bits, &pos_deg, sizeof(pos_bits));
+    uint64_t cur_raw = (uint64_t)std::min(65535.0f, std::round(std::abs(current_a) * 100.0f));
+    uint64_t temp_raw = (uint64_t)std::max(0.0f, std::min(255.0f, std::round(temp_c * 2.0f + 50.0f)));
+
+    uint64_t out = 0;
+    out |= (uint64_t)0x1ULL << 61;
+    out |= (uint64_t)pos_bits << 24;
+    out |= cur_raw << 8;
+    out |= temp_raw;
+
+    reply_id = id;
+    for (int i = 0; i < 8; ++i) reply[i] = (uint8_t)((out >> (56 - i * 8)) & 0xFF);
+    return true;
+}
@@ -0,0 +1,185 @@
+#include "spi_hand.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+// ===============================================================
+// Packet codec
+// ===============================================================
+void encode_finger_packet(uint8_t seq, const float *angle_deg, uint8_t *out) {
+    uint16_t raw[FINGER_DOF];
+    for (size_t i = 0; i < FINGER_DOF; ++i) {
+        if (std::isnan(angle_deg[i])) {
+            raw[i] = FINGER_ANGLE_HOLD;
+            continue;
+        }
+        float raw_f = std::round(std::max(0.0f, std::min(655.34f, angle_deg[i])) * 100.0f);
+        raw[i] = static_cast<uint16_t>(raw_f);
+    }
+    fingerEncodeCommand(seq, raw, out);
+}
+
+FingerPacket decode_finger_command(const uint8_t *in) {
+    FingerPacket out;
+    uint16_t raw[FINGER_DOF];
+    out.valid = fingerDecodeCommand(in, &out.seq, raw);
+    if (!out.valid) return out;
+    for (size_t i = 0; i < FINGER_DOF; ++i) out.angle_deg[i] = raw[i] == FINGER_ANGLE_HOLD ? NAN : raw[i] * 0.01f;
+    return out;
+}
+
+FingerPacket decode_finger_reply(const uint8_t *in) {
+    FingerPacket out;
+    uint16_t raw[FINGER_DOF];
+    out.valid = fingerDecodeReply(in, &out.seq, raw, &out.status);
+    if (!out.valid) return out;
+    for (size_t i = 0; i < FINGER_DOF; ++i) out.angle_deg[i] = raw[i] * 0.01f;
+    return out;
+}
+
+const char *finger_status_name(uint8_t status) {
+    switch (static_cast<FingerStatus>(status)) {
+        case FingerStatus::Idle: return "idle";
+        case FingerStatus::Moving: return "moving";
+        case FingerStatus::Done: return "done";
+        case FingerStatus::Halt: return "halt";
+    }
+    return "unknown";
+}
+
+// ===============================================================
+// SpidevTransport Implementation
+// ===============================================================
+SpidevTransport::SpidevTransport(const std::string &device, uint32_t speed_hz, uint16_t gap_us)
+    : speed_hz(speed_hz), gap_us(gap_us) {
+    fd = open(device.c_str(), O_RDWR);
+    if (fd < 0) {
+        perror("SPI device open failed");
+        return;
+    }
+
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+    if (ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &this->speed_hz) < 0) {
+        perror("SPI device setup failed");
+        close(fd);
+        fd = -1;
+    }
+}
+
+SpidevTransport::~SpidevTransport() {
+    if (fd >= 0) close(fd);
+}
+
+bool SpidevTransport::transfer(const uint8_t *tx, uint8_t *rx, size_t len, size_t count) {
+    if (fd < 0 || count == 0 || count > MAX_BATCH) return false;
+
+    // One spi_ioc_transfer per packet; cs_change deselects the slave between them
+    struct spi_ioc_transfer xfer[MAX_BATCH];
+    std::memset(xfer, 0, sizeof(xfer));
+    for (size_t i = 0; i < count; ++i) {
+        xfer[i].tx_buf = reinterpret_cast<uintptr_t>(tx + i * len);
+        xfer[i].rx_buf = reinterpret_cast<uintptr_t>(rx + i * len);
+        xfer[i].len = static_cast<uint32_t>(len);
+        xfer[i].speed_hz = speed_hz;
+        xfer[i].bits_per_word = 8;
+        xfer[i].delay_usecs = gap_us;
+        xfer[i].cs_change = (i + 1 < count) ? 1 : 0;
+    }
+
+    int ret = ioctl(fd, SPI_IOC_MESSAGE(count), xfer);
+    return ret >= static_cast<int>(len * count);
+}
+
+// ===============================================================
+// LoopbackSpiSlave Implementation
+// ===============================================================
+static uint32_t steady_ms() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+LoopbackSpiSlave::LoopbackSpiSlave(float slew_deg_per_s, std::function<uint32_t()> millis)
+    : motion(slew_deg_per_s), millis(millis ? std::move(millis) : steady_ms) {
+    float zero[FINGER_DOF] = {};
+    motion.begin(this->millis(), zero);
+}
+
+bool LoopbackSpiSlave::transfer(const uint8_t *tx, uint8_t *rx, size_t len, size_t count) {
+    if (len != FINGER_PACKET_SIZE) return false;
+
+    for (size_t p = 0; p < count; ++p) {
+        // The board's loop keeps the staged reply current between packets: the
+        // last good command's sequence, where the servos are now and the status
+        motion.update(millis());
+        uint16_t pos[FINGER_DOF];
+        for (size_t i = 0; i < FINGER_DOF; ++i) pos[i] = static_cast<uint16_t>(std::round(motion.position(i) * 100.0f));
+        fingerEncodeReply(acked_seq, pos, motion.status(), rx + p * len);
+
+        const uint8_t *cmd = tx + p * len;
+        uint8_t seq;
+        uint16_t raw[FINGER_DOF];
+        if (fingerDecodeCommand(cmd, &seq, raw)) {
+            float angles[FINGER_DOF];
+            for (size_t i = 0; i < FINGER_DOF; ++i) {
+                angles[i] = raw[i] == FINGER_ANGLE_HOLD ? motion.target(i) : raw[i] * 0.01f;
+            }
+            motion.setTarget(angles);
+            acked_seq = seq;
+        } else {
+            crc_errors++;
+        }
+    }
+    return true;
+}
+
+// ===============================================================
+// SpiHandLink Implementation
+// ===============================================================
+SpiHandLink::SpiHandLink(SpiTransport *spi) : spi(spi) {}
+
+bool SpiHandLink::send_angles(const float *angle_deg) {
+    return send_batch(angle_deg, 1, nullptr);
+}
+
+bool SpiHandLink::send_batch(const float *angle_deg, size_t count, FingerPacket *replies) {
+    if (count == 0 || count > SpidevTransport::MAX_BATCH) return false;
+
+    uint8_t tx[SpidevTransport::MAX_BATCH * FINGER_PACKET_SIZE];
+    uint8_t rx[SpidevTransport::MAX_BATCH * FINGER_PACKET_SIZE];
+    for (size_t i = 0; i < count; ++i) {
+        prev_seq = seq;
+        seq = (seq + 1) & FINGER_SEQ_MASK;
+        encode_finger_packet(seq, angle_deg + i * FINGER_DOF, tx + i * FINGER_PACKET_SIZE);
+    }
+
+    if (!spi->transfer(tx, rx, FINGER_PACKET_SIZE, count)) {
+        std::cerr << "[SpiHandLink] SPI transfer failed\n";
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        FingerPacket reply = decode_finger_reply(rx + i * FINGER_PACKET_SIZE);
+        if (replies) replies[i] = reply;
+        if (reply.valid) last_reply = reply;
+        else reply_errors++;
+        reply_ok = reply.valid;
+    }
+    packets_sent += count;
+    std::copy(angle_deg + (count - 1) * FINGER_DOF, angle_deg + count * FINGER_DOF, last_cmd);
+    return true;
+}
+
+bool SpiHandLink::poll() {
+    float cmd[FINGER_DOF];
+    std::copy(last_cmd, last_cmd + FINGER_DOF, cmd);
+    return send_angles(cmd);
+}
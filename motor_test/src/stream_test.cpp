@@ -0,0 +1,117 @@
+#include <chrono>
+#include "current_stream.hpp"
+#include "loopback_bus.hpp"
+#include "motor_control.hpp"
+#include "sim_motor.hpp"
+#include "test_check.hpp"
+#include "velocity_stream.hpp"
+
+// Streaming control modes against simulated drives on the loopback bus
+
+constexpr auto TICK = std::chrono::microseconds(2000);
+
+static void test_current_stream() {
+    LoopbackBus bus;
+    SimRMDMotor sim_rmd(0x141);
+    SimLKtechMotor sim_lk(0x142);
+    SimBionicMotor sim_bionic(0x01);
+    bus.attach(&sim_rmd);
+    bus.attach(&sim_lk);
+    bus.attach(&sim_bionic);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+    LKtech_Motor lk(0x142, &bus, "LK_Sim");
+    RMD_BionicMotor bionic(0x01, &bus, "Bionic_Sim");
+
+    CurrentStream stream(&bus);
+    CHECK(stream.add_motor(&rmd) == 0);
+    CHECK(stream.add_motor(&lk) == 1);
+    CHECK(stream.add_motor(&bionic) == 2);
+
+    const float amps[3] = {1.5f, -1.0f, 0.5f};
+    stream.set_targets(amps, 3);
+    for (int k = 0; k < 10; ++k) {
+        CHECK(stream.tick() == 3);
+        bus.advance(TICK);
+    }
+    // One frame per motor and tick, no read requests
+    CHECK(bus.get_tx_count() == 30);
+    CHECK_NEAR(stream.get_state(0).current, 1.5, 0.02);
+    CHECK_NEAR(stream.get_state(1).current, -1.0, 0.02);
+    CHECK(sim_rmd.get_vel() > 0.0f && sim_lk.get_vel() < 0.0f && sim_bionic.get_vel() > 0.0f);
+
+    // stop() zeroes every output at once; a reply reports the current the
+    // drive had when the frame arrived, so it shows up one tick later
+    stream.stop();
+    for (int k = 0; k < 2; ++k) {
+        bus.advance(TICK);
+        stream.tick();
+    }
+    CHECK_NEAR(stream.get_state(0).current, 0.0, 0.02);
+    CHECK_NEAR(stream.get_state(1).current, 0.0, 0.02);
+    for (int k = 0; k < 250; ++k) {
+        stream.tick();
+        bus.advance(TICK);
+    }
+    CHECK_NEAR(sim_rmd.get_vel(), 0.0, 1.0);
+    CHECK_NEAR(sim_lk.get_vel(), 0.0, 1.0);
+}
+
+static void test_velocity_stream() {
+    LoopbackBus bus;
+    SimRMDMotor sim(0x141);
+    bus.attach(&sim);
+    RMD_Motor rmd(0x141, &bus, "RMD_Sim");
+
+    // The deadman runs on the bus clock, like the drive
+    VelocityStream stream(&bus, std::chrono::milliseconds(50));
+    CHECK(stream.add_motor(&rmd) == 0);
+
+    // No setpoint yet: zero speed, expired
+    CHECK(stream.tick() == 1);
+    CHECK(stream.is_expired(0));
+
+    // The sender publishes every tick
+    for (int k = 0; k < 50; ++k) {
+        stream.set_velocity(0, 10.0f); // rpm = 60 dps
+        stream.tick();
+        bus.advance(TICK);
+    }
+    CHECK(!stream.is_expired(0));
+    CHECK_NEAR(sim.get_vel(), 60.0, 0.5);
+    CHECK_NEAR(stream.get_state(0).vel, 10.0, 0.2);
+
+    // The sender goes quiet: held for 50 ms, then the deadman commands zero speed
+    for (int k = 0; k < 24; ++k) {
+        bus.advance(TICK);
+        stream.tick();
+    }
+    CHECK(!stream.is_expired(0));
+    CHECK_NEAR(sim.get_vel(), 60.0, 0.5);
+    bus.advance(TICK);
+    stream.tick();
+    CHECK(stream.is_expired(0));
+    for (int k = 0; k < 50; ++k) {
+        bus.advance(TICK);
+        stream.tick();
+    }
+    CHECK_NEAR(sim.get_vel(), 0.0, 0.01);
+
+    // A fresh setpoint resumes, stop() zeroes and expires it again
+    for (int k = 0; k < 50; ++k) {
+        stream.set_velocity(0, -5.0f);
+        stream.tick();
+        bus.advance(TICK);
+    }
+    CHECK(!stream.is_expired(0));
+    CHECK_NEAR(sim.get_vel(), -30.0, 0.5);
+    stream.stop();
+    CHECK(stream.is_expired(0));
+    bus.advance(std::chrono::milliseconds(100));
+    CHECK_NEAR(sim.get_vel(), 0.0, 0.01);
+}
+
+int main() {
+    test_current_stream();
+    test_velocity_stream();
+    return test_result("stream_test");
+}
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "telemetry_reader.hpp"
+#include "spi_hand.hpp"
+
+// Prints the binary telemetry of the hand board, e.g.
+//   ./telemetry_dump /dev/ttyACM0 [baud]
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cout << "Usage: telemetry_dump <serial device> [baud]\n";
+        return 1;
+    }
+
+    TelemetryReader reader(argv[1], argc > 2 ? std::atoi(argv[2]) : 115200);
+    if (!reader.is_open()) return 1;
+
+    HandTelemetry records[8];
+    uint64_t errors_before = 0;
+    while (true) {
+        size_t n = reader.poll(records, 8, 1000);
+        for (size_t i = 0; i < n; ++i) {
+            const HandTelemetry &t = records[i];
+            std::cout << "[Hand] t " << t.timeMs << " ms | seq " << (int)t.seq << " | "
+                      << finger_status_name(t.status) << " | pos";
+            for (size_t d = 0; d < HAND_TELEMETRY_DOF; ++d)
+                std::cout << " " << std::fixed << std::setprecision(2) << t.pos[d] * 0.01f;
+            std::cout << " | force " << t.force << " | crc err " << t.crcErrors
+                      << " | overruns " << t.rxOverruns << std::endl;
+        }
+        if (reader.get_error_count() != errors_before) {
+            errors_before = reader.get_error_count();
+            std::cerr << "[Hand] " << errors_before << " bad frames so far" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "telemetry_reader.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+static speed_t baud_constant(int baud) {
+    switch (baud) {
+        case 57600: return B57600;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B115200;
+    }
+}
+
+TelemetryReader::TelemetryReader(const std::string &device, int baud) {
+    if (device.empty()) return;
+
+    fd = open(device.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        perror("Serial device open failed");
+        return;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) < 0) {
+        perror("Serial device setup failed");
+        close(fd);
+        fd = -1;
+        return;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, baud_constant(baud));
+    cfsetospeed(&tio, baud_constant(baud));
+    tio.c_cflag |= CLOCAL | CREAD;
+    if (tcsetattr(fd, TCSANOW, &tio) < 0) {
+        perror("Serial device setup failed");
+        close(fd);
+        fd = -1;
+    }
+}
+
+TelemetryReader::~TelemetryReader() {
+    if (fd >= 0) close(fd);
+}
+
+size_t TelemetryReader::feed(const uint8_t *data, size_t len, HandTelemetry *out, size_t max) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t b = data[i];
+        if (b != 0x00) {
+            if (fill < sizeof(frame)) {
+                frame[fill++] = b;
+            } else {
+                overflow = true;
+            }
+            continue;
+        }
+
+        // Delimiter: decode what was collected (empty frames are just padding)
+        if (fill > 0 || overflow) {
+            HandTelemetry t;
+            if (!overflow && telemetryDecode(frame, (uint8_t)fill, &t)) {
+                frames++;
+                if (count < max) out[count++] = t;
+            } else {
+                errors++;
+            }
+        }
+        fill = 0;
+        overflow = false;
+    }
+    return count;
+}
+
+size_t TelemetryReader::poll(HandTelemetry *out, size_t max, int timeout_ms) {
+    if (fd < 0) return 0;
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (::poll(&pfd, 1, timeout_ms) <= 0) return 0;
+
+    // One record is 42 bytes; read a few at a time so max is rarely exceeded
+    uint8_t buf[4 * HAND_TELEMETRY_WIRE_SIZE];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) return 0;
+    return feed(buf, (size_t)n, out, max);
+}
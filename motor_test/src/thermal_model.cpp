@@ -0,0 +1,63 @@
+#include "thermal_model.hpp"
+#include <algorithm>
+#include <cmath>
+
+ThermalModel::ThermalModel(size_t joints) : ThermalModel(joints, Params()) {}
+
+ThermalModel::ThermalModel(size_t joints, const Params &params)
+    : joints(std::min(joints, MAX_JOINTS)), params(params),
+      decay(std::exp(-params.cooling_rate * params.horizon)) {
+    for (size_t j = 0; j < MAX_JOINTS; ++j) {
+        temp_est[j] = params.ambient;
+        refresh_allowed(j);
+    }
+}
+
+void ThermalModel::update(const float *current, const float *temp, float dt) {
+    const float a = params.heat_gain * dt;
+    const float b = params.cooling_rate * dt;
+    const float k = std::min(1.0f, params.correction * dt);
+
+    for (size_t j = 0; j < joints; ++j) {
+        float t = temp_est[j];
+        t += a * current[j] * current[j] - b * (t - params.ambient);
+        // NaN compares false, so missing measurements leave the prediction as is
+        float meas = temp[j];
+        t += (meas == meas) ? k * (meas - t) : 0.0f;
+        temp_est[j] = t;
+    }
+    for (size_t j = 0; j < joints; ++j) refresh_allowed(j);
+}
+
+void ThermalModel::update_joint(size_t joint, float current, float temp, float dt) {
+    if (joint >= joints) return;
+    float t = temp_est[joint];
+    t += params.heat_gain * dt * current * current - params.cooling_rate * dt * (t - params.ambient);
+    if (!std::isnan(temp)) t += std::min(1.0f, params.correction * dt) * (temp - t);
+    temp_est[joint] = t;
+    refresh_allowed(joint);
+}
+
+void ThermalModel::refresh_allowed(size_t joint) {
+    // T(h) = T_ss + (T - T_ss) * decay <= limit  ->  T_ss <= (limit - T * decay) / (1 - decay)
+    float t_ss_max = (params.limit - temp_est[joint] * decay) / (1.0f - decay);
+    allowed_sq[joint] = std::max(0.0f, (t_ss_max - params.ambient) * params.cooling_rate / params.heat_gain);
+}
+
+float ThermalModel::time_to_limit(size_t joint, float current) const {
+    float t = temp_est[joint];
+    if (t >= params.limit) return 0.0f;
+    float t_ss = params.ambient + params.heat_gain * current * current / params.cooling_rate;
+    if (t_ss <= params.limit) return -1.0f;
+    return std::log((t_ss - t) / (t_ss - params.limit)) / params.cooling_rate;
+}
+
+float ThermalModel::allowed_current(size_t joint) const {
+    return std::sqrt(allowed_sq[joint]);
+}
+
+float ThermalModel::derate(size_t joint, float requested) const {
+    if (joint >= joints) return requested;
+    float allowed = allowed_current(joint);
+    return std::max(-allowed, std::min(allowed, requested));
+}
@@ -0,0 +1,109 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// Buffers live until exit: a thread that ended still has events to dump
+static std::atomic<TraceBuffer*> trace_buffers[TRACE_MAX_THREADS];
+static std::atomic<size_t> trace_buffer_count{0};
+static thread_local TraceBuffer *local_buffer = nullptr;
+static thread_local bool local_buffer_failed = false;
+
+TraceBuffer *trace_thread_buffer() {
+    if (local_buffer || local_buffer_failed) return local_buffer;
+    size_t slot = trace_buffer_count.fetch_add(1);
+    if (slot >= TRACE_MAX_THREADS) {
+        local_buffer_failed = true;
+        std::cerr << "[Trace] More than " << TRACE_MAX_THREADS << " threads, not tracing this one\n";
+        return nullptr;
+    }
+    local_buffer = new TraceBuffer((uint32_t)syscall(SYS_gettid));
+    trace_buffers[slot].store(local_buffer, std::memory_order_release);
+    return local_buffer;
+}
+
+void trace_thread_name(const char *name) {
+    if (TraceBuffer *b = trace_thread_buffer()) b->set_name(name);
+}
+
+#if MOTOR_TRACE
+// Names are literals from this code base; escape anyway so the file always parses
+static void write_json_string(FILE *f, const char *s) {
+    std::fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) std::fputc(*s, f);
+    }
+    std::fputc('"', f);
+}
+#endif
+
+bool trace_dump(const std::string &path) {
+#if !MOTOR_TRACE
+    std::cerr << "[Trace] Built without tracing (cmake -DMOTOR_TRACE=ON), " << path << " not written\n";
+    return false;
+#else
+    FILE *f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::cerr << "[Trace] Cannot write " << path << "\n";
+        return false;
+    }
+
+    size_t threads = std::min(trace_buffer_count.load(), TRACE_MAX_THREADS);
+    TraceBuffer *buffers[TRACE_MAX_THREADS];
+    uint64_t first[TRACE_MAX_THREADS], last[TRACE_MAX_THREADS];
+    int64_t origin = INT64_MAX;
+    uint64_t events = 0, lost = 0;
+    for (size_t t = 0; t < threads; ++t) {
+        buffers[t] = trace_buffers[t].load(std::memory_order_acquire);
+        if (!buffers[t]) {  // slot claimed, buffer not published yet
+            first[t] = last[t] = 0;
+            continue;
+        }
+        last[t] = buffers[t]->get_written();
+        first[t] = last[t] > TraceBuffer::CAPACITY ? last[t] - TraceBuffer::CAPACITY : 0;
+        lost += first[t];
+        events += last[t] - first[t];
+        // Events are recorded when a span ends, so an enclosing span comes
+        // after the ones it contains and starts earlier than the first event
+        for (uint64_t n = first[t]; n < last[t]; ++n) origin = std::min(origin, buffers[t]->get_event(n).start_ns);
+    }
+    if (origin == INT64_MAX) origin = 0;
+
+    // Complete ("X") events with microsecond timestamps, plus one thread_name record per thread
+    int pid = (int)getpid();
+    bool comma = false;
+    std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (size_t t = 0; t < threads; ++t) {
+        if (!buffers[t]) continue;
+        uint32_t tid = buffers[t]->get_tid();
+        const char *name = buffers[t]->get_name();
+        if (name) {
+            std::fprintf(f, "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+                         comma ? "," : "", pid, tid);
+            write_json_string(f, name);
+            std::fprintf(f, "}}");
+            comma = true;
+        }
+        for (uint64_t n = first[t]; n < last[t]; ++n) {
+            const TraceBuffer::Event &e = buffers[t]->get_event(n);
+            std::fprintf(f, "%s\n{\"ph\":\"X\",\"cat\":", comma ? "," : "");
+            write_json_string(f, e.cat);
+            std::fprintf(f, ",\"name\":");
+            write_json_string(f, e.name);
+            std::fprintf(f, ",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", pid, tid,
+                         (e.start_ns - origin) / 1000.0, e.dur_ns / 1000.0);
+            comma = true;
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    bool ok = std::fclose(f) == 0;
+
+    std::cout << "[Trace] " << events << " events from " << threads << " threads written to " << path;
+    if (lost > 0) std::cout << " (" << lost << " older events overwritten)";
+    std::cout << std::endl;
+    return ok;
+#endif
+}
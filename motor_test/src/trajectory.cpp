@@ -0,0 +1,203 @@
+#include "trajectory.hpp"
+#include "rt_check.hpp"
+#include "periodic_loop.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool load_waypoints(const std::string &path, std::vector<Waypoint> &out) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "[Trajectory] Cannot open " << path << "\n";
+        return false;
+    }
+
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        line_no++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        std::istringstream in(line);
+        Waypoint w;
+        int joint;
+        if (!(in >> w.time_s >> joint >> w.target_deg >> w.vel_rpm >> w.current_a) ||
+            joint < 0 || w.time_s < 0.0f) {
+            std::cerr << "[Trajectory] " << path << ":" << line_no
+                      << ": expected 'time joint target vel current'\n";
+            return false;
+        }
+        w.joint = (uint16_t)joint;
+        out.push_back(w);
+    }
+    return true;
+}
+
+std::vector<TrajectoryStep> compile_trajectory(const std::vector<Waypoint> &waypoints,
+                                               std::chrono::microseconds period) {
+    std::vector<TrajectoryStep> steps;
+    steps.reserve(waypoints.size());
+    double ticks_per_s = 1e6 / (double)period.count();
+    for (const Waypoint &w : waypoints) {
+        TrajectoryStep s;
+        s.tick = (uint32_t)std::llround(w.time_s * ticks_per_s);
+        s.joint = w.joint;
+        s.reserved = 0;
+        s.target_deg = w.target_deg;
+        s.vel_rpm = w.vel_rpm;
+        s.current_a = w.current_a;
+        steps.push_back(s);
+    }
+    std::stable_sort(steps.begin(), steps.end(),
+                     [](const TrajectoryStep &a, const TrajectoryStep &b) { return a.tick < b.tick; });
+    return steps;
+}
+
+TrajectoryRunner::TrajectoryRunner(CanTransport *bus, MotorControl *const *motors, size_t count, float tolerance_deg)
+    : bus(bus), motors(motors), count(std::min(count, MAX_JOINTS)), tolerance(tolerance_deg) {}
+
+void TrajectoryRunner::finish_move(JointTrack &t, std::chrono::microseconds period) {
+    if (!t.active) return;
+    stats.moves++;
+    if (t.settled_tick >= 0) {
+        stats.settled++;
+        stats.settle_ms.push_back((float)(t.settled_tick - t.move_tick) * period.count() / 1000.0f);
+    }
+}
+
+bool TrajectoryRunner::run(const std::vector<TrajectoryStep> &steps, std::chrono::microseconds period,
+                           std::chrono::milliseconds settle_timeout) {
+    for (const TrajectoryStep &s : steps) {
+        if (s.joint >= count) {
+            std::cerr << "[Trajectory] Step for joint " << s.joint << " but only " << count << " motors\n";
+            return false;
+        }
+    }
+
+    stats = TrajectoryStats();
+    stats.settle_ms.reserve(steps.size());
+    for (size_t j = 0; j < count; ++j) track[j] = JointTrack();
+
+    // The queue plans from where each joint actually is
+    if (queue) {
+        for (size_t j = 0; j < count; ++j) {
+            float pos = motors[j]->get_state().pos;
+            if (std::isnan(pos)) pos = motors[j]->position_read();
+            if (std::isnan(pos)) {
+                std::cerr << "[Trajectory] No position from " << motors[j]->get_name() << "\n";
+                return false;
+            }
+            queue->reset(j, pos);
+        }
+    }
+    const float dt = period.count() * 1e-6f;
+
+    uint32_t last_tick = steps.empty() ? 0 : steps.back().tick;
+    uint32_t end_tick = last_tick + (uint32_t)(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                   settle_timeout).count() / period.count());
+    size_t next = 0;
+    uint32_t tick = 0;
+    std::atomic<bool> done{false};
+
+    PeriodicLoop loop;
+    loop.start(period, [&] {
+        if (done.load(std::memory_order_relaxed)) return;
+        RT_SECTION();
+
+        // Feedback: replies to the previous tick's setpoints
+        drain_replies(bus, motors, count);
+        for (size_t j = 0; j < count; ++j) {
+            JointTrack &t = track[j];
+            float pos = motors[j]->get_state().pos;
+            if (!t.active || std::isnan(pos)) continue;
+            if (std::isnan(t.start_pos)) t.start_pos = pos;
+
+            // Reference: the queue's last setpoint, or a constant-speed ramp
+            // (rpm -> deg/s) from the start to the target
+            float elapsed_s = (float)(tick - t.move_tick) * dt;
+            float travel = t.target - t.start_pos;
+            float ramp = std::min(std::abs(travel), std::abs(t.vel) * 6.0f * elapsed_s);
+            float ref = queue ? t.setpoint : t.start_pos + std::copysign(ramp, travel);
+            float err = std::abs(pos - ref);
+            stats.sq_error_sum += (double)err * err;
+            stats.error_samples++;
+            stats.max_error = std::max(stats.max_error, err);
+
+            if (std::abs(pos - t.target) <= tolerance) {
+                if (t.settled_tick < 0) t.settled_tick = tick;
+            } else {
+                t.settled_tick = -1;
+            }
+        }
+
+        // New setpoints due at this tick
+        for (; next < steps.size() && steps[next].tick <= tick; ++next) {
+            const TrajectoryStep &s = steps[next];
+            // A full queue: the step waits for room
+            if (queue && !queue->push(s.joint, s.target_deg, s.vel_rpm * 6.0f)) break;
+            JointTrack &t = track[s.joint];
+            finish_move(t, period);
+            t.active = true;
+            t.target = s.target_deg;
+            t.vel = s.vel_rpm;
+            t.current = s.current_a;
+            t.start_pos = motors[s.joint]->get_state().pos; // NAN until the first reply
+            t.move_tick = tick;
+            t.settled_tick = -1;
+        }
+
+        float setpoint[MotionQueue::MAX_JOINTS];
+        if (queue) queue->step(dt, setpoint);
+        bus->begin_batch();
+        for (size_t j = 0; j < count; ++j) {
+            JointTrack &t = track[j];
+            if (!t.active) continue;
+            if (queue) t.setpoint = setpoint[j];
+            motors[j]->setpoint_write(queue ? t.setpoint : t.target, t.vel, t.current);
+        }
+        bus->flush();
+
+        // Past the last step: stop as soon as every joint is in its band
+        bool all_settled = !queue || queue->idle();
+        for (size_t j = 0; j < count; ++j) {
+            if (track[j].active && track[j].settled_tick < 0) all_settled = false;
+        }
+        if (tick >= end_tick || (next == steps.size() && tick > last_tick && all_settled)) {
+            done.store(true, std::memory_order_relaxed);
+        }
+        tick++;
+    });
+
+    while (!done.load(std::memory_order_relaxed)) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    loop.stop();
+
+    for (size_t j = 0; j < count; ++j) finish_move(track[j], period);
+    stats.ticks = tick;
+    stats.overruns = loop.get_overrun_count();
+    return true;
+}
+
+void TrajectoryRunner::report() const {
+    std::cout << "\n[Trajectory] " << stats.moves << " moves, " << stats.settled << " settled within "
+              << tolerance << " deg, " << stats.ticks << " ticks, " << stats.overruns << " overruns\n";
+
+    if (!stats.settle_ms.empty()) {
+        std::vector<float> sorted = stats.settle_ms;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (float v : sorted) sum += v;
+        std::cout << "  settle time: min " << sorted.front() << " ms, mean " << sum / sorted.size()
+                  << " ms, p95 " << sorted[(size_t)(0.95 * (sorted.size() - 1))] << " ms, max "
+                  << sorted.back() << " ms\n";
+    }
+    if (stats.error_samples > 0) {
+        std::cout << "  tracking error: rms " << std::sqrt(stats.sq_error_sum / stats.error_samples)
+                  << " deg, max " << stats.max_error << " deg over " << stats.error_samples
+                  << " samples" << std::endl;
+    }
+}
@@ -0,0 +1,55 @@
+#include "velocity_stream.hpp"
+#include "rt_check.hpp"
+#include <cstdint>
+#include <iostream>
+
+// Stamp of a motor without a live setpoint: always expired
+static constexpr int64_t NO_SETPOINT = INT64_MIN;
+
+VelocityStream::VelocityStream(CanTransport *bus, std::chrono::milliseconds deadman)
+    : bus(bus), deadman(std::chrono::duration_cast<std::chrono::microseconds>(deadman)) {}
+
+int VelocityStream::add_motor(MotorControl *motor) {
+    uint8_t probe[8];
+    if (count >= MAX_MOTORS || !motor->encode_velocity(0.0f, probe)) {
+        std::cerr << "[VelocityStream] Cannot stream velocity to " << motor->get_name() << "\n";
+        return -1;
+    }
+    motors[count] = motor;
+    setpoints[count] = 0.0f;
+    stamps[count] = NO_SETPOINT;
+    expired[count] = true;
+    return (int)count++;
+}
+
+void VelocityStream::set_velocity(size_t index, float rpm) {
+    if (index >= count) return;
+    setpoints[index].store(rpm, std::memory_order_relaxed);
+    stamps[index].store(bus->now().count(), std::memory_order_release);
+}
+
+size_t VelocityStream::tick() {
+    RT_SECTION();
+    drain_replies(bus, motors.data(), count);
+
+    int64_t now = bus->now().count();
+    bus->begin_batch();
+    size_t sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t stamp = stamps[i].load(std::memory_order_acquire);
+        float rpm = setpoints[i].load(std::memory_order_relaxed);
+
+        bool timed_out = stamp == NO_SETPOINT || (now - stamp) > deadman.count();
+        if (timed_out) rpm = 0.0f;
+        expired[i].store(timed_out, std::memory_order_relaxed);
+
+        if (motors[i]->velocity_write(rpm)) sent++;
+    }
+    bus->flush();
+    return sent;
+}
+
+void VelocityStream::stop() {
+    for (size_t i = 0; i < count; ++i) stamps[i].store(NO_SETPOINT, std::memory_order_release);
+    tick();
+}
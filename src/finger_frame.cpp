@@ -0,0 +1,56 @@
+#include "finger_frame.h"
+
+uint8_t fingerCrc8(const uint8_t *data, uint8_t len) {
+  uint8_t crc = 0x00;
+  for (uint8_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void putAngles(const uint16_t *raw, uint8_t *frame) {
+  for (uint8_t i = 0; i < FINGER_FRAME_DOF; i++) {
+    frame[1 + 2 * i] = raw[i] & 0xFF;       // LSB first
+    frame[2 + 2 * i] = (raw[i] >> 8) & 0xFF;
+  }
+}
+
+static void getAngles(const uint8_t *frame, uint16_t *raw) {
+  for (uint8_t i = 0; i < FINGER_FRAME_DOF; i++) {
+    raw[i] = (uint16_t(frame[2 + 2 * i]) << 8) | frame[1 + 2 * i];
+  }
+}
+
+void fingerEncodeCommand(uint8_t seq, const uint16_t *raw, uint8_t *frame) {
+  frame[0] = FINGER_SYNC_COMMAND | (seq & FINGER_SEQ_MASK);
+  putAngles(raw, frame);
+  frame[13] = 0x00;
+  frame[14] = fingerCrc8(frame, FINGER_FRAME_SIZE - 1);
+}
+
+bool fingerDecodeCommand(const uint8_t *frame, uint8_t *seq, uint16_t *raw) {
+  if ((frame[0] & FINGER_SYNC_MASK) != FINGER_SYNC_COMMAND) return false;
+  if (fingerCrc8(frame, FINGER_FRAME_SIZE - 1) != frame[14]) return false;
+  *seq = frame[0] & FINGER_SEQ_MASK;
+  getAngles(frame, raw);
+  return true;
+}
+
+void fingerEncodeReply(uint8_t seq, const uint16_t *raw, uint8_t status, uint8_t *frame) {
+  frame[0] = FINGER_SYNC_REPLY | (seq & FINGER_SEQ_MASK);
+  putAngles(raw, frame);
+  frame[13] = status;
+  frame[14] = fingerCrc8(frame, FINGER_FRAME_SIZE - 1);
+}
+
+bool fingerDecodeReply(const uint8_t *frame, uint8_t *seq, uint16_t *raw, uint8_t *status) {
+  if ((frame[0] & FINGER_SYNC_MASK) != FINGER_SYNC_REPLY) return false;
+  if (fingerCrc8(frame, FINGER_FRAME_SIZE - 1) != frame[14]) return false;
+  *seq = frame[0] & FINGER_SEQ_MASK;
+  getAngles(frame, raw);
+  *status = frame[13];
+  return true;
+}
@@ -0,0 +1,45 @@
+#ifndef FINGER_FRAME_H
+#define FINGER_FRAME_H
+
+#include <stdint.h>
+
+// 15-byte SPI frame between the host/master and the hand board, shared by
+// Hand_Moving.ino, Sending_Data_Demo.ino and motor_test (spi_hand).
+//
+// Command, master -> slave:
+//   byte 0     : 0xA0 | seq      (sync nibble + 4-bit sequence counter)
+//   bytes 1..12: 6 DOFs x uint16 LSB-first, 0.01 deg
+//                (Pinky, Ring, Middle, Index, Thumb DOF1, Thumb DOF2);
+//                FINGER_ANGLE_HOLD keeps that DOF on its current target
+//   byte 13    : reserved, 0x00
+//   byte 14    : CRC-8 (poly 0x07, init 0x00) over bytes 0..13
+//
+// Reply, slave -> master (clocked out during the next command):
+//   byte 0     : 0x50 | seq      (sequence of the last accepted command)
+//   bytes 1..12: DOF angles the servos are at (slew position, not the target)
+//   byte 13    : status (0x00 idle, 0x01 moving, 0x02 done, 0x12 halt)
+//   byte 14    : CRC-8 over bytes 0..13, as in the command
+
+#define FINGER_FRAME_SIZE   15
+#define FINGER_FRAME_DOF    6
+#define FINGER_SYNC_MASK    0xF0
+#define FINGER_SYNC_COMMAND 0xA0
+#define FINGER_SYNC_REPLY   0x50
+#define FINGER_SEQ_MASK     0x0F
+#define FINGER_ANGLE_HOLD   0xFFFF
+
+// CRC-8, polynomial 0x07 (x^8 + x^2 + x + 1), init 0x00
+uint8_t fingerCrc8(const uint8_t *data, uint8_t len);
+
+// raw: FINGER_FRAME_DOF angles in 0.01 deg
+void fingerEncodeCommand(uint8_t seq, const uint16_t *raw, uint8_t *frame);
+
+// Returns false on a bad sync nibble or CRC
+bool fingerDecodeCommand(const uint8_t *frame, uint8_t *seq, uint16_t *raw);
+
+void fingerEncodeReply(uint8_t seq, const uint16_t *raw, uint8_t status, uint8_t *frame);
+
+// Returns false on a bad sync nibble or CRC
+bool fingerDecodeReply(const uint8_t *frame, uint8_t *seq, uint16_t *raw, uint8_t *status);
+
+#endif // FINGER_FRAME_H
@@ -0,0 +1,58 @@
+#include "force_filter.h"
+
+ForceFilter::ForceFilter() {
+  reset();
+}
+
+void ForceFilter::reset() {
+  head = 0;
+  n = 0;
+  sum = 0;
+}
+
+void ForceFilter::push(int32_t sample) {
+  if (n == FORCE_FILTER_SIZE) {
+    int32_t oldest = ring[head];
+    sum -= oldest;
+    removeSorted(oldest);
+  } else {
+    n++;
+  }
+  ring[head] = sample;
+  head = (head + 1) % FORCE_FILTER_SIZE;
+  sum += sample;
+  insertSorted(sample);
+}
+
+void ForceFilter::removeSorted(int32_t value) {
+  // Called while the window is full: n entries are valid
+  uint8_t i = 0;
+  while (i < n && sorted[i] != value) i++;
+  for (; i + 1 < n; i++) sorted[i] = sorted[i + 1];
+}
+
+void ForceFilter::insertSorted(int32_t value) {
+  // n already counts the new sample: n - 1 entries are valid
+  int8_t i = (int8_t)n - 2;
+  while (i >= 0 && sorted[i] > value) {
+    sorted[i + 1] = sorted[i];
+    i--;
+  }
+  sorted[i + 1] = value;
+}
+
+int32_t ForceFilter::mean() const {
+  return n ? sum / n : 0;
+}
+
+int32_t ForceFilter::median() const {
+  if (n == 0) return 0;
+  if (n & 1) return sorted[n / 2];
+  return (int32_t)(((int64_t)sorted[n / 2 - 1] + sorted[n / 2]) / 2);
+}
+
+bool ForceFilter::outOfRange(int32_t lower, int32_t upper) const {
+  if (n == 0) return false;
+  int32_t m = median();
+  return m < lower || m > upper;
+}
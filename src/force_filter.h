@@ -0,0 +1,41 @@
+#ifndef FORCE_FILTER_H
+#define FORCE_FILTER_H
+
+#include <stdint.h>
+
+// Moving-average / median filter over the last FORCE_FILTER_SIZE HX711 samples.
+// Each push is O(1) for the mean and O(N) (N = 8) to keep the sorted copy for the
+// median. No Arduino headers, so it builds on Linux as well (motor_test/CMakeLists.txt).
+
+#define FORCE_FILTER_SIZE 8
+
+class ForceFilter {
+public:
+  ForceFilter();
+
+  void reset();
+
+  // Adds one raw sample, replacing the oldest once the window is full
+  void push(int32_t sample);
+
+  uint8_t count() const { return n; }
+  bool full() const { return n == FORCE_FILTER_SIZE; }
+
+  int32_t mean() const;
+  int32_t median() const;
+
+  // True if the median is outside [lower, upper]; false until a sample arrived
+  bool outOfRange(int32_t lower, int32_t upper) const;
+
+private:
+  int32_t ring[FORCE_FILTER_SIZE];    // samples in arrival order
+  int32_t sorted[FORCE_FILTER_SIZE];  // same samples, ascending
+  uint8_t head;
+  uint8_t n;
+  int32_t sum;                        // 24-bit samples: 8 of them fit easily
+
+  void removeSorted(int32_t value);
+  void insertSorted(int32_t value);
+};
+
+#endif // FORCE_FILTER_H
@@ -0,0 +1,122 @@
+#include "hand_telemetry.h"
+#include "finger_frame.h"
+
+uint8_t cobsEncode(const uint8_t *in, uint8_t len, uint8_t *out) {
+  uint8_t codeIdx = 0;
+  uint8_t n = 1;
+  uint8_t code = 1;
+  for (uint8_t i = 0; i < len; i++) {
+    if (in[i] == 0) {
+      out[codeIdx] = code;
+      codeIdx = n++;
+      code = 1;
+    } else {
+      out[n++] = in[i];
+      if (++code == 0xFF) {
+        out[codeIdx] = code;
+        codeIdx = n++;
+        code = 1;
+      }
+    }
+  }
+  out[codeIdx] = code;
+  return n;
+}
+
+uint8_t cobsDecode(const uint8_t *in, uint8_t len, uint8_t *out) {
+  uint8_t i = 0;
+  uint8_t n = 0;
+  while (i < len) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > len) return 0;
+    for (uint8_t k = 1; k < code; k++) {
+      if (in[i] == 0) return 0;
+      out[n++] = in[i++];
+    }
+    if (code != 0xFF && i < len) out[n++] = 0;
+  }
+  return n;
+}
+
+static void putU16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+}
+
+static void putU32(uint8_t *p, uint32_t v) {
+  for (uint8_t i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+static uint16_t getU16(const uint8_t *p) {
+  return (uint16_t(p[1]) << 8) | p[0];
+}
+
+static uint32_t getU32(const uint8_t *p) {
+  uint32_t v = 0;
+  for (uint8_t i = 0; i < 4; i++) v |= uint32_t(p[i]) << (8 * i);
+  return v;
+}
+
+uint8_t telemetryEncode(const HandTelemetry *t, uint8_t *out) {
+  uint8_t rec[HAND_TELEMETRY_SIZE];
+  rec[0] = HAND_TELEMETRY_TYPE;
+  putU32(&rec[1], t->timeMs);
+  rec[5] = t->seq;
+  rec[6] = t->status;
+  for (uint8_t i = 0; i < HAND_TELEMETRY_DOF; i++) {
+    putU16(&rec[7 + 2 * i], t->pos[i]);
+    putU16(&rec[19 + 2 * i], t->target[i]);
+  }
+  putU32(&rec[31], (uint32_t)t->force);
+  putU16(&rec[35], t->crcErrors);
+  putU16(&rec[37], t->rxOverruns);
+  rec[39] = fingerCrc8(rec, HAND_TELEMETRY_SIZE - 1);
+
+  uint8_t n = cobsEncode(rec, HAND_TELEMETRY_SIZE, out);
+  out[n++] = 0x00;
+  return n;
+}
+
+bool telemetryDecode(const uint8_t *in, uint8_t len, HandTelemetry *t) {
+  if (len > HAND_TELEMETRY_WIRE_SIZE) return false;
+  uint8_t rec[HAND_TELEMETRY_WIRE_SIZE];
+  if (cobsDecode(in, len, rec) != HAND_TELEMETRY_SIZE) return false;
+  if (rec[0] != HAND_TELEMETRY_TYPE) return false;
+  if (fingerCrc8(rec, HAND_TELEMETRY_SIZE - 1) != rec[39]) return false;
+
+  t->timeMs = getU32(&rec[1]);
+  t->seq = rec[5];
+  t->status = rec[6];
+  for (uint8_t i = 0; i < HAND_TELEMETRY_DOF; i++) {
+    t->pos[i] = getU16(&rec[7 + 2 * i]);
+    t->target[i] = getU16(&rec[19 + 2 * i]);
+  }
+  t->force = (int32_t)getU32(&rec[31]);
+  t->crcErrors = getU16(&rec[35]);
+  t->rxOverruns = getU16(&rec[37]);
+  return true;
+}
+
+TelemetryRing::TelemetryRing() : head(0), count(0), drops(0) {}
+
+bool TelemetryRing::push(const uint8_t *data, uint8_t len) {
+  if (len > HAND_TELEMETRY_RING_SIZE - count) {
+    drops++;
+    return false;
+  }
+  uint8_t tail = (head + count) % HAND_TELEMETRY_RING_SIZE;
+  for (uint8_t i = 0; i < len; i++) {
+    buf[tail] = data[i];
+    tail = (tail + 1) % HAND_TELEMETRY_RING_SIZE;
+  }
+  count += len;
+  return true;
+}
+
+uint8_t TelemetryRing::pop() {
+  if (count == 0) return 0;
+  uint8_t b = buf[head];
+  head = (head + 1) % HAND_TELEMETRY_RING_SIZE;
+  count--;
+  return b;
+}
@@ -0,0 +1,77 @@
+#ifndef HAND_TELEMETRY_H
+#define HAND_TELEMETRY_H
+
+#include <stdint.h>
+
+// Binary debug telemetry of the hand board, replacing the ASCII Serial prints.
+// No Arduino headers: the sketch drains the ring into Serial, motor_test decodes
+// the same frames on Linux (telemetry_reader).
+//
+// Record, 40 bytes, little-endian:
+//   byte 0     : HAND_TELEMETRY_TYPE
+//   bytes 1..4 : millis() when the record was made
+//   byte 5     : sequence of the last accepted SPI command
+//   byte 6     : status (0x00 idle, 0x01 moving, 0x02 done, 0x12 halt)
+//   bytes 7..18: 6 DOF positions, uint16 0.01 deg
+//   bytes 19..30: 6 DOF targets, uint16 0.01 deg
+//   bytes 31..34: filtered HX711 value, int32
+//   bytes 35..36: SPI CRC errors
+//   bytes 37..38: SPI frames dropped while loop() was busy
+//   byte 39    : CRC-8 (fingerCrc8) over bytes 0..38
+//
+// On the wire every record is COBS-encoded and terminated by 0x00, so a
+// reader resynchronises at the next zero after a lost byte.
+
+#define HAND_TELEMETRY_TYPE      0x01
+#define HAND_TELEMETRY_DOF       6
+#define HAND_TELEMETRY_SIZE      40
+#define HAND_TELEMETRY_WIRE_SIZE (HAND_TELEMETRY_SIZE + 2)  // COBS overhead + delimiter
+#define HAND_TELEMETRY_RING_SIZE 128                        // 3 frames
+
+struct HandTelemetry {
+  uint32_t timeMs;
+  uint8_t seq;
+  uint8_t status;
+  uint16_t pos[HAND_TELEMETRY_DOF];     // 0.01 deg
+  uint16_t target[HAND_TELEMETRY_DOF];  // 0.01 deg
+  int32_t force;
+  uint16_t crcErrors;
+  uint16_t rxOverruns;
+};
+
+// COBS (consistent overhead byte stuffing); out needs len + len / 254 + 1 bytes.
+// Returns the encoded length, without the 0x00 delimiter.
+uint8_t cobsEncode(const uint8_t *in, uint8_t len, uint8_t *out);
+
+// Returns the decoded length, or 0 if the input is malformed
+uint8_t cobsDecode(const uint8_t *in, uint8_t len, uint8_t *out);
+
+// Encodes a record ready for the wire (COBS + 0x00); out needs HAND_TELEMETRY_WIRE_SIZE.
+// Returns the number of bytes written.
+uint8_t telemetryEncode(const HandTelemetry *t, uint8_t *out);
+
+// Decodes a COBS frame without its delimiter; false on bad length, type or CRC
+bool telemetryDecode(const uint8_t *in, uint8_t len, HandTelemetry *t);
+
+// Byte FIFO between the encoder and a non-blocking UART writer.
+// Frames are pushed whole or dropped, so the stream never carries a partial record.
+class TelemetryRing {
+public:
+  TelemetryRing();
+
+  // False (and counted) if the frame does not fit
+  bool push(const uint8_t *data, uint8_t len);
+
+  uint8_t available() const { return count; }
+  uint8_t pop();
+
+  uint16_t dropped() const { return drops; }
+
+private:
+  uint8_t buf[HAND_TELEMETRY_RING_SIZE];
+  uint8_t head;
+  uint8_t count;
+  uint16_t drops;
+};
+
+#endif // HAND_TELEMETRY_H
@@ -0,0 +1,70 @@
+#include "servo_motion.h"
+
+ServoMotion::ServoMotion(float slewDegPerSec)
+  : slew(slewDegPerSec), lastMs(0), commanded(false), halted(false) {
+  for (uint8_t i = 0; i < SERVO_DOF; i++) {
+    pos[i] = 0.0f;
+    tgt[i] = 0.0f;
+  }
+}
+
+void ServoMotion::begin(uint32_t nowMs, const float *angles) {
+  for (uint8_t i = 0; i < SERVO_DOF; i++) {
+    pos[i] = angles[i];
+    tgt[i] = angles[i];
+  }
+  lastMs = nowMs;
+}
+
+void ServoMotion::setSlewRate(float degPerSec) {
+  slew = degPerSec;
+}
+
+void ServoMotion::setTarget(const float *angles) {
+  for (uint8_t i = 0; i < SERVO_DOF; i++) tgt[i] = angles[i];
+  commanded = true;
+  halted = false;
+}
+
+void ServoMotion::setTarget(uint8_t dof, float angle) {
+  if (dof >= SERVO_DOF) return;
+  tgt[dof] = angle;
+  commanded = true;
+  halted = false;
+}
+
+void ServoMotion::halt() {
+  for (uint8_t i = 0; i < SERVO_DOF; i++) tgt[i] = pos[i];
+  halted = true;
+}
+
+bool ServoMotion::update(uint32_t nowMs) {
+  uint32_t elapsed = nowMs - lastMs; // wraps correctly after ~49 days
+  lastMs = nowMs;
+  if (elapsed == 0) return false;
+
+  float maxStep = slew * (float)elapsed * 0.001f;
+  bool changed = false;
+  for (uint8_t i = 0; i < SERVO_DOF; i++) {
+    float err = tgt[i] - pos[i];
+    if (err == 0.0f) continue;
+    if (err > maxStep) pos[i] += maxStep;
+    else if (err < -maxStep) pos[i] -= maxStep;
+    else pos[i] = tgt[i];
+    changed = true;
+  }
+  return changed;
+}
+
+bool ServoMotion::isMoving() const {
+  for (uint8_t i = 0; i < SERVO_DOF; i++) {
+    if (pos[i] != tgt[i]) return true;
+  }
+  return false;
+}
+
+uint8_t ServoMotion::status() const {
+  if (halted) return SERVO_STATUS_HALT;
+  if (!commanded) return SERVO_STATUS_IDLE;
+  return isMoving() ? SERVO_STATUS_MOVING : SERVO_STATUS_DONE;
+}
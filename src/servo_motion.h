@@ -0,0 +1,54 @@
+#ifndef SERVO_MOTION_H
+#define SERVO_MOTION_H
+
+#include <stdint.h>
+
+// Hardware-independent servo motion engine for the hand board.
+// No Arduino headers: the sketch feeds it millis() and writes the PWM outputs,
+// so the same code builds on Linux (motor_test/CMakeLists.txt).
+
+#define SERVO_DOF 6
+
+// ---- Status codes (same as the SPI status byte) ----
+#define SERVO_STATUS_IDLE   0x00
+#define SERVO_STATUS_MOVING 0x01
+#define SERVO_STATUS_DONE   0x02
+#define SERVO_STATUS_HALT   0x12
+
+class ServoMotion {
+public:
+  // slewDegPerSec: maximum speed of every servo toward its target
+  ServoMotion(float slewDegPerSec = 180.0f);
+
+  // Sets the starting positions (e.g. the angles written at power-up)
+  void begin(uint32_t nowMs, const float *angles);
+
+  void setSlewRate(float degPerSec);
+
+  // New targets may arrive at any time, also while moving
+  void setTarget(const float *angles);
+  void setTarget(uint8_t dof, float angle);
+
+  // Stops every servo where it is until the next target
+  void halt();
+
+  // Advances positions to nowMs; returns true if any position changed
+  bool update(uint32_t nowMs);
+
+  float position(uint8_t dof) const { return pos[dof]; }
+  float target(uint8_t dof) const { return tgt[dof]; }
+  bool isMoving() const;
+
+  // 0x00 idle (no command yet), 0x01 moving, 0x02 done, 0x12 halt
+  uint8_t status() const;
+
+private:
+  float pos[SERVO_DOF];
+  float tgt[SERVO_DOF];
+  float slew;
+  uint32_t lastMs;
+  bool commanded;
+  bool halted;
+};
+
+#endif // SERVO_MOTION_H
@@ -0,0 +1,37 @@
+#include "servo_pwm.h"
+
+ServoPwm::ServoPwm(uint16_t minTick, uint16_t maxTick) {
+  calibrate(minTick, maxTick);
+}
+
+void ServoPwm::calibrate(uint16_t minTick, uint16_t maxTick) {
+  int32_t span = (int32_t)maxTick - (int32_t)minTick;
+  for (uint16_t d = 0; d < SERVO_PWM_LUT_SIZE; d++) {
+    // Rounded, unlike map() which truncates
+    lut[d] = (uint16_t)(minTick + (span * (int32_t)d + (span >= 0 ? 90 : -90)) / 180);
+  }
+}
+
+uint16_t ServoPwm::ticks(float angle) const {
+  if (!(angle > 0.0f)) return lut[0];   // also catches NaN
+  if (angle >= SERVO_PWM_LUT_SIZE - 1) return lut[SERVO_PWM_LUT_SIZE - 1];
+
+  uint8_t d = (uint8_t)angle;
+  // Fraction of a degree in 1/256 steps
+  int32_t frac = (int32_t)((angle - d) * 256.0f);
+  int32_t step = (int32_t)lut[d + 1] - (int32_t)lut[d];
+  return (uint16_t)(lut[d] + (step * frac + 128) / 256);
+}
+
+uint8_t servoPwmPack(uint8_t firstChannel, const uint16_t *ticks, uint8_t count, uint8_t *out) {
+  uint8_t n = 0;
+  out[n++] = PCA9685_LED0_ON_L + 4 * firstChannel;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t off = ticks[i] & 0x0FFF;
+    out[n++] = 0x00;                 // ON_L
+    out[n++] = 0x00;                 // ON_H
+    out[n++] = (uint8_t)(off & 0xFF);
+    out[n++] = (uint8_t)(off >> 8);
+  }
+  return n;
+}
@@ -0,0 +1,38 @@
+#ifndef SERVO_PWM_H
+#define SERVO_PWM_H
+
+#include <stdint.h>
+
+// Angle -> PCA9685 tick conversion and burst register packing for the hand board.
+// No Arduino headers: the sketch sends the packed bytes with Wire, so the same
+// code builds on Linux (motor_test/CMakeLists.txt).
+
+#define SERVO_PWM_LUT_SIZE   181    // one entry per degree, 0..180
+#define PCA9685_MODE1        0x00
+#define PCA9685_MODE1_AI     0x20   // register auto-increment
+#define PCA9685_LED0_ON_L    0x06   // 4 registers per channel: ON_L, ON_H, OFF_L, OFF_H
+
+// Largest burst: register address + 4 bytes for every channel written
+#define SERVO_PWM_BURST_SIZE(channels) (1 + 4 * (channels))
+
+class ServoPwm {
+public:
+  // minTick/maxTick: pulse (in 1/4096 of the period) at 0 and 180 deg
+  ServoPwm(uint16_t minTick = 150, uint16_t maxTick = 600);
+
+  // Rebuilds the table for a new calibration
+  void calibrate(uint16_t minTick, uint16_t maxTick);
+
+  // Table lookup with linear interpolation between whole degrees, clamped to 0..180
+  uint16_t ticks(float angle) const;
+
+private:
+  uint16_t lut[SERVO_PWM_LUT_SIZE];
+};
+
+// Packs one auto-increment write starting at firstChannel: the register address,
+// then ON = 0 / OFF = ticks[i] for channels firstChannel .. firstChannel + count - 1.
+// Returns the number of bytes in out (SERVO_PWM_BURST_SIZE(count)).
+uint8_t servoPwmPack(uint8_t firstChannel, const uint16_t *ticks, uint8_t count, uint8_t *out);
+
+#endif // SERVO_PWM_H